@@ -14,30 +14,37 @@ mkdir "%COMPILED_DIR%\DXIL" 2>nul
 :: Process .vert.hlsl files
 for %%f in (%SRC_DIR%\*.vert.hlsl) do (
     if exist "%%f" (
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\SPIRV\%%~nf.spv"
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\MSL\%%~nf.msl"
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\DXIL\%%~nf.dxil"
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\SPIRV\%%~nf.spv" || goto :failed
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\MSL\%%~nf.msl" || goto :failed
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\DXIL\%%~nf.dxil" || goto :failed
     )
 )
 
 :: Process .frag.hlsl files
 for %%f in (%SRC_DIR%\*.frag.hlsl) do (
     if exist "%%f" (
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\SPIRV\%%~nf.spv"
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\MSL\%%~nf.msl"
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\DXIL\%%~nf.dxil"
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\SPIRV\%%~nf.spv" || goto :failed
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\MSL\%%~nf.msl" || goto :failed
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\DXIL\%%~nf.dxil" || goto :failed
     )
 )
 
 :: Process .comp.hlsl files
 for %%f in (%SRC_DIR%\*.comp.hlsl) do (
     if exist "%%f" (
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\SPIRV\%%~nf.spv"
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\MSL\%%~nf.msl"
-        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\DXIL\%%~nf.dxil"
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\SPIRV\%%~nf.spv" || goto :failed
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\MSL\%%~nf.msl" || goto :failed
+        %SHADERCROSS_DIR%shadercross.exe "%%f" -o "%COMPILED_DIR%\DXIL\%%~nf.dxil" || goto :failed
     )
 )
 
 echo Done compiling shaders
 
 endlocal
+exit /b 0
+
+:: Stop the build, rather than leave the renderer loading stale or missing shaders
+:failed
+echo Failed compiling shaders
+endlocal
+exit /b 1
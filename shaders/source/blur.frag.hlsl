@@ -0,0 +1,27 @@
+#define SPREAD 0.7 // Scales the distance between taps, tuning the width of the Gaussian
+
+cbuffer UniformBlock : register(b0, space3)
+{
+	float2 direction; // A single texel along the axis being blurred, in UVs
+};
+
+Texture2D SourceTexture : register(t0, space2);
+SamplerState SourceSampler : register(s0, space2);
+
+// A 9 tap Gaussian in 5 fetches, each fetch off the center weighing 2 neighbouring texels through bilinear filtering
+static const float OFFSETS[3] = { 0.0, 1.3846153846, 3.2307692308 };
+static const float WEIGHTS[3] = { 0.2270270270, 0.3162162162, 0.0702702703 };
+
+float4 main(float2 uv : TEXCOORD0) : SV_Target0
+{
+	float4 color = SourceTexture.Sample(SourceSampler, uv) * WEIGHTS[0];
+
+	for (int i = 1; i < 3; i++)
+	{
+		const float2 offset = direction * OFFSETS[i] * SPREAD;
+		color += SourceTexture.Sample(SourceSampler, uv + offset) * WEIGHTS[i];
+		color += SourceTexture.Sample(SourceSampler, uv - offset) * WEIGHTS[i];
+	}
+
+	return color;
+}
@@ -0,0 +1,16 @@
+#define CANVAS_SIZE uint2(64, 32)
+
+// Every row of the Framebuffer as uploaded, a 64 bit word split into its lower (x) and upper (y) half
+StructuredBuffer<uint2> Rows : register(t0, space2);
+
+float4 main(float2 uv : TEXCOORD0) : SV_Target0
+{
+	const uint2 pixel = min(uint2(uv * CANVAS_SIZE), CANVAS_SIZE - 1);
+	const uint2 row = Rows[pixel.y];
+
+	// The leftmost pixel is the most significant bit
+	const uint bits = pixel.x < 32 ? row.y >> (31 - pixel.x) : row.x >> (63 - pixel.x);
+	const float value = bits & 1;
+
+	return float4(value, value, value, 1.0);
+}
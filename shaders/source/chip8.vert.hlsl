@@ -0,0 +1,14 @@
+struct Output
+{
+	float2 TexCoord : TEXCOORD0;
+	float4 Position : SV_Position;
+};
+
+Output main(uint vertexID : SV_VertexID)
+{
+	// A single triangle covering the whole target, without any vertex buffer, (0, 0) being its upper left
+	Output output;
+	output.TexCoord = float2((vertexID << 1) & 2, vertexID & 2);
+	output.Position = float4(output.TexCoord * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+	return output;
+}
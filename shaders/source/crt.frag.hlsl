@@ -0,0 +1,86 @@
+#define PI 3.14159265359
+#define MARGIN float2(0.05, 0.05)
+#define DISPLAY_CURVATURE 5.0
+#define SCANLINE_FREQUENCY 0.18
+#define SUB_PIXEL_STRENGTH 0.65
+#define VIGNETTE_MAG 0.4 
+#define VIGNETTE_MULTIPLIER 1.5
+#define OUTSIDE float2(-1.0, -1.0)
+#define IN_MARGIN float2(2.0, 2.0)
+
+// Bakes everything of the CRT look which only depends on the window size, once per resize, for post.frag to look up
+
+cbuffer UniformBlock : register(b0, space3)
+{
+	int2 windowSize;
+};
+
+struct Output
+{
+	float4 Screen : SV_Target0;	// Where on the scene texture this pixel lands in xy, OUTSIDE or IN_MARGIN if it doesn't
+	float4 Mask : SV_Target1;	// Scanlines and sub pixels in rgb, applied before the levels curve, vignette in a, after
+};
+
+Output main(float2 uv : TEXCOORD0)
+{
+	Output output;
+	const float2 ORIGINAL_UV = uv;
+	const int2 PX_POS = uv * windowSize;
+
+	// Curvature
+	uv = uv * 2.0 - 1.0;
+	float2 offset = uv.yx / DISPLAY_CURVATURE;
+	uv = uv + uv * offset * offset;
+	uv = uv * 0.5 + 0.5;
+
+	if (uv.x < 0.0 || uv.x >= 1.0 || uv.y < 0.0 || uv.y >= 1.0)
+	{
+		output.Screen = float4(OUTSIDE, 0.0, 0.0);
+	}
+	else if (uv.x < MARGIN.x || uv.x > 1.0 - MARGIN.x || uv.y < MARGIN.y || uv.y > 1 - MARGIN.y)
+	{
+		output.Screen = float4(IN_MARGIN, 0.0, 0.0);
+	}
+	else
+	{
+		uv.x = (uv.x - MARGIN.x) / (1.0 - MARGIN.x * 2.0);
+		uv.y = (uv.y - MARGIN.y) / (1.0 - MARGIN.y * 2.0);
+		output.Screen = float4(uv, 0.0, 0.0);
+	}
+
+	// Scanlines
+	float scanline = cos(PX_POS.y * PI * 2.0 * SCANLINE_FREQUENCY);
+	scanline = (scanline + 1.0) / 2.0; // move from [-1..1] to [0..1]
+	scanline *= 2.0; // Oversaturate so we get more whites in the scan lines
+	scanline = saturate(scanline); // clamp
+	scanline = (scanline / 4) + 0.75; // move to [0.75..1.0]
+	float3 mask = float3(scanline, scanline, scanline);
+
+	// Sub pixels
+	float xMod = PX_POS.x % 3;
+	const float RGB_FACTOR = 1.0 - SUB_PIXEL_STRENGTH;
+	if (xMod == 0)
+	{
+		mask.g *= RGB_FACTOR;
+		mask.b *= RGB_FACTOR;
+	}
+	else if (xMod == 1)
+	{
+		mask.r *= RGB_FACTOR;
+		mask.b *= RGB_FACTOR;
+	}
+	else if (xMod == 2)
+	{
+		mask.r *= RGB_FACTOR;
+		mask.g *= RGB_FACTOR;
+	}
+
+	// Vignette
+	float2 vignetteUV = ORIGINAL_UV;
+	vignetteUV *= 1.0 - vignetteUV.yx;
+	float vignette = vignetteUV.x * vignetteUV.y * 15.0;
+	vignette = pow(vignette, VIGNETTE_MAG) * VIGNETTE_MULTIPLIER;
+
+	output.Mask = float4(mask, vignette);
+	return output;
+}
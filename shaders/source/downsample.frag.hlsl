@@ -0,0 +1,20 @@
+cbuffer UniformBlock : register(b0, space3)
+{
+	float2 texelSize; // Size of a texel of the source texture, in UVs
+};
+
+Texture2D SourceTexture : register(t0, space2);
+SamplerState SourceSampler : register(s0, space2);
+
+float4 main(float2 uv : TEXCOORD0) : SV_Target0
+{
+	// Four bilinear fetches between 2x2 texels each, together averaging the 4x4 source texels around this texel
+	const float4 OFFSETS = float4(-1.0, -1.0, 1.0, 1.0) * texelSize.xyxy;
+
+	float4 color = SourceTexture.Sample(SourceSampler, uv + OFFSETS.xy);
+	color += SourceTexture.Sample(SourceSampler, uv + OFFSETS.zy);
+	color += SourceTexture.Sample(SourceSampler, uv + OFFSETS.xw);
+	color += SourceTexture.Sample(SourceSampler, uv + OFFSETS.zw);
+
+	return color * 0.25;
+}
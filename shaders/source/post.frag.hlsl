@@ -1,16 +1,8 @@
-#define PI 3.14159265359
 #define FG_COLOR float4(0.196, 1.0, 0.4, 1.0)
 #define BG_COLOR float4(0.2, 0.2, 0.2, 1.0)
-#define MARGIN float2(0.05, 0.05)
-#define DISPLAY_CURVATURE 5.0
-#define BLUR_SIZE float2(2.0, 2.0)
+#define BLUR_OFFSETS float2(-1.5, 0.5) // A 4x4 texel box blur, as bilinear fetches between 2x2 texels each
 #define BLOOM_WEIGHT 0.75
-#define BLOOM_SIZE float2(10.0, 10.0)
-#define SCANLINE_FREQUENCY 0.18
-#define SUB_PIXEL_STRENGTH 0.65
-#define LEVELS_CURVE_STRENGTH 1.7
-#define VIGNETTE_MAG 0.4 
-#define VIGNETTE_MULTIPLIER 1.5
+#define LEVELS_UV float2(255.0 / 256.0, 0.5 / 256.0) // Scale and bias from a value to the center of its LevelsTexture texel
 
 cbuffer UniformBlock : register(b0, space3)
 {
@@ -19,112 +11,62 @@ cbuffer UniformBlock : register(b0, space3)
 
 Texture2D ColorTexture : register(t0, space2);
 SamplerState ColorSampler : register(s0, space2);
-
-float3 sampleTexture(float2 uv, Texture2D ColorTexture, SamplerState ColorSampler)
+Texture2D BloomTexture : register(t1, space2);		// The scene downsampled and blurred by the bloom passes
+SamplerState BloomSampler : register(s1, space2);
+Texture2D ScreenTexture : register(t2, space2);		// Baked by crt.frag, where every pixel lands on the scene
+SamplerState ScreenSampler : register(s2, space2);
+Texture2D MaskTexture : register(t3, space2);		// Baked by crt.frag, scanlines and sub pixels in rgb, vignette in a
+SamplerState MaskSampler : register(s3, space2);
+Texture2D LevelsTexture : register(t4, space2);		// The curve applied to the levels, indexed by value
+SamplerState LevelsSampler : register(s4, space2);
+
+float3 toColor(float value)
 {
-	return lerp(BG_COLOR, FG_COLOR, ColorTexture.Sample(ColorSampler, uv).r).rgb;
+	return lerp(BG_COLOR, FG_COLOR, value).rgb;
 }
 
-float3 boxBlur(float2 uv, float2 texelSize, float2 blurSize, Texture2D ColorTexture, SamplerState ColorSampler)
+float blur(float2 uv, float2 texelSize)
 {
-	const float2 TEXEL_BLUR_SIZE = blurSize * texelSize;
-	const float2 ORIGINAL_UV = uv - TEXEL_BLUR_SIZE;
-	float numSamples = 0.0;
-	float3 returnColor = float3(0.0, 0.0, 0.0);
-
-	for (uv.y = ORIGINAL_UV.y; uv.y < ORIGINAL_UV.y + TEXEL_BLUR_SIZE.y * 2.0; uv.y += texelSize.y)
-	{
-		if (uv.y < 0.0)
-			continue;
-
-		if (uv.y >= 1.0)
-			break;
-
-		for (uv.x = ORIGINAL_UV.x; uv.x < ORIGINAL_UV.x + TEXEL_BLUR_SIZE.x * 2.0; uv.x += texelSize.x)
-		{
-			if (uv.x < 0.0)
-				continue;
+	float value = ColorTexture.Sample(ColorSampler, uv + BLUR_OFFSETS.xx * texelSize).r;
+	value += ColorTexture.Sample(ColorSampler, uv + BLUR_OFFSETS.yx * texelSize).r;
+	value += ColorTexture.Sample(ColorSampler, uv + BLUR_OFFSETS.xy * texelSize).r;
+	value += ColorTexture.Sample(ColorSampler, uv + BLUR_OFFSETS.yy * texelSize).r;
 
-			if (uv.x >= 1.0)
-				break;
-
-			returnColor += sampleTexture(uv, ColorTexture, ColorSampler);
-			numSamples++;
-		}
-	}
+	return value * 0.25;
+}
 
-	return returnColor / numSamples;
+float levels(float value)
+{
+	return LevelsTexture.Sample(LevelsSampler, float2(value * LEVELS_UV.x + LEVELS_UV.y, 0.5)).r;
 }
 
 float4 main(float2 uv : TEXCOORD0) : SV_Target0
 {
-	const float2 ORIGINAL_UV = uv;
 	const float2 TEXEL_SIZE = 1.0 / windowSize;
-	const int2 PX_POS = uv * windowSize;
-
-	// Curvature
-	uv = uv * 2.0 - 1.0;
-	float2 offset = uv.yx / DISPLAY_CURVATURE;
-	uv = uv + uv * offset * offset;
-	uv = uv * 0.5 + 0.5;
 
-	if (uv.x < 0.0 || uv.x >= 1.0 || uv.y < 0.0 || uv.y >= 1.0)
+	// Curvature, negative outside of the display and beyond 1 in its margin
+	const float2 screenUV = ScreenTexture.Sample(ScreenSampler, uv).xy;
+	if (screenUV.x < 0.0)
 		return float4(0.0, 0.0, 0.0, 1.0);
 
 	// Sample CHIP8
-	float4 color;
-	if (uv.x < MARGIN.x || uv.x > 1.0 - MARGIN.x || uv.y < MARGIN.y || uv.y > 1 - MARGIN.y)
+	float3 color;
+	if (screenUV.x > 1.0)
 	{
-		color = BG_COLOR;
+		color = BG_COLOR.rgb;
 	}
 	else
 	{
-		uv.x = (uv.x - MARGIN.x) / (1.0 - MARGIN.x * 2.0);
-		uv.y = (uv.y - MARGIN.y) / (1.0 - MARGIN.y * 2.0);
-				
-		float3 originalValue = boxBlur(uv, TEXEL_SIZE, BLUR_SIZE, ColorTexture, ColorSampler);
-		float3 bloomValue = boxBlur(uv, TEXEL_SIZE, BLOOM_SIZE, ColorTexture, ColorSampler) * BLOOM_WEIGHT;
-		float3 mix = max(originalValue, bloomValue);
-
-		color = float4(mix.r, mix.g, mix.b, 1.0);
-	}
-
-	// Scanlines
-	float scanline = cos(PX_POS.y * PI * 2.0 * SCANLINE_FREQUENCY);
-	scanline = (scanline + 1.0) / 2.0; // move from [-1..1] to [0..1]
-	scanline *= 2.0; // Oversaturate so we get more whites in the scan lines
-	scanline = saturate(scanline); // clamp
-	scanline = (scanline / 4) + 0.75; // move to [0.75..1.0]
-	color *= scanline;
-
-	// Sub pixels
-	float xMod = PX_POS.x % 3;
-	const float RGB_FACTOR = 1.0 - SUB_PIXEL_STRENGTH;
-	if (xMod == 0)
-	{
-		color.g *= RGB_FACTOR;
-		color.b *= RGB_FACTOR;
+		float3 originalValue = toColor(blur(screenUV, TEXEL_SIZE));
+		float3 bloomValue = toColor(BloomTexture.Sample(BloomSampler, screenUV).r) * BLOOM_WEIGHT;
+		color = max(originalValue, bloomValue);
 	}
-	else if (xMod == 1)
-	{
-		color.r *= RGB_FACTOR;
-		color.b *= RGB_FACTOR;
-	}
-	else if (xMod == 2)
-	{
-		color.r *= RGB_FACTOR;
-		color.g *= RGB_FACTOR;
-	}
-
-	// Apply curve to levels
-	color = 1.0 - pow(abs(color - 1.0), LEVELS_CURVE_STRENGTH);
 
-	// Vignette
-	float2 vignetteUV = ORIGINAL_UV;
-	vignetteUV *= 1.0 - vignetteUV.yx;
-	float vignette = vignetteUV.x * vignetteUV.y * 15.0;
-	vignette = pow(vignette, VIGNETTE_MAG) * VIGNETTE_MULTIPLIER;
-	color *= vignette;
+	// Scanlines and sub pixels, the curve to the levels, then the vignette
+	const float4 mask = MaskTexture.Sample(MaskSampler, uv);
+	color *= mask.rgb;
+	color = float3(levels(color.r), levels(color.g), levels(color.b));
+	color *= mask.a;
 
-	return color;
+	return float4(color, 1.0);
 }
@@ -0,0 +1,23 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+/**
+ * @brief Plays the Emulator's sound, such as Sound playing it on an audio device.
+ */
+class AudioSink
+{
+public:
+	/**
+	 * @brief Destructor
+	 */
+	virtual ~AudioSink() = default;
+
+	/**
+	 * @brief Starts a beep for a specified duration in milliseconds. Intended for CHIP-8's FX18 instruction.
+	 * @param ms The amount of milliseconds the beep should be playing.
+	 */
+	virtual void StartBeep(uint16_t ms) = 0;
+};
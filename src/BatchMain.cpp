@@ -0,0 +1,391 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <algorithm>
+#include "Emulator.h"
+#include "Framebuffer.h"
+#include "SteadyClock.h"
+#include "Movie.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief A single headless run of a ROM.
+ */
+struct BatchJob
+{
+	std::string romPath;							///< Path to the ROM to run.
+	uint32_t seed = 1;								///< State of the random number generator at boot.
+	uint64_t numCycles = 0;							///< Number of opcodes to execute.
+	std::string scriptPath;							///< Path to the input script, or empty if no keys are pressed.
+	const std::vector<MovieEvent>* script = nullptr;	///< The loaded input script, or nullptr.
+};
+
+/**
+ * @brief The outcome of a BatchJob.
+ */
+struct BatchResult
+{
+	bool succeeded = false;							///< Whether the ROM could be loaded and run.
+	uint64_t hash = 0;								///< Framebuffer::GetHash() after the last opcode.
+	uint64_t numExecuted = 0;						///< Number of opcodes executed.
+	uint64_t wallTime = 0;							///< Host time the run took, in nanoseconds.
+};
+
+/**
+ * @brief Prints how the application should be started.
+ * @param executable Path of the executable, as found in argv[0].
+ */
+static void PrintUsage(const char* executable)
+{
+	std::cout << "Usage: " << std::filesystem::path(executable).filename().string() << " [--threads=<count>] [--no-pin] [--mode=interpreter|cached|threaded|jit|compiled] [--ips=<opcodes per second>] [--cycles=<count>] [--seed=<first seed>] [--seeds=<count>] [--script=<input script path>] [--list=<ROM list path>] [--jobs=<job list path>] [--output=<CSV path>] [<ROM path or directory>...]" << std::endl;
+	std::cout << "Runs many ROM instances headless on a thread pool, one worker pinned to every core, and writes the outcome of every run as CSV." << std::endl;
+	std::cout << "Every ROM given, found in a directory or listed one per line in a ROM list is run once for each of --seeds seeds, counting up from --seed." << std::endl;
+	std::cout << "A job list has one run per line instead: <seed> <cycles> <input script path, or - for none> <ROM path>." << std::endl;
+	std::cout << "An input script has one line per change of the keys: <opcodes executed since boot> <bitset of keys, in hex>." << std::endl;
+}
+
+/**
+ * @brief Reads the lines of a text file, leaving out empty lines and comments starting with '#'.
+ * @param path Path to the file.
+ * @param lines Set to the lines read.
+ * @return Returns false if the file couldn't be opened.
+ */
+static bool ReadLines(const std::string& path, std::vector<std::string>& lines)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cerr << "Could not open '" << path << "'" << std::endl;
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		if (!line.empty() && line[0] != '#')
+			lines.push_back(line);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Loads an input script, which lists when the keys change as opcodes executed since boot.
+ * @param path Path to the input script.
+ * @param script Set to the changes of the keys, in order.
+ * @return Returns false if the file couldn't be opened or is invalid.
+ */
+static bool LoadScript(const std::string& path, std::vector<MovieEvent>& script)
+{
+	std::vector<std::string> lines;
+	if (!ReadLines(path, lines))
+		return false;
+
+	for (const std::string& line : lines)
+	{
+		std::istringstream fields(line);
+		MovieEvent event;
+		if (!(fields >> event.cycle >> std::hex >> event.keys) || (!script.empty() && event.cycle < script.back().cycle))
+		{
+			std::cerr << "Invalid line '" << line << "' in input script '" << path << "'" << std::endl;
+			return false;
+		}
+
+		script.push_back(event);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Adds the ROMs at a path, either a single ROM or all files in a directory in alphabetical order.
+ * @param path Path to the ROM or directory.
+ * @param romPaths The ROM paths to add to.
+ * @return Returns false if the path doesn't exist.
+ */
+static bool AddRoms(const std::string& path, std::vector<std::string>& romPaths)
+{
+	std::error_code error;
+	if (std::filesystem::is_directory(path, error))
+	{
+		std::vector<std::string> found;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path, error))
+		{
+			if (entry.is_regular_file(error))
+				found.push_back(entry.path().string());
+		}
+
+		std::sort(found.begin(), found.end());
+		romPaths.insert(romPaths.end(), found.begin(), found.end());
+		return true;
+	}
+
+	if (!std::filesystem::exists(path, error))
+	{
+		std::cerr << "Could not find '" << path << "'" << std::endl;
+		return false;
+	}
+
+	romPaths.push_back(path);
+	return true;
+}
+
+/**
+ * @brief Runs a single BatchJob on an Emulator of its own, so runs share nothing but the read-only input scripts.
+ * @param job The BatchJob to run.
+ * @param executionMode How the Emulator executes opcodes.
+ * @param instructionsPerSecond Rate of the emulated clock the timers are derived from.
+ * @return Returns the outcome of the run.
+ */
+static BatchResult RunJob(const BatchJob& job, ExecutionMode executionMode, uint32_t instructionsPerSecond)
+{
+	static const uint64_t MAX_RUN_CYCLES = 1 << 20;
+
+	SteadyClock clock;
+	const uint64_t startTime = clock.GetTicksNS();
+
+	BatchResult result;
+	Emulator emulator(job.romPath, nullptr, nullptr, nullptr, nullptr);
+	emulator.SetVerbose(false);
+	if (!emulator.Init() || !emulator.SetExecutionMode(executionMode))
+		return result;
+
+	emulator.SetInstructionsPerSecond(instructionsPerSecond);
+	emulator.SetSeed(job.seed);
+
+	// Input only changes in between opcodes, which RunCycles() stops at exactly
+	size_t nextEvent = 0;
+	while (emulator.GetState().cycles < job.numCycles)
+	{
+		if (job.script != nullptr && nextEvent < job.script->size() && (*job.script)[nextEvent].cycle <= emulator.GetState().cycles)
+		{
+			emulator.SetKeys((*job.script)[nextEvent++].keys);
+			continue;
+		}
+
+		uint64_t until = job.numCycles;
+		if (job.script != nullptr && nextEvent < job.script->size())
+			until = std::min(until, (*job.script)[nextEvent].cycle);
+
+		emulator.RunCycles((uint32_t)std::min(until - emulator.GetState().cycles, MAX_RUN_CYCLES));
+	}
+
+	result.succeeded = true;
+	result.hash = emulator.GetFramebuffer().GetHash();
+	result.numExecuted = emulator.GetState().cycles;
+	result.wallTime = clock.GetTicksNS() - startTime;
+
+	return result;
+}
+
+/**
+ * @brief Quotes a CSV field, so paths containing commas or quotes stay a single field.
+ * @param field The field to quote.
+ * @return Returns the quoted field.
+ */
+static std::string QuoteField(const std::string& field)
+{
+	std::string quoted = "\"";
+	for (char character : field)
+	{
+		if (character == '"')
+			quoted += '"';
+
+		quoted += character;
+	}
+
+	return quoted + "\"";
+}
+
+int main(int argc, const char* argv[])
+{
+	uint32_t numThreads = 0;
+	bool pinToCores = true;
+	ExecutionMode executionMode = ExecutionMode::CachedInterpreter;
+	uint32_t instructionsPerSecond = Emulator::OPCODES_FREQUENCY;
+	uint64_t numCycles = 1000000;
+	uint32_t firstSeed = 1;
+	uint32_t numSeeds = 1;
+	std::string scriptPath;
+	std::string jobsPath;
+	std::string outputPath;
+	std::vector<std::string> romPaths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+
+		if (argument.rfind("--threads=", 0) == 0 && std::atoi(argument.c_str() + 10) > 0)
+			numThreads = std::atoi(argument.c_str() + 10);
+		else if (argument == "--no-pin")
+			pinToCores = false;
+		else if (argument == "--mode=interpreter")
+			executionMode = ExecutionMode::Interpreter;
+		else if (argument == "--mode=cached")
+			executionMode = ExecutionMode::CachedInterpreter;
+		else if (argument == "--mode=threaded")
+			executionMode = ExecutionMode::Threaded;
+		else if (argument == "--mode=jit")
+			executionMode = ExecutionMode::Jit;
+		else if (argument == "--mode=compiled")
+			executionMode = ExecutionMode::Compiled;
+		else if (argument.rfind("--ips=", 0) == 0 && std::atoi(argument.c_str() + 6) > 0)
+			instructionsPerSecond = std::atoi(argument.c_str() + 6);
+		else if (argument.rfind("--cycles=", 0) == 0 && std::atoll(argument.c_str() + 9) > 0)
+			numCycles = std::atoll(argument.c_str() + 9);
+		else if (argument.rfind("--seed=", 0) == 0 && argument.size() > 7)
+			firstSeed = (uint32_t)std::strtoul(argument.c_str() + 7, nullptr, 0);
+		else if (argument.rfind("--seeds=", 0) == 0 && std::atoi(argument.c_str() + 8) > 0)
+			numSeeds = std::atoi(argument.c_str() + 8);
+		else if (argument.rfind("--script=", 0) == 0 && argument.size() > 9)
+			scriptPath = argument.substr(9);
+		else if (argument.rfind("--list=", 0) == 0 && argument.size() > 7)
+		{
+			std::vector<std::string> lines;
+			if (!ReadLines(argument.substr(7), lines))
+				return -1;
+
+			for (const std::string& line : lines)
+			{
+				if (!AddRoms(line, romPaths))
+					return -1;
+			}
+		}
+		else if (argument.rfind("--jobs=", 0) == 0 && argument.size() > 7)
+			jobsPath = argument.substr(7);
+		else if (argument.rfind("--output=", 0) == 0 && argument.size() > 9)
+			outputPath = argument.substr(9);
+		else if (argument.rfind("--", 0) != 0)
+		{
+			if (!AddRoms(argument, romPaths))
+				return -1;
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	std::vector<BatchJob> jobs;
+	for (const std::string& romPath : romPaths)
+	{
+		for (uint32_t i = 0; i < numSeeds; i++)
+			jobs.push_back(BatchJob{ romPath, firstSeed + i, numCycles, scriptPath });
+	}
+
+	if (!jobsPath.empty())
+	{
+		std::vector<std::string> lines;
+		if (!ReadLines(jobsPath, lines))
+			return -1;
+
+		// The ROM path comes last, taking the rest of the line, as ROM names often contain spaces
+		for (const std::string& line : lines)
+		{
+			std::istringstream fields(line);
+			BatchJob job;
+			if (!(fields >> job.seed >> job.numCycles >> job.scriptPath) || !std::getline(fields >> std::ws, job.romPath) || job.romPath.empty())
+			{
+				std::cerr << "Invalid line '" << line << "' in job list '" << jobsPath << "'" << std::endl;
+				return -1;
+			}
+
+			if (job.scriptPath == "-")
+				job.scriptPath.clear();
+
+			jobs.push_back(job);
+		}
+	}
+
+	if (jobs.empty())
+	{
+		PrintUsage(argv[0]);
+		return -1;
+	}
+
+	// Every input script is loaded once up front, the runs only reading them
+	std::map<std::string, std::vector<MovieEvent>> scripts;
+	for (BatchJob& job : jobs)
+	{
+		if (job.scriptPath.empty())
+			continue;
+
+		auto it = scripts.find(job.scriptPath);
+		if (it == scripts.end())
+		{
+			it = scripts.emplace(job.scriptPath, std::vector<MovieEvent>()).first;
+			if (!LoadScript(job.scriptPath, it->second))
+				return -1;
+		}
+
+		job.script = &it->second;
+	}
+
+	ThreadPool pool(numThreads, pinToCores);
+
+	// Every run writes nothing but its own result, so runs never wait on each other
+	std::vector<BatchResult> results(jobs.size());
+	SteadyClock clock;
+	const uint64_t startTime = clock.GetTicksNS();
+
+	pool.Run(jobs.size(), [&](size_t task, uint32_t)
+	{
+		results[task] = RunJob(jobs[task], executionMode, instructionsPerSecond);
+	});
+
+	const uint64_t elapsed = clock.GetTicksNS() - startTime;
+
+	std::ofstream outputFile;
+	if (!outputPath.empty())
+	{
+		outputFile.open(outputPath);
+		if (!outputFile)
+		{
+			std::cerr << "Could not open '" << outputPath << "'" << std::endl;
+			return -1;
+		}
+	}
+
+	std::ostream& output = outputPath.empty() ? std::cout : outputFile;
+	output << "rom,seed,script,cycles,framebuffer_hash,wall_ns" << std::endl;
+
+	uint64_t numExecuted = 0;
+	uint64_t runTime = 0;
+	size_t numFailed = 0;
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		const BatchJob& job = jobs[i];
+		const BatchResult& result = results[i];
+		output << QuoteField(job.romPath) << ',' << job.seed << ',' << QuoteField(job.scriptPath) << ',' << result.numExecuted << ',';
+		if (result.succeeded)
+			output << std::hex << result.hash << std::dec;
+		else
+			output << "error";
+
+		output << ',' << result.wallTime << '\n';
+
+		numExecuted += result.numExecuted;
+		runTime += result.wallTime;
+		numFailed += result.succeeded ? 0 : 1;
+	}
+
+	output.flush();
+
+	// Kept out of the CSV, which may be written to the console
+	std::cerr << "Ran " << jobs.size() << " instances (" << numFailed << " failed) on " << pool.GetNumThreads() << " threads in " << elapsed / 1e6 << " ms, "
+		<< numExecuted * 1e3 / elapsed << " million opcodes per second" << std::endl;
+	std::cerr << "Workers were busy " << runTime * 100.0 / ((double)elapsed * pool.GetNumThreads()) << "% of the time, stealing " << pool.GetNumSteals() << " times" << std::endl;
+
+	return numFailed == 0 ? 0 : -1;
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "BroadcastBenchmark.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "Emulator.h"
+#include "SteadyClock.h"
+#include "BroadcastServer.h"
+#include "BroadcastClient.h"
+#include "AudioSink.h"
+
+/**
+ * @brief AudioSink which only remembers whether a spectator was told to beep, to compare against the Emulator.
+ */
+class BeepTracker : public AudioSink
+{
+public:
+	void StartBeep(uint16_t ms) override { beeping = ms > 0; }
+
+	bool beeping = false;				///< Whether the most recent AudioGate started the beep.
+};
+
+int RunBroadcastBenchmark(Emulator& emulator, uint32_t numFrames, const std::string& address, uint32_t numSpectators)
+{
+	BroadcastServer server;
+	if (!server.Open(address))
+		return -1;
+
+	const std::string connectAddress = server.GetPort() != 0 ? "127.0.0.1:" + std::to_string(server.GetPort()) : address;
+	std::vector<BeepTracker> beeps(numSpectators);
+	std::vector<BroadcastClient> spectators;
+	spectators.reserve(numSpectators);
+
+	// Half join at the start, the others later on while a beep plays, which only their keyframe tells them about
+	const uint32_t numLate = numSpectators / 2;
+	const auto connect = [&](uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			spectators.emplace_back(&beeps[spectators.size()]);
+			if (!spectators.back().Connect(connectAddress))
+				return false;
+		}
+
+		return true;
+	};
+
+	if (!connect(numSpectators - numLate))
+		return -1;
+
+	server.Poll(0);
+
+	const uint32_t cyclesPerFrame = emulator.GetClockFrequency() / 60 > 0 ? emulator.GetClockFrequency() / 60 : 1;
+	SteadyClock clock;
+	uint64_t serverTime = 0;
+	bool joinedBeeping = false;
+	uint32_t numHeardBeep = 0;
+
+	// Compares a spectator against the Emulator, counting in whether it's beeping
+	const auto isInSync = [&](size_t i)
+	{
+		return memcmp(&spectators[i].GetFramebuffer(), &emulator.GetFramebuffer(), sizeof(Framebuffer)) == 0 &&
+			beeps[i].beeping == (emulator.GetState().soundTimer > 0);
+	};
+
+	for (uint32_t frame = 0; frame < numFrames; frame++)
+	{
+		emulator.RunCycles(cyclesPerFrame);
+
+		const uint64_t startTime = clock.GetTicksNS();
+		server.Publish(emulator.GetState());
+		server.Poll(0);
+		serverTime += clock.GetTicksNS() - startTime;
+
+		for (BroadcastClient& spectator : spectators)
+			spectator.Poll();
+
+		const bool beeping = emulator.GetState().soundTimer > 0;
+		if (spectators.size() < numSpectators && frame >= numFrames / 2 && (beeping || frame + 1 == numFrames))
+		{
+			if (!connect(numLate))
+				return -1;
+
+			// Let the late spectators receive their keyframe before the Emulator moves on
+			const uint64_t joinStartTime = clock.GetTicksNS();
+			joinedBeeping = beeping;
+			numHeardBeep = 0;
+			while (numHeardBeep < numLate && clock.GetTicksNS() - joinStartTime < 5000000000ull)
+			{
+				server.Poll(1);
+
+				numHeardBeep = 0;
+				for (size_t i = numSpectators - numLate; i < numSpectators; i++)
+				{
+					spectators[i].Poll();
+					numHeardBeep += isInSync(i) ? 1 : 0;
+				}
+			}
+		}
+	}
+
+	// Let everything in flight arrive
+	const uint64_t drainStartTime = clock.GetTicksNS();
+	uint32_t numInSync = 0;
+	while (numInSync < numSpectators && clock.GetTicksNS() - drainStartTime < 5000000000ull)
+	{
+		server.Poll(1);
+
+		numInSync = 0;
+		for (size_t i = 0; i < spectators.size(); i++)
+		{
+			spectators[i].Poll();
+			numInSync += isInSync(i) ? 1 : 0;
+		}
+	}
+
+	std::cout << "Broadcast " << numFrames << " frames to " << server.GetNumSpectators() << " spectators, publishing took " << serverTime / 1e3 / numFrames
+		<< " us per frame (" << serverTime / (double)numFrames / std::max<uint32_t>(numSpectators, 1) << " ns per spectator)" << std::endl;
+	std::cout << "Encoded " << server.GetNumBytesEncoded() / (double)numFrames << " bytes per frame, sent " << server.GetNumBytesSent() / (double)numFrames / std::max<uint32_t>(numSpectators, 1)
+		<< " bytes per frame per spectator, " << server.GetNumResyncs() << " spectators caught up through a keyframe" << std::endl;
+	if (numLate > 0)
+	{
+		std::cout << numHeardBeep << " of " << numLate << " spectators joining " << (joinedBeeping ? "during a beep" : "late, without any beep to join during,")
+			<< " were in sync when joining" << std::endl;
+	}
+
+	std::cout << numInSync << " of " << numSpectators << " spectators are in sync" << std::endl;
+	std::cout << "Framebuffer hash: " << std::hex << emulator.GetFramebuffer().GetHash() << std::dec << std::endl;
+
+	return numInSync == numSpectators && numHeardBeep == numLate ? 0 : -1;
+}
@@ -0,0 +1,21 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+// Forward declarations
+class Emulator;
+
+/**
+ * @brief Broadcasts every frame of a ROM to a swarm of spectators connected over local sockets, measuring how long
+ * publishing takes, then checks whether every spectator ended up with the same Framebuffer and beep. Half of them join
+ * halfway through, while a beep plays if there is one, checking they hear it without waiting for it to start again.
+ * @param emulator The Emulator to run, already initialized.
+ * @param numFrames Number of frames to run.
+ * @param address Address for the BroadcastServer to listen on.
+ * @param numSpectators Number of spectators to connect.
+ * @return Returns 0 if all spectators ended up in sync.
+ */
+int RunBroadcastBenchmark(Emulator& emulator, uint32_t numFrames, const std::string& address, uint32_t numSpectators);
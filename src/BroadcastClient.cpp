@@ -0,0 +1,142 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "BroadcastClient.h"
+#include "BroadcastServer.h"
+#include "AudioSink.h"
+#include <bit>
+#include <iostream>
+
+namespace
+{
+	/**
+	 * @brief Reads a little endian value written by BroadcastServer.
+	 * @param input Where to read the value.
+	 * @param size Number of bytes to read.
+	 * @return Returns the value.
+	 */
+	inline uint64_t ReadBytes(const uint8_t* input, size_t size)
+	{
+		uint64_t value = 0;
+		for (size_t i = 0; i < size; i++)
+			value |= (uint64_t)input[i] << (i * 8);
+
+		return value;
+	}
+}
+
+BroadcastClient::BroadcastClient(AudioSink* audio) : audio(audio)
+{
+}
+
+bool BroadcastClient::Connect(const string address)
+{
+	received.clear();
+	hasKeyframe = false;
+
+	return socket.Connect(address);
+}
+
+bool BroadcastClient::Poll()
+{
+	if (!socket.IsOpen())
+		return false;
+
+	uint8_t data[4096];
+	int size;
+	while ((size = socket.Receive(data, sizeof(data))) > 0)
+	{
+		received.insert(received.end(), data, data + size);
+		numBytesReceived += size;
+	}
+
+	if (size < 0)
+	{
+		cerr << "Lost connection to the broadcast" << endl;
+		socket.Close();
+	}
+
+	bool changed = false;
+	size_t offset = 0;
+	while (offset < received.size())
+	{
+		const int messageSize = HandleMessage(received.data() + offset, received.size() - offset, changed);
+		if (messageSize < 0)
+		{
+			cerr << "Received an invalid broadcast" << endl;
+			socket.Close();
+			break;
+		}
+
+		if (messageSize == 0)
+			break;
+
+		offset += messageSize;
+	}
+
+	received.erase(received.begin(), received.begin() + offset);
+	return changed;
+}
+
+int BroadcastClient::HandleMessage(const uint8_t* data, size_t size, bool& changed)
+{
+	switch ((BroadcastMessage)data[0])
+	{
+	case BroadcastMessage::Keyframe:
+	{
+		const size_t messageSize = 1 + 4 + Framebuffer::HEIGHT * sizeof(uint64_t);
+		if (size < messageSize)
+			return 0;
+
+		frame = (uint32_t)ReadBytes(data + 1, 4);
+		for (int y = 0; y < Framebuffer::HEIGHT; y++)
+			framebuffer.XorRow(y, framebuffer.GetRow(y) ^ ReadBytes(data + 5 + y * sizeof(uint64_t), 8));
+
+		hasKeyframe = true;
+		changed = true;
+		return (int)messageSize;
+	}
+
+	case BroadcastMessage::Delta:
+	{
+		if (size < 9)
+			return 0;
+
+		const uint32_t changedRows = (uint32_t)ReadBytes(data + 5, 4);
+		const uint8_t* rows = data + 9;
+		const size_t messageSize = 9 + popcount(changedRows) * sizeof(uint64_t);
+		if (size < messageSize)
+			return 0;
+
+		// Deltas are relative to the previous frame, which only a keyframe gives a start for
+		if (hasKeyframe)
+		{
+			frame = (uint32_t)ReadBytes(data + 1, 4);
+			for (int y = 0; y < Framebuffer::HEIGHT; y++)
+			{
+				if (changedRows & (1u << y))
+				{
+					framebuffer.XorRow(y, ReadBytes(rows, 8));
+					rows += sizeof(uint64_t);
+				}
+			}
+
+			changed = true;
+		}
+
+		return (int)messageSize;
+	}
+
+	case BroadcastMessage::AudioGate:
+		if (size < 3)
+			return 0;
+
+		// A zero duration stops the beep
+		if (audio != nullptr)
+			audio->StartBeep((uint16_t)ReadBytes(data + 1, 2));
+
+		return 3;
+
+	default:
+		return -1;
+	}
+}
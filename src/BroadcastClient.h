@@ -0,0 +1,83 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Framebuffer.h"
+#include "StreamSocket.h"
+
+// Forward declarations
+class AudioSink;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Spectates a session streamed by a BroadcastServer, rebuilding its Framebuffer from the received messages.
+ */
+class BroadcastClient
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param audio The AudioSink beeps are played through, or nullptr.
+	 */
+	BroadcastClient(AudioSink* audio);
+
+	/**
+	 * @brief Connects to a BroadcastServer.
+	 * @param address "unix:<path>" for a Unix domain socket, or "<host>:<port>" for TCP.
+	 * @return Returns false if the connection couldn't be made.
+	 */
+	bool Connect(const string address);
+
+	/**
+	 * @brief Handles all messages received since the previous Poll(), without waiting for more.
+	 * @return Returns true if the Framebuffer changed.
+	 */
+	bool Poll();
+
+	/**
+	 * @brief Whether still connected to the BroadcastServer.
+	 * @return Returns false if the connection was lost or the stream was invalid.
+	 */
+	bool IsConnected() const { return socket.IsOpen(); }
+
+	/**
+	 * @brief Gets the Framebuffer as of the most recently received frame.
+	 * @return Returns the Framebuffer.
+	 */
+	const Framebuffer& GetFramebuffer() const { return framebuffer; }
+
+	/**
+	 * @brief Gets the number of the most recently received frame, as counted by the BroadcastServer.
+	 * @return Returns the frame number.
+	 */
+	uint32_t GetFrame() const { return frame; }
+
+	/**
+	 * @brief Gets the number of bytes received.
+	 * @return Returns the number of bytes.
+	 */
+	uint64_t GetNumBytesReceived() const { return numBytesReceived; }
+
+private:
+	/**
+	 * @brief Handles a single message, if it was received completely.
+	 * @param data The received bytes, starting at the message's type.
+	 * @param size Number of received bytes.
+	 * @param changed Set to true if the message changed the Framebuffer.
+	 * @return Returns the size of the handled message, 0 if it's incomplete, or -1 if it's invalid.
+	 */
+	int HandleMessage(const uint8_t* data, size_t size, bool& changed);
+
+	AudioSink* audio = nullptr;				///< The AudioSink beeps are played through, or nullptr.
+	StreamSocket socket;					///< Connection to the BroadcastServer.
+	vector<uint8_t> received;				///< Bytes received but not handled yet, as messages may arrive in parts.
+	Framebuffer framebuffer;				///< The Framebuffer rebuilt from the received messages.
+	uint32_t frame = 0;						///< Number of the most recently received frame.
+	bool hasKeyframe = false;				///< Whether a keyframe was received, which deltas are applied on top of.
+	uint64_t numBytesReceived = 0;			///< Number of bytes received.
+};
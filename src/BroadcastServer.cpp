@@ -0,0 +1,336 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "BroadcastServer.h"
+#include "MachineState.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+namespace
+{
+	/**
+	 * @brief Appends a value to a message in little endian, regardless of the host's byte order.
+	 * @param output The message to append to.
+	 * @param value The value to write.
+	 * @param size Number of bytes to write.
+	 */
+	inline void WriteBytes(vector<uint8_t>& output, uint64_t value, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+			output.push_back((uint8_t)(value >> (i * 8)));
+	}
+}
+
+BroadcastServer::~BroadcastServer()
+{
+	Close();
+}
+
+bool BroadcastServer::Open(const string address)
+{
+	Close();
+
+	if (!listener.Listen(address))
+		return false;
+
+#ifdef __linux__
+	epoll = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll < 0)
+	{
+		cerr << "Could not create epoll instance" << endl;
+		Close();
+		return false;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = (int)listener.GetHandle();
+	epoll_ctl(epoll, EPOLL_CTL_ADD, event.data.fd, &event);
+#endif
+
+	if (listener.GetPort() != 0)
+		cout << "Broadcasting on port " << listener.GetPort() << endl;
+	else
+		cout << "Broadcasting on '" << address << "'" << endl;
+
+	return true;
+}
+
+void BroadcastServer::Close()
+{
+	spectators.clear();
+	listener.Close();
+
+#ifdef __linux__
+	if (epoll >= 0)
+		close(epoll);
+
+	epoll = -1;
+#endif
+}
+
+void BroadcastServer::Publish(const MachineState& state)
+{
+	frame++;
+
+	// Only the rows which changed, most frames only change a few
+	uint32_t changedRows = 0;
+	for (int y = 0; y < Framebuffer::HEIGHT; y++)
+	{
+		if (state.framebuffer.GetRow(y) != framebuffer.GetRow(y))
+			changedRows |= 1u << y;
+	}
+
+	const bool isBeeping = state.soundTimer > 0;
+	beepDurationMS = (uint16_t)(state.soundTimer * 1000 / 60);
+	if (changedRows == 0 && isBeeping == beeping)
+		return;
+
+	// Encoded once, every spectator's queue referring to the same buffer
+	auto message = make_shared<vector<uint8_t>>();
+	if (isBeeping != beeping)
+	{
+		WriteBytes(*message, (uint8_t)BroadcastMessage::AudioGate, 1);
+		WriteBytes(*message, beepDurationMS, 2);
+		beeping = isBeeping;
+	}
+
+	if (changedRows != 0)
+	{
+		WriteBytes(*message, (uint8_t)BroadcastMessage::Delta, 1);
+		WriteBytes(*message, frame, 4);
+		WriteBytes(*message, changedRows, 4);
+
+		for (int y = 0; y < Framebuffer::HEIGHT; y++)
+		{
+			if (changedRows & (1u << y))
+				WriteBytes(*message, state.framebuffer.GetRow(y) ^ framebuffer.GetRow(y), 8);
+		}
+	}
+
+	framebuffer = state.framebuffer;
+	keyframe.reset();
+	numBytesEncoded += message->size();
+
+	const Message shared = move(message);
+	vector<intptr_t> disconnected;
+	for (auto& [handle, spectator] : spectators)
+	{
+		Enqueue(spectator, shared);
+		if (!spectator.blocked && !Flush(handle, spectator))
+			disconnected.push_back(handle);
+	}
+
+	for (intptr_t handle : disconnected)
+		Disconnect(handle);
+}
+
+void BroadcastServer::Poll(int timeoutMS)
+{
+	if (!listener.IsOpen())
+		return;
+
+#ifdef __linux__
+	epoll_event events[64];
+	const int numEvents = epoll_wait(epoll, events, 64, timeoutMS);
+
+	for (int i = 0; i < numEvents; i++)
+	{
+		const intptr_t handle = events[i].data.fd;
+		if (handle == listener.GetHandle())
+			AcceptSpectators();
+		else
+			HandleEvent(handle, events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR), events[i].events & EPOLLOUT);
+	}
+#else
+	// Without epoll, the set of sockets to wait on is passed every time
+	vector<pollfd> sockets;
+	sockets.reserve(spectators.size() + 1);
+	sockets.push_back(pollfd{ (decltype(pollfd::fd))listener.GetHandle(), POLLIN, 0 });
+	for (const auto& [handle, spectator] : spectators)
+		sockets.push_back(pollfd{ (decltype(pollfd::fd))handle, (short)(POLLIN | (spectator.blocked ? POLLOUT : 0)), 0 });
+
+#ifdef _WIN32
+	const int numEvents = WSAPoll(sockets.data(), (ULONG)sockets.size(), timeoutMS);
+#else
+	const int numEvents = poll(sockets.data(), sockets.size(), timeoutMS);
+#endif
+
+	for (size_t i = 0; i < sockets.size() && numEvents > 0; i++)
+	{
+		if (sockets[i].revents == 0)
+			continue;
+
+		if (i == 0)
+			AcceptSpectators();
+		else
+			HandleEvent((intptr_t)sockets[i].fd, sockets[i].revents & (POLLIN | POLLHUP | POLLERR), sockets[i].revents & POLLOUT);
+	}
+#endif
+}
+
+const BroadcastServer::Message& BroadcastServer::GetKeyframe()
+{
+	if (keyframe == nullptr)
+	{
+		auto message = make_shared<vector<uint8_t>>();
+		message->reserve(1 + 2 + 1 + 4 + Framebuffer::HEIGHT * sizeof(uint64_t));
+
+		// Whatever the spectator heard before is unknown, so the beep is always started or stopped
+		WriteBytes(*message, (uint8_t)BroadcastMessage::AudioGate, 1);
+		WriteBytes(*message, beepDurationMS, 2);
+
+		WriteBytes(*message, (uint8_t)BroadcastMessage::Keyframe, 1);
+		WriteBytes(*message, frame, 4);
+
+		for (int y = 0; y < Framebuffer::HEIGHT; y++)
+			WriteBytes(*message, framebuffer.GetRow(y), 8);
+
+		numBytesEncoded += message->size();
+		keyframe = move(message);
+	}
+
+	return keyframe;
+}
+
+void BroadcastServer::Enqueue(Spectator& spectator, const Message& message)
+{
+	if (spectator.queue.size() >= MAX_QUEUED_MESSAGES)
+	{
+		// Deltas only add up when none are missing, so skip them all, finishing the one halfway sent
+		spectator.queue.erase(spectator.queue.begin() + (spectator.offset > 0 ? 1 : 0), spectator.queue.end());
+		spectator.needsKeyframe = true;
+		numResyncs++;
+	}
+
+	// The keyframe is of the frame just published, so it replaces that frame's delta
+	if (spectator.needsKeyframe)
+	{
+		spectator.queue.push_back(GetKeyframe());
+		spectator.needsKeyframe = false;
+	}
+	else
+		spectator.queue.push_back(message);
+}
+
+bool BroadcastServer::Flush(intptr_t handle, Spectator& spectator)
+{
+	while (!spectator.queue.empty())
+	{
+		const vector<uint8_t>& message = *spectator.queue.front();
+		const int sent = spectator.socket.Send(message.data() + spectator.offset, message.size() - spectator.offset);
+		if (sent < 0)
+			return false;
+
+		// The socket's buffer is full, continue once it's writable again
+		if (sent == 0)
+		{
+			if (!spectator.blocked)
+			{
+				spectator.blocked = true;
+				Watch(handle, true);
+			}
+
+			return true;
+		}
+
+		numBytesSent += sent;
+		spectator.offset += sent;
+		if (spectator.offset == message.size())
+		{
+			spectator.queue.pop_front();
+			spectator.offset = 0;
+		}
+	}
+
+	if (spectator.blocked)
+	{
+		spectator.blocked = false;
+		Watch(handle, false);
+	}
+
+	return true;
+}
+
+void BroadcastServer::Watch(intptr_t handle, bool writable)
+{
+#ifdef __linux__
+	epoll_event event = {};
+	event.events = EPOLLIN | (writable ? (uint32_t)EPOLLOUT : 0u);
+	event.data.fd = (int)handle;
+	epoll_ctl(epoll, EPOLL_CTL_MOD, (int)handle, &event);
+#else
+	// Sockets are waited on according to Spectator::blocked
+	(void)handle;
+	(void)writable;
+#endif
+}
+
+void BroadcastServer::Disconnect(intptr_t handle)
+{
+#ifdef __linux__
+	epoll_ctl(epoll, EPOLL_CTL_DEL, (int)handle, nullptr);
+#endif
+
+	spectators.erase(handle);
+}
+
+void BroadcastServer::AcceptSpectators()
+{
+	StreamSocket socket;
+	while (listener.Accept(socket))
+	{
+		const intptr_t handle = socket.GetHandle();
+		Spectator& spectator = spectators[handle];
+		spectator.socket = move(socket);
+
+#ifdef __linux__
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = (int)handle;
+		epoll_ctl(epoll, EPOLL_CTL_ADD, (int)handle, &event);
+#endif
+
+		// Show what's on screen right away, rather than only what changes from now on
+		Enqueue(spectator, GetKeyframe());
+		if (!Flush(handle, spectator))
+			Disconnect(handle);
+	}
+}
+
+void BroadcastServer::HandleEvent(intptr_t handle, bool readable, bool writable)
+{
+	auto it = spectators.find(handle);
+	if (it == spectators.end())
+		return;
+
+	Spectator& spectator = it->second;
+
+	// Spectators have nothing to say, anything readable is either ignored or them leaving
+	if (readable)
+	{
+		uint8_t data[256];
+		int received;
+		while ((received = spectator.socket.Receive(data, sizeof(data))) > 0)
+		{
+		}
+
+		if (received < 0)
+		{
+			Disconnect(handle);
+			return;
+		}
+	}
+
+	if (writable && !Flush(handle, spectator))
+		Disconnect(handle);
+}
@@ -0,0 +1,185 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include "Framebuffer.h"
+#include "StreamSocket.h"
+
+// Forward declarations
+struct MachineState;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Types of messages a BroadcastServer streams to its spectators, each following a single byte with the type.
+ */
+enum class BroadcastMessage : uint8_t
+{
+	Keyframe,		///< The complete Framebuffer: frame number (4 bytes), then every row (8 bytes each). Always preceded by an AudioGate.
+	Delta,			///< Changes to the Framebuffer: frame number (4 bytes), bitmask of changed rows (4 bytes), then the XOR of every changed row (8 bytes each).
+	AudioGate,		///< The beep starting or stopping: duration in milliseconds (2 bytes), 0 when it stopped.
+};
+
+/**
+ * @brief Streams every frame of a single Emulator to many spectators over TCP or a Unix domain socket, so a session
+ * can be watched on many screens without emulating it more than once.
+ *
+ * Each frame is encoded once as the XOR of the packed rows which changed, plus whether the beep started or stopped,
+ * into a buffer shared by every spectator's queue. Publishing a frame therefore costs the same however many spectators
+ * are watching and however slowly they're reading, besides queueing a reference per spectator. Sockets are written
+ * to as far as they accept data without waiting, an event loop (epoll on Linux, poll elsewhere) telling which ones
+ * can take more and which spectators joined or left.
+ *
+ * Spectators who fall too far behind have their queue dropped, to catch up through a keyframe instead, which is also
+ * what they receive first when joining. As that keyframe replaces whatever AudioGate the frame's delta carried, it
+ * comes with one of its own, starting or stopping the beep to match the frame.
+ */
+class BroadcastServer
+{
+public:
+	/**
+	 * @brief Destructor, disconnecting all spectators.
+	 */
+	~BroadcastServer();
+
+	/**
+	 * @brief Starts listening for spectators.
+	 * @param address "unix:<path>" for a Unix domain socket, or "[<host>:]<port>" for TCP.
+	 * @return Returns false if the address couldn't be listened on.
+	 */
+	bool Open(const string address);
+
+	/**
+	 * @brief Disconnects all spectators and stops listening.
+	 */
+	void Close();
+
+	/**
+	 * @brief Encodes a frame once, queues it for every spectator and sends as much as their sockets accept.
+	 * @param state The MachineState whose Framebuffer and sound timer are published.
+	 */
+	void Publish(const MachineState& state);
+
+	/**
+	 * @brief Accepts spectators who joined, disconnects those who left, and sends queued frames to sockets which can
+	 * take more.
+	 * @param timeoutMS Milliseconds to wait for any of that to happen, 0 to return right away.
+	 */
+	void Poll(int timeoutMS);
+
+	/**
+	 * @brief Gets the TCP port spectators can connect to.
+	 * @return Returns the port, or 0 when listening on a Unix domain socket.
+	 */
+	uint16_t GetPort() const { return listener.GetPort(); }
+
+	/**
+	 * @brief Gets the number of spectators currently connected.
+	 * @return Returns the number of spectators.
+	 */
+	size_t GetNumSpectators() const { return spectators.size(); }
+
+	/**
+	 * @brief Gets the number of bytes encoded for spectators, which are sent once per spectator.
+	 * @return Returns the number of bytes.
+	 */
+	uint64_t GetNumBytesEncoded() const { return numBytesEncoded; }
+
+	/**
+	 * @brief Gets the number of bytes sent to all spectators together.
+	 * @return Returns the number of bytes.
+	 */
+	uint64_t GetNumBytesSent() const { return numBytesSent; }
+
+	/**
+	 * @brief Gets the number of times spectators fell behind, catching up through a keyframe.
+	 * @return Returns the number of keyframes sent to catch up.
+	 */
+	uint64_t GetNumResyncs() const { return numResyncs; }
+
+	static const size_t MAX_QUEUED_MESSAGES = 120;		///< Number of messages a spectator may fall behind before having to catch up.
+
+private:
+	using Message = shared_ptr<const vector<uint8_t>>;
+
+	/**
+	 * @brief A connected spectator.
+	 */
+	struct Spectator
+	{
+		StreamSocket socket;				///< Connection to the spectator.
+		deque<Message> queue;				///< Messages not entirely sent yet, oldest first.
+		size_t offset = 0;					///< Number of bytes of the oldest message already sent.
+		bool blocked = false;				///< Whether the socket's buffer is full, waiting to be told it's writable.
+		bool needsKeyframe = true;			///< Whether the next message should be a keyframe, the deltas before it missing.
+	};
+
+	/**
+	 * @brief Encodes the Framebuffer most recently published as a keyframe, along with whether it was beeping, once per
+	 * frame.
+	 * @return Returns the shared keyframe.
+	 */
+	const Message& GetKeyframe();
+
+	/**
+	 * @brief Queues a message for a spectator, dropping its queue if it fell too far behind.
+	 * @param spectator The spectator to queue for.
+	 * @param message The message to queue.
+	 */
+	void Enqueue(Spectator& spectator, const Message& message);
+
+	/**
+	 * @brief Sends as much of a spectator's queue as its socket accepts, waiting for it to be writable otherwise.
+	 * @param handle Handle of the spectator's socket.
+	 * @param spectator The spectator.
+	 * @return Returns false if the spectator disconnected.
+	 */
+	bool Flush(intptr_t handle, Spectator& spectator);
+
+	/**
+	 * @brief Starts or stops waiting for a socket to become writable, besides readable.
+	 * @param handle Handle of the socket.
+	 * @param writable Whether to wait for it to become writable.
+	 */
+	void Watch(intptr_t handle, bool writable);
+
+	/**
+	 * @brief Disconnects a spectator.
+	 * @param handle Handle of the spectator's socket.
+	 */
+	void Disconnect(intptr_t handle);
+
+	/**
+	 * @brief Accepts all pending spectators, sending them the current keyframe.
+	 */
+	void AcceptSpectators();
+
+	/**
+	 * @brief Handles a spectator's socket being readable or writable, or failing.
+	 * @param handle Handle of the spectator's socket.
+	 * @param readable Whether the spectator sent something or disconnected.
+	 * @param writable Whether the socket can take more data.
+	 */
+	void HandleEvent(intptr_t handle, bool readable, bool writable);
+
+	StreamSocket listener;					///< Socket spectators connect to.
+	unordered_map<intptr_t, Spectator> spectators;	///< Connected spectators, by the handle of their socket.
+	Framebuffer framebuffer;				///< Framebuffer most recently published.
+	uint32_t frame = 0;						///< Number of frames published.
+	bool beeping = false;					///< Whether the most recently published frame was beeping.
+	uint16_t beepDurationMS = 0;			///< Duration of the beep left as of the most recently published frame, 0 if silent.
+	Message keyframe;						///< Keyframe of the most recently published frame, if encoded.
+	uint64_t numBytesEncoded = 0;			///< Number of bytes encoded.
+	uint64_t numBytesSent = 0;				///< Number of bytes sent to all spectators together.
+	uint64_t numResyncs = 0;				///< Number of keyframes sent to spectators who fell behind.
+#ifdef __linux__
+	int epoll = -1;							///< The epoll instance watching all sockets.
+#endif
+};
@@ -5,12 +5,24 @@
 #include "Renderer.h"
 #include "Emulator.h"
 #include "Sound.h"
+#include "Keyboard.h"
+#include "SteadyClock.h"
+#include "Framebuffer.h"
+#include "MachineState.h"
+#include "RewindBuffer.h"
+#include "StateFile.h"
+#include "Movie.h"
+#include "NetplaySession.h"
+#include "BroadcastServer.h"
+#include "BroadcastClient.h"
+#include "TripleBuffer.h"
+#include "InputQueue.h"
 
-Chip8::Chip8() : romPath("")
+Chip8::Chip8() : romPath(""), executionMode(ExecutionMode::CachedInterpreter), instructionsPerSecond(Emulator::OPCODES_FREQUENCY)
 {
 }
 
-Chip8::Chip8(const std::string romPath) : romPath(romPath)
+Chip8::Chip8(const std::string romPath) : romPath(romPath), executionMode(ExecutionMode::CachedInterpreter), instructionsPerSecond(Emulator::OPCODES_FREQUENCY)
 {
 }
 
@@ -32,6 +44,17 @@ Chip8::~Chip8()
 		window = nullptr;
 	}
 
+	delete keyboard;
+	keyboard = nullptr;
+
+	delete inputs;
+	inputs = nullptr;
+
+	delete frames;
+	frames = nullptr;
+
+	delete clock;
+	clock = nullptr;
 }
 
 bool Chip8::Init()
@@ -45,8 +68,24 @@ bool Chip8::Init()
 	if (!renderer->Init())
 		return false;
 
+	keyboard = new Keyboard();
+	clock = new SteadyClock();
+	frames = new TripleBuffer();
+	inputs = new InputQueue();
+
+	// Spectate rather than emulate, only needing to play the beeps
+	if (!spectateAddress.empty())
+	{
+		sound = new Sound();
+		if (!sound->Init())
+			return false;
+
+		spectator = new BroadcastClient(sound);
+		if (!spectator->Connect(spectateAddress))
+			return false;
+	}
 	// Load ROM if it's been passed in through the constructor
-	if (!romPath.empty() && !InitROM())
+	else if (!romPath.empty() && !InitROM())
 		return false;
 	
 	running = true;
@@ -60,12 +99,62 @@ void Chip8::Shutdown()
 	if (hasShutDown)
 		return;
 
+	// Everything below is the emulation thread's until it stopped
+	StopEmulation();
+
+	// A networked game isn't ours alone to resume
+	if (emulator != nullptr && stateFile != nullptr && netplay == nullptr)
+	{
+		stateFile->Save(*emulator);
+		stateFile->Flush();
+	}
+
+	delete stateFile;
+	stateFile = nullptr;
+
+	if (emulator != nullptr && movie != nullptr)
+		movie->StopRecording(emulator->GetState().cycles);
+
+	delete movie;
+	movie = nullptr;
+
+	if (netplay != nullptr)
+	{
+		SDL_Log("Rolled back %u times, simulating %llu frames again, and sent %.1f bytes per frame", netplay->GetNumRollbacks(),
+			(unsigned long long)netplay->GetNumResimulatedFrames(), netplay->GetFrame() > 0 ? netplay->GetNumBytesSent() / (double)netplay->GetFrame() : 0.0);
+	}
+
+	delete netplay;
+	netplay = nullptr;
+
+	if (broadcast != nullptr)
+		SDL_Log("Broadcast to %zu spectators, sending %.1f MB", broadcast->GetNumSpectators(), broadcast->GetNumBytesSent() / 1e6);
+
+	delete broadcast;
+	broadcast = nullptr;
+
+	delete spectator;
+	spectator = nullptr;
+
 	if (emulator != nullptr)
 	{
+		SDL_Log("Skipped %.1f seconds of idle emulation", emulator->GetSkippedTimeNS() / 1e9);
+
+		const uint64_t runAheadTime = emulator->GetRunAheadTimeNS();
+		if (runAheadTime > 0)
+		{
+			const uint64_t runTime = emulator->GetRunTimeNS();
+			SDL_Log("Running %u frames ahead took %.1f ms on top of %.1f ms of emulation (+%.0f%% CPU)", runAheadFrames,
+				runAheadTime / 1e6, (runTime - runAheadTime) / 1e6, runTime > runAheadTime ? 100.0 * runAheadTime / (runTime - runAheadTime) : 0.0);
+		}
+
 		delete emulator;
 		emulator = nullptr;
 	}
 
+	delete rewindBuffer;
+	rewindBuffer = nullptr;
+
 	if (sound != nullptr)
 	{
 		sound->Shutdown();
@@ -80,9 +169,25 @@ bool Chip8::Run()
 {
 	if (!HandleEvents())
 		running = false;
+	else if (spectator != nullptr)
+	{
+		if (spectator->Poll())
+			renderer->Present(spectator->GetFramebuffer());
+
+		SDL_Delay(1);
+	}
 	else if (emulator != nullptr)
-		emulator->Run();
+	{
+		SendInput();
+
+		// Only the most recent frame matters, however many the emulation thread presented since
+		if (const Framebuffer* framebuffer = frames->Acquire())
+			renderer->Present(*framebuffer);
 
+		SDL_Delay(1);
+	}
+
+	// Free to wait for the swapchain, emulation carries on regardless
 	renderer->Render();
 
 	return running;
@@ -90,19 +195,182 @@ bool Chip8::Run()
 
 bool Chip8::InitROM()
 {
-	renderer->Clear();
+	renderer->Present(Framebuffer());
 
 	sound = new Sound();
 	if (!sound->Init())
 		return false;
 
-	emulator = new Emulator(romPath, renderer, sound);
-	if (!emulator->Init())
+	emulator = new Emulator(romPath, frames, sound, inputs, clock);
+
+	// Resume where the previous run of this ROM left off, if it saved its state and we're not recording or playing from boot
+	stateFile = new StateFile(romPath);
+	if (stateFile->Open() && stateFile->GetResumeState() != nullptr && resume && moviePath.empty() && netplayPort == 0)
+	{
+		emulator->Resume(*stateFile->GetResumeState(), stateFile->GetRomSize());
+		SDL_Log("Resumed from %s%s, start with --no-resume to boot instead", romPath.c_str(), StateFile::EXTENSION);
+	}
+	else if (!emulator->Init())
+	{
+		// Nothing to run, nor worth saving
+		delete stateFile;
+		stateFile = nullptr;
+		delete emulator;
+		emulator = nullptr;
 		return false;
+	}
+
+	emulator->SetExecutionMode(executionMode);
+	emulator->SetInstructionsPerSecond(instructionsPerSecond);
+	emulator->SetRunAheadFrames(runAheadFrames);
+
+	if (!moviePath.empty())
+	{
+		movie = new Movie();
+		if (movie->StartRecording(moviePath, *emulator))
+			emulator->SetMovie(movie);
+	}
+
+	if (netplayPort != 0)
+	{
+		netplay = new NetplaySession(*emulator, *clock);
+		netplay->SetSimulatedLink(simulatedLatencyMS, simulatedLossPercent);
+
+		const bool started = netplayHost.empty() ? netplay->Host(netplayPort) : netplay->Join(netplayHost, netplayPort);
+		if (!started)
+		{
+			SDL_Log("Could not start netplay, playing alone");
+			delete netplay;
+			netplay = nullptr;
+		}
+	}
+
+	if (!broadcastAddress.empty())
+	{
+		broadcast = new BroadcastServer();
+		if (!broadcast->Open(broadcastAddress))
+		{
+			SDL_Log("Could not start broadcasting");
+			delete broadcast;
+			broadcast = nullptr;
+		}
+	}
+
+	rewindBuffer = new RewindBuffer();
+	lastFrameTime = clock->GetTicksNS();
+	lastSaveTime = lastFrameTime;
+	rewinding = false;
+
+	StartEmulation();
 
 	return true;
 }
 
+void Chip8::StartEmulation()
+{
+	emulating = true;
+	emulationThread = std::thread([this]()
+	{
+		while (emulating)
+			RunEmulator();
+	});
+}
+
+void Chip8::StopEmulation()
+{
+	emulating = false;
+	if (emulationThread.joinable())
+		emulationThread.join();
+}
+
+void Chip8::SendInput()
+{
+	const uint16_t keys = keyboard->GetKeys();
+	const bool rewind = keyboard->IsRewindPressed();
+	if (keys == sentKeys && rewind == sentRewind)
+		return;
+
+	// A full queue keeps the change pending, to be sent with whatever changed by the next call
+	if (inputs->Push({ keys, rewind }))
+	{
+		sentKeys = keys;
+		sentRewind = rewind;
+	}
+}
+
+void Chip8::RunEmulator()
+{
+	inputs->Poll();
+
+	// Spectators joining or leaving, or able to take more frames
+	if (broadcast != nullptr)
+		broadcast->Poll(0);
+
+	// The session decides which frames to simulate, and with what input
+	if (netplay != nullptr)
+	{
+		if (netplay->Run(inputs->GetKeys()))
+		{
+			frames->Present(emulator->GetFramebuffer());
+			if (broadcast != nullptr)
+				broadcast->Publish(emulator->GetState());
+		}
+
+		SDL_Delay(1);
+		return;
+	}
+
+	const uint64_t now = clock->GetTicksNS();
+	const bool frameElapsed = now - lastFrameTime >= FRAME_NS;
+	if (frameElapsed)
+		lastFrameTime = now;
+
+	if (inputs->IsRewindPressed() && movie == nullptr)
+	{
+		// Step back a frame at a time, at the rate they were recorded
+		MachineState state;
+		if (frameElapsed && rewindBuffer->StepBack(state))
+		{
+			emulator->Restore(state);
+			frames->Present(emulator->GetFramebuffer());
+			if (broadcast != nullptr)
+				broadcast->Publish(emulator->GetState());
+		}
+
+		rewinding = true;
+		SDL_Delay(1);
+		return;
+	}
+
+	// Continue from the rewound frame, rather than catching up on the time spent rewinding
+	if (rewinding)
+	{
+		emulator->SkipElapsedTime();
+		rewinding = false;
+	}
+
+	emulator->Run();
+
+	if (frameElapsed)
+	{
+		rewindBuffer->Record(emulator->GetState());
+		if (broadcast != nullptr)
+			broadcast->Publish(emulator->GetState());
+	}
+
+	// Saved into memory shared with the file, so it survives a crash of the process
+	if (now - lastSaveTime >= SAVE_INTERVAL_NS)
+	{
+		stateFile->Save(*emulator);
+		lastSaveTime = now;
+	}
+
+	// Only time or input can get the ROM out of its idle loop, and unless running as fast as possible a millisecond of
+	// opcodes is little enough to catch up on in one go, so there's no need to keep the host core busy
+	if (emulator->IsIdle() || instructionsPerSecond != Emulator::UNLIMITED_INSTRUCTIONS_PER_SECOND)
+		SDL_Delay(1);
+}
+
 bool Chip8::HandleEvents()
 {
 	SDL_Event e;
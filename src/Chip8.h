@@ -3,23 +3,57 @@
 
 // Includes
 #include <string>
+#include <cstdint>
+#include <thread>
+#include <atomic>
 
 // Forward declarations
 class Window;
 class Renderer;
 class Emulator;
 class Sound;
+class Keyboard;
+class Clock;
+class RewindBuffer;
+class StateFile;
+class Movie;
+class NetplaySession;
+class BroadcastServer;
+class BroadcastClient;
+class TripleBuffer;
+class InputQueue;
+enum class ExecutionMode;
 
 /**
  * @brief Main class for running the CHIP-8 emulation. 
  * 
  * A single instance of this class forms the entire lifetime of the application. It manages several subsystems: 
- * Emulator, Renderer and Sound as well the Window. Upon Init() it ensures all subsystems are correctly initialized,
+ * Emulator, Renderer, Sound and Keyboard as well the Window. Upon Init() it ensures all subsystems are correctly initialized,
  * otherwise quits the application. Then keeps Run() going, until user expresses the desire to quit, after which a
  * Shutdown() is called.
  * 
  * When the application isn't started through a ROM path in the arguments, initialization of Emulator and Sound is 
  * deferred until a ROM file is dragged on top of the Window. Until then, only Window and Renderer are active. 
+ *
+ * Every frame of emulation is recorded into a RewindBuffer. Holding the rewind key steps back through those frames at
+ * the rate they were recorded, after which emulation continues from there.
+ *
+ * The Emulator's state is also saved to a StateFile next to the ROM, periodically and on Shutdown(). When the same ROM
+ * is started again, it resumes from there rather than booting, unless resuming was turned off through SetResume().
+ *
+ * Optionally, all input is recorded into a Movie, which the headless runner replays to the exact same outcome. As a
+ * Movie starts at boot and only moves forward, recording skips resuming and disables rewinding.
+ *
+ * Alternatively, two players can play together over the network, in a NetplaySession which drives the Emulator
+ * instead. As both Emulators have to boot identically and stay in sync, that too skips resuming and disables rewinding.
+ *
+ * Every frame can also be broadcast to spectators through a BroadcastServer. Started as a spectator instead, the
+ * application doesn't emulate anything, showing the frames received from a BroadcastServer.
+ *
+ * Emulation runs on a thread of its own, so emulated time never depends on how long presenting to the window takes.
+ * Frames are handed to the main thread through a TripleBuffer, and input the other way through an InputQueue, neither
+ * of which ever blocks. Everything driven by the Emulator, such as rewinding, netplay, broadcasting and saving, runs on
+ * the emulation thread too, while the main thread only handles window events and renders.
  */
 class Chip8
 {
@@ -52,7 +86,63 @@ public:
 	void Shutdown();
 
 	/**
-	 * @brief Main loop, relaying the Run() to the Emulator, then the Renderer.
+	 * @brief Selects how the Emulator executes opcodes, applied whenever a ROM is (re)started.
+	 * @param mode The ExecutionMode to use.
+	 */
+	void SetExecutionMode(ExecutionMode mode) { executionMode = mode; }
+
+	/**
+	 * @brief Sets the rate at which the Emulator executes opcodes, applied whenever a ROM is (re)started.
+	 * @param instructionsPerSecond Number of opcodes per second, or Emulator::UNLIMITED_INSTRUCTIONS_PER_SECOND.
+	 */
+	void SetInstructionsPerSecond(uint32_t instructionsPerSecond) { this->instructionsPerSecond = instructionsPerSecond; }
+
+	/**
+	 * @brief Records the input of every ROM (re)started from now on into a Movie.
+	 * @param moviePath Path of the Movie file to write, or empty to not record.
+	 */
+	void SetMoviePath(const std::string moviePath) { this->moviePath = moviePath; }
+
+	/**
+	 * @brief Sets how many frames the Emulator runs ahead to hide input latency, applied whenever a ROM is (re)started.
+	 * @param runAheadFrames Number of frames to run ahead, 0 to disable running ahead.
+	 */
+	void SetRunAheadFrames(uint32_t runAheadFrames) { this->runAheadFrames = runAheadFrames; }
+
+	/**
+	 * @brief Sets whether ROMs (re)started from now on resume from their StateFile, or boot fresh and overwrite it.
+	 * @param resume Whether to resume when the StateFile holds a state.
+	 */
+	void SetResume(bool resume) { this->resume = resume; }
+
+	/**
+	 * @brief Plays every ROM (re)started from now on with a remote player, hosting or joining a NetplaySession.
+	 * @param netplayHost Name or address of the host to join, or empty to host.
+	 * @param netplayPort Port to host on or join, or 0 to play alone.
+	 */
+	void SetNetplay(const std::string netplayHost, uint16_t netplayPort) { this->netplayHost = netplayHost; this->netplayPort = netplayPort; }
+
+	/**
+	 * @brief Delays and drops packets sent to the remote player, to try out playing over a worse link.
+	 * @param latencyMS Delay added to every packet, in milliseconds.
+	 * @param lossPercent Percentage of packets dropped.
+	 */
+	void SetSimulatedLink(uint32_t latencyMS, uint32_t lossPercent) { simulatedLatencyMS = latencyMS; simulatedLossPercent = lossPercent; }
+
+	/**
+	 * @brief Broadcasts every frame of every ROM (re)started from now on to spectators.
+	 * @param broadcastAddress Address to listen for spectators on, or empty to not broadcast.
+	 */
+	void SetBroadcastAddress(const std::string broadcastAddress) { this->broadcastAddress = broadcastAddress; }
+
+	/**
+	 * @brief Spectates a broadcast upon Init(), rather than emulating a ROM.
+	 * @param spectateAddress Address of the BroadcastServer to spectate, or empty to emulate.
+	 */
+	void SetSpectateAddress(const std::string spectateAddress) { this->spectateAddress = spectateAddress; }
+
+	/**
+	 * @brief Main loop, handing input to the emulation thread and its most recent frame to the Renderer.
 	 * @return Returns whether the application should still be running or not to the outside world.
 	 */
 	bool Run();
@@ -70,12 +160,63 @@ private:
 	 */
 	bool HandleEvents();
 
+	/**
+	 * @brief Runs the Emulator, recording a frame whenever one has passed, or steps back a frame while rewinding.
+	 */
+	void RunEmulator();
+
+	/**
+	 * @brief Starts the emulation thread, which keeps calling RunEmulator() until StopEmulation().
+	 */
+	void StartEmulation();
+
+	/**
+	 * @brief Stops the emulation thread, if running, returning once it finished its current RunEmulator().
+	 */
+	void StopEmulation();
+
+	/**
+	 * @brief Queues the keys and rewind hotkey for the emulation thread, if they changed since they were last queued.
+	 */
+	void SendInput();
+
 	Window* window = nullptr;			///< Window instance.
 	Renderer* renderer = nullptr;		///< Renderer subsystem instance.
 	Sound* sound = nullptr;				///< Sound subsystem instance.
+	Keyboard* keyboard = nullptr;		///< Keyboard subsystem instance.
+	Clock* clock = nullptr;				///< Clock the Emulator schedules opcodes by.
 	Emulator* emulator = nullptr;		///< Emulator subsystem instance.
+	RewindBuffer* rewindBuffer = nullptr;	///< History of the Emulator's state, one entry per frame.
+	StateFile* stateFile = nullptr;		///< Where the Emulator's state is persisted, to resume after a restart.
+	Movie* movie = nullptr;				///< Movie the input is recorded into, if recording.
+	NetplaySession* netplay = nullptr;	///< Session with the remote player, if playing over the network.
+	BroadcastServer* broadcast = nullptr;	///< Server streaming frames to spectators, if broadcasting.
+	BroadcastClient* spectator = nullptr;	///< Client receiving frames from a broadcast, if spectating.
+	TripleBuffer* frames = nullptr;		///< Hands frames from the emulation thread to the main thread.
+	InputQueue* inputs = nullptr;		///< Hands input from the main thread to the emulation thread.
+	std::thread emulationThread;		///< Thread running the Emulator, while emulating.
+	std::atomic<bool> emulating = false;	///< Whether the emulation thread should keep running.
 
 	std::string romPath;				///< Path to the current ROM CHIP-8 is currently emulating.
+	std::string moviePath;				///< Path of the Movie to record into, empty when not recording.
+	ExecutionMode executionMode;		///< How the Emulator should execute opcodes.
+	uint32_t instructionsPerSecond;		///< Rate at which the Emulator should execute opcodes.
+	uint32_t runAheadFrames = 0;		///< Number of frames the Emulator should run ahead.
+	bool resume = true;					///< Whether a ROM resumes from its StateFile, rather than booting.
+	std::string netplayHost;			///< Name or address of the host to join, empty when hosting.
+	uint16_t netplayPort = 0;			///< Port to host on or join, 0 when playing alone.
+	uint32_t simulatedLatencyMS = 0;	///< Delay added to packets sent to the remote player, in milliseconds.
+	uint32_t simulatedLossPercent = 0;	///< Percentage of packets to the remote player which are dropped.
+	std::string broadcastAddress;		///< Address to listen for spectators on, empty when not broadcasting.
+	std::string spectateAddress;		///< Address of the broadcast to spectate, empty when emulating.
+	uint64_t lastFrameTime = 0;			///< Host time at which the most recent frame was recorded or rewound, in nanoseconds.
+	uint64_t lastSaveTime = 0;			///< Host time at which the state was most recently saved, in nanoseconds.
+	bool rewinding = false;				///< Whether the previous frame was rewound rather than run.
+	uint16_t sentKeys = 0;				///< Keys most recently queued for the emulation thread.
+	bool sentRewind = false;			///< Whether the rewind hotkey was held when input was most recently queued.
 	bool running = false;				///< Boolean keeping track of whether the application should still be running.
 	bool hasShutDown = false;			///< Fail-safe to prevent multiple Shutdown() calls.
+
+	static const uint64_t FRAME_NS = 1000000000 / 60;	///< Host time between two recorded frames, in nanoseconds.
+	static const uint64_t SAVE_INTERVAL_NS = 1000000000;	///< Host time between two periodic saves of the state, in nanoseconds.
 };
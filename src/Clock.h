@@ -0,0 +1,23 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+/**
+ * @brief Source of host time, used by Emulator::Run() to determine how many opcodes are owed.
+ */
+class Clock
+{
+public:
+	/**
+	 * @brief Destructor
+	 */
+	virtual ~Clock() = default;
+
+	/**
+	 * @brief Gets the current time. Only differences between calls are meaningful.
+	 * @return Returns the current time in nanoseconds, never decreasing.
+	 */
+	virtual uint64_t GetTicksNS() = 0;
+};
@@ -0,0 +1,34 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "CompiledRom.h"
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief All registered CompiledRoms. Function local, as registration happens during static initialization.
+ */
+static vector<const CompiledRom*>& GetCompiledRoms()
+{
+	static vector<const CompiledRom*> compiledRoms;
+	return compiledRoms;
+}
+
+bool RegisterCompiledRom(const CompiledRom* compiledRom)
+{
+	GetCompiledRoms().push_back(compiledRom);
+	return true;
+}
+
+const CompiledRom* FindCompiledRom(const uint8_t* data, size_t size)
+{
+	const uint64_t hash = HashRom(data, size);
+
+	for (const CompiledRom* compiledRom : GetCompiledRoms())
+	{
+		if (compiledRom->romSize == size && compiledRom->romHash == hash)
+			return compiledRom;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief A ROM which has been translated to C++ ahead of time by the chip8rc tool.
+ *
+ * Generated translation units define a single CompiledRom and register it during static initialization. When the
+ * Emulator loads a ROM whose contents match a registered CompiledRom, ExecutionMode::Compiled runs the translated
+ * code instead of interpreting. Translated code covers registers, I, jumps and skips; anything else returns control
+ * to the interpreter, as does any write to memory covered by translated code.
+ */
+struct CompiledRom
+{
+	/**
+	 * @brief Signature of translated code.
+	 * @param vars Pointer to the Emulator's 16 variable registers.
+	 * @param I The Emulator's index register.
+	 * @param PC The Emulator's program counter, at which execution starts and which is updated on return.
+	 * @param budget Maximum number of opcodes which may be executed.
+	 * @return Returns the number of opcodes executed, 0 if the opcode at PC should be interpreted instead.
+	 */
+	using Function = uint32_t (*)(uint8_t* vars, uint16_t& I, uint16_t& PC, uint32_t budget);
+
+	const char* name;						///< Name of the ROM, derived from its filename.
+	uint64_t romHash;						///< HashRom() of the ROM's contents.
+	uint32_t romSize;						///< Size of the ROM in bytes.
+	Function function;						///< Entry point of the translated code.
+	const uint16_t (*codeRanges)[2];		///< Memory ranges [begin, end) holding translated opcodes.
+	uint32_t numCodeRanges;					///< Number of entries in codeRanges.
+};
+
+/**
+ * @brief Hashes ROM contents (64 bit FNV-1a), used to match a loaded ROM to its CompiledRom.
+ * @param data The ROM's contents.
+ * @param size Size of the ROM in bytes.
+ * @return Returns the hash.
+ */
+inline uint64_t HashRom(const uint8_t* data, size_t size)
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Registers a CompiledRom, making it available to the Emulator. Called by generated code.
+ * @param compiledRom The CompiledRom, which should outlive the application.
+ * @return Always returns true, so it can initialize a static.
+ */
+bool RegisterCompiledRom(const CompiledRom* compiledRom);
+
+/**
+ * @brief Looks up the CompiledRom matching the given ROM contents.
+ * @param data The ROM's contents.
+ * @param size Size of the ROM in bytes.
+ * @return Returns the matching CompiledRom, or nullptr if there is none.
+ */
+const CompiledRom* FindCompiledRom(const uint8_t* data, size_t size);
@@ -0,0 +1,77 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "DispatchBenchmark.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "Emulator.h"
+#include "SteadyClock.h"
+#include "ScriptedKeys.h"
+
+static const struct
+{
+	ExecutionMode mode;
+	const char* name;
+} EXECUTION_MODES[] =
+{
+	{ ExecutionMode::Interpreter, "interpreter" },
+	{ ExecutionMode::CachedInterpreter, "cached" },
+	{ ExecutionMode::Threaded, "threaded" },
+	{ ExecutionMode::Jit, "jit" },
+	{ ExecutionMode::Compiled, "compiled" },
+};	///< Every ExecutionMode measured, in the order they're reported.
+
+int RunDispatchBenchmark(const std::string& romPath, uint32_t instructionsPerSecond, uint64_t numOpcodes)
+{
+	std::unique_ptr<MachineState> referenceState;
+	const char* referenceName = nullptr;
+	SteadyClock clock;
+	uint32_t numMismatches = 0;
+
+	for (const auto& [mode, name] : EXECUTION_MODES)
+	{
+		// A fresh Emulator per mode, so none starts out with another's caches or translations warmed up
+		Emulator emulator(romPath, nullptr, nullptr, nullptr, nullptr);
+		emulator.SetVerbose(false);
+		if (!emulator.Init())
+			return -1;
+
+		emulator.SetSeed(1);
+
+		// Which already says why, such as there being no compiled translation of the ROM
+		if (!emulator.SetExecutionMode(mode))
+			continue;
+
+		emulator.SetInstructionsPerSecond(instructionsPerSecond);
+		emulator.SetSkipIdleLoops(false);
+
+		const uint32_t cyclesPerFrame = std::max<uint32_t>(emulator.GetClockFrequency() / 60, 1);
+		const uint64_t startTime = clock.GetTicksNS();
+		for (uint64_t numExecuted = 0, frame = 0; numExecuted < numOpcodes; frame++)
+		{
+			emulator.SetKeys(GetScriptedKeys(0, (uint32_t)frame));
+			numExecuted += emulator.RunCycles((uint32_t)std::min<uint64_t>(cyclesPerFrame, numOpcodes - numExecuted));
+		}
+
+		const uint64_t runTime = clock.GetTicksNS() - startTime;
+		std::cout << name << ": " << runTime / 1e6 << " ms, " << runTime / (double)numOpcodes << " ns per opcode";
+
+		if (referenceState == nullptr)
+		{
+			referenceState = std::make_unique<MachineState>(emulator.GetState());
+			referenceName = name;
+		}
+		else if (memcmp(referenceState.get(), &emulator.GetState(), sizeof(MachineState)) != 0)
+		{
+			std::cout << ", differs from " << referenceName;
+			numMismatches++;
+		}
+
+		std::cout << std::endl;
+	}
+
+	std::cout << "Ran '" << romPath << "' for " << numOpcodes << " opcodes per mode, without skipping idle loops" << std::endl;
+
+	return referenceState != nullptr && numMismatches == 0 ? 0 : -1;
+}
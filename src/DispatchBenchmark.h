@@ -0,0 +1,17 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Runs a ROM for the same number of opcodes in every ExecutionMode supported for it, with scripted input and
+ * without skipping idle loops, so every opcode is actually dispatched. Reports the time per opcode of every mode, and
+ * checks they all end up in the same MachineState.
+ * @param romPath Path to the ROM to run.
+ * @param instructionsPerSecond Rate of the emulated clock, which determines the number of opcodes per frame of input.
+ * @param numOpcodes Number of opcodes every mode runs.
+ * @return Returns 0 if every mode ended up in the same MachineState.
+ */
+int RunDispatchBenchmark(const std::string& romPath, uint32_t instructionsPerSecond, uint64_t numOpcodes);
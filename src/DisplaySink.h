@@ -0,0 +1,23 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Forward declarations
+class Framebuffer;
+
+/**
+ * @brief Receives the frames the Emulator produces, such as the Renderer showing them in a window.
+ */
+class DisplaySink
+{
+public:
+	/**
+	 * @brief Destructor
+	 */
+	virtual ~DisplaySink() = default;
+
+	/**
+	 * @brief Called at most once per Emulator::Run(), whenever the Framebuffer changed since the previous call.
+	 * @param framebuffer The Emulator's current Framebuffer, which should be copied if it's needed after returning.
+	 */
+	virtual void Present(const Framebuffer& framebuffer) = 0;
+};
@@ -3,42 +3,181 @@
 //#define CHIP8_ORIGINAL
 
 #include "Emulator.h"
-#include "Renderer.h"
-#include "Sound.h"
-#include "SDL3/SDL.h"
+#include "DisplaySink.h"
+#include "AudioSink.h"
+#include "InputSource.h"
+#include "Clock.h"
+#include "CompiledRom.h"
+#include "Movie.h"
+#include "Profiler.h"
 #include <fstream>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 #include <bit>
 
-const vector<SDL_Scancode> Emulator::KEY_MAP =
-{
-	{ SDL_SCANCODE_X }, // 0
-	{ SDL_SCANCODE_1 }, // 1
-	{ SDL_SCANCODE_2 }, // 2
-	{ SDL_SCANCODE_3 }, // 3
-	{ SDL_SCANCODE_Q }, // 4
-	{ SDL_SCANCODE_W }, // 5
-	{ SDL_SCANCODE_E }, // 6
-	{ SDL_SCANCODE_A }, // 7
-	{ SDL_SCANCODE_S }, // 8
-	{ SDL_SCANCODE_D }, // 9
-	{ SDL_SCANCODE_Z }, // A
-	{ SDL_SCANCODE_C }, // B
-	{ SDL_SCANCODE_4 }, // C
-	{ SDL_SCANCODE_R }, // D
-	{ SDL_SCANCODE_F }, // E
-	{ SDL_SCANCODE_V }, // F
+/**
+ * @brief Applies a macro to every opcode handler, in the order of OpcodeIndex and OPCODE_HANDLERS.
+ */
+#define CHIP8_OPCODE_HANDLERS(HANDLER) \
+	HANDLER(Op00E0) HANDLER(Op00EE) HANDLER(Op1NNN) HANDLER(Op2NNN) HANDLER(Op3XNN) HANDLER(Op4XNN) \
+	HANDLER(Op5XY0) HANDLER(Op6XNN) HANDLER(Op7XNN) HANDLER(Op8XY0) HANDLER(Op8XY1) HANDLER(Op8XY2) \
+	HANDLER(Op8XY3) HANDLER(Op8XY4) HANDLER(Op8XY5) HANDLER(Op8XY6) HANDLER(Op8XY7) HANDLER(Op8XYE) \
+	HANDLER(Op9XY0) HANDLER(OpANNN) HANDLER(OpBNNN) HANDLER(OpCXNN) HANDLER(OpDXYN) HANDLER(OpEX9E) \
+	HANDLER(OpEXA1) HANDLER(OpFX07) HANDLER(OpFX0A) HANDLER(OpFX15) HANDLER(OpFX18) HANDLER(OpFX1E) \
+	HANDLER(OpFX29) HANDLER(OpFX33) HANDLER(OpFX55) HANDLER(OpFX65) HANDLER(OpUnknown)
+
+const OpcodeHandler Emulator::OPCODE_HANDLERS[] =
+{
+#define CHIP8_HANDLER(name) &Emulator::name,
+	CHIP8_OPCODE_HANDLERS(CHIP8_HANDLER)
+#undef CHIP8_HANDLER
 };
 
-Emulator::Emulator(const string romPath, Renderer* renderer, Sound* sound) :
+namespace
+{
+	/**
+	 * @brief Index of an opcode handler in Emulator::OPCODE_HANDLERS.
+	 */
+	enum class OpcodeIndex : uint8_t
+	{
+#define CHIP8_INDEX(name) name,
+		CHIP8_OPCODE_HANDLERS(CHIP8_INDEX)
+#undef CHIP8_INDEX
+	};
+
+	/**
+	 * @brief Determines which handler executes an Opcode, see https://en.wikipedia.org/wiki/CHIP-8#Opcode_table.
+	 * @param opcode The Opcode to classify.
+	 * @return The OpcodeIndex of its handler.
+	 */
+	constexpr OpcodeIndex Classify(Opcode opcode)
+	{
+		const uint16_t nnn = opcode & 0xFFF;
+		const uint8_t nn = opcode & 0xFF;
+		const uint8_t n = opcode & 0xF;
+
+		switch (opcode >> 12)
+		{
+			case 0x0:
+			{
+				switch (nnn)
+				{
+					case 0x0E0: return OpcodeIndex::Op00E0;
+					case 0x0EE: return OpcodeIndex::Op00EE;
+				}
+				break;
+			}
+
+			case 0x1: return OpcodeIndex::Op1NNN;
+			case 0x2: return OpcodeIndex::Op2NNN;
+			case 0x3: return OpcodeIndex::Op3XNN;
+			case 0x4: return OpcodeIndex::Op4XNN;
+			case 0x5: return OpcodeIndex::Op5XY0;
+			case 0x6: return OpcodeIndex::Op6XNN;
+			case 0x7: return OpcodeIndex::Op7XNN;
+
+			case 0x8:
+			{
+				switch (n)
+				{
+					case 0x0: return OpcodeIndex::Op8XY0;
+					case 0x1: return OpcodeIndex::Op8XY1;
+					case 0x2: return OpcodeIndex::Op8XY2;
+					case 0x3: return OpcodeIndex::Op8XY3;
+					case 0x4: return OpcodeIndex::Op8XY4;
+					case 0x5: return OpcodeIndex::Op8XY5;
+					case 0x6: return OpcodeIndex::Op8XY6;
+					case 0x7: return OpcodeIndex::Op8XY7;
+					case 0xE: return OpcodeIndex::Op8XYE;
+				}
+				break;
+			}
+
+			case 0x9: return OpcodeIndex::Op9XY0;
+			case 0xA: return OpcodeIndex::OpANNN;
+			case 0xB: return OpcodeIndex::OpBNNN;
+			case 0xC: return OpcodeIndex::OpCXNN;
+			case 0xD: return OpcodeIndex::OpDXYN;
+
+			case 0xE:
+			{
+				switch (nn)
+				{
+					case 0x9E: return OpcodeIndex::OpEX9E;
+					case 0xA1: return OpcodeIndex::OpEXA1;
+				}
+				break;
+			}
+
+			case 0xF:
+			{
+				switch (nn)
+				{
+					case 0x07: return OpcodeIndex::OpFX07;
+					case 0x0A: return OpcodeIndex::OpFX0A;
+					case 0x15: return OpcodeIndex::OpFX15;
+					case 0x18: return OpcodeIndex::OpFX18;
+					case 0x1E: return OpcodeIndex::OpFX1E;
+					case 0x29: return OpcodeIndex::OpFX29;
+					case 0x33: return OpcodeIndex::OpFX33;
+					case 0x55: return OpcodeIndex::OpFX55;
+					case 0x65: return OpcodeIndex::OpFX65;
+				}
+				break;
+			}
+		}
+
+		return OpcodeIndex::OpUnknown;
+	}
+
+	/**
+	 * @brief Builds OPCODE_TABLE at compile time.
+	 * @return The OpcodeIndex of every possible Opcode.
+	 */
+	constexpr array<uint8_t, 0x10000> BuildOpcodeTable()
+	{
+		array<uint8_t, 0x10000> table = {};
+		for (uint32_t opcode = 0; opcode < table.size(); opcode++)
+			table[opcode] = (uint8_t)Classify((Opcode)opcode);
+
+		return table;
+	}
+
+	/**
+	 * @brief Handler index of every possible Opcode, replacing a chain of nested switches with a single lookup.
+	 */
+	constexpr array<uint8_t, 0x10000> OPCODE_TABLE = BuildOpcodeTable();
+
+	/**
+	 * @brief Name of every kind of Opcode, indexed by OpcodeIndex, dropping the "Op" of its handler.
+	 */
+	const char* const OPCODE_NAMES[] =
+	{
+#define CHIP8_NAME(name) #name + 2,
+		CHIP8_OPCODE_HANDLERS(CHIP8_NAME)
+#undef CHIP8_NAME
+	};
+
+	static_assert((uint32_t)OpcodeIndex::OpUnknown + 1 == Emulator::NUM_OPCODE_KINDS, "NUM_OPCODE_KINDS must match the opcode handlers");
+}
+
+Emulator::Emulator(const string romPath, DisplaySink* display, AudioSink* audio, InputSource* input, Clock* clock) :
 	romPath(romPath),
-	renderer(renderer),
-	sound(sound),
-	memory(4096, 0),
-	vars(16, 0)
+	display(display),
+	audio(audio),
+	input(input),
+	clock(clock),
+	instructionCache(MEMORY_SIZE, Instruction{ &Emulator::DecodeIntoCache }),
+	compiledCode(MEMORY_SIZE, false)
 {
-	srand((unsigned int)time(0));
+	state.PC = PROGRAM_START;
+	state.randomState = (uint32_t)time(0) | 1; // xorshift never leaves, nor reaches, zero
 }
 
 bool Emulator::Init()
@@ -48,25 +187,270 @@ bool Emulator::Init()
 	
 	LoadFont();
 
+	if (clock != nullptr)
+		lastRunTime = clock->GetTicksNS();
+
 	return true;
 }
 
+bool Emulator::Init(const uint8_t* rom, size_t romSize)
+{
+	if (romSize > MAX_ROM_SIZE)
+	{
+		cerr << "Error, ROM of " << romSize << " bytes doesn't fit in memory" << endl;
+		return false;
+	}
+
+	if (romSize > 0)
+		memcpy(&state.memory[PROGRAM_START], rom, romSize);
+
+	LoadFont();
+	FindCompiledTranslation(romSize);
+
+	if (clock != nullptr)
+		lastRunTime = clock->GetTicksNS();
+
+	return true;
+}
+
+void Emulator::Resume(const MachineState& snapshot, size_t romSize)
+{
+	if (verbose)
+		cout << "Resuming '" << romPath << "'" << endl;
+
+	Restore(snapshot);
+	FindCompiledTranslation(romSize);
+
+	if (clock != nullptr)
+		lastRunTime = clock->GetTicksNS();
+}
+
 void Emulator::Run()
 {
-	HandleKeyboard();
-	HandleTimers();
+	HandleInput();
 
-	if (SDL_GetTicks() < nextOpcodeTime)
-		return;
+	const uint64_t now = clock->GetTicksNS();
+	uint64_t elapsed = now - lastRunTime;
+	lastRunTime = now;
+
+	// Don't try to catch up on long stalls, such as breakpoints or dragging the window
+	if (elapsed > MAX_CATCH_UP_NS)
+		elapsed = MAX_CATCH_UP_NS;
+
+	if (instructionsPerSecond == UNLIMITED_INSTRUCTIONS_PER_SECOND)
+	{
+		// Execute for a fixed slice of host time, only checking the clock in between batches
+		do
+		{
+			RunCycles(UNLIMITED_BATCH_CYCLES);
+		}
+		while (!idle && clock->GetTicksNS() - now < UNLIMITED_SLICE_NS);
+	}
+	else
+	{
+		// Accumulate owed opcodes without losing fractions, so any instruction rate is reached exactly
+		cycleAccumulator += elapsed * instructionsPerSecond;
+		owedCycles += cycleAccumulator / NS_PER_SECOND;
+		cycleAccumulator %= NS_PER_SECOND;
+
+		if (owedCycles > 0)
+			owedCycles -= RunCycles((uint32_t)owedCycles);
+
+		// Present a speculative frame once per host frame instead, never the actual one
+		if (runAheadFrames > 0 && display != nullptr)
+		{
+			if (now - lastRunAheadTime >= NS_PER_SECOND / TIMER_DECREMENT_FREQUENCY)
+			{
+				lastRunAheadTime = now;
+				RunAhead();
+			}
+
+			runTime += clock->GetTicksNS() - now;
+			return;
+		}
+	}
+
+	// Present at most once per Run(), however many times the ROM drew
+	if (framebufferChanged && display != nullptr)
+	{
+		display->Present(state.framebuffer);
+		framebufferChanged = false;
+	}
+
+	runTime += clock->GetTicksNS() - now;
+}
+
+void Emulator::RunAhead()
+{
+	const uint64_t startTime = clock->GetTicksNS();
+
+	// Besides the MachineState, RunCycles() only changes these
+	Snapshot(runAheadState);
+	const bool wasIdle = idle;
+	const uint64_t previousSkippedTime = skippedTime;
+
+	// Emulate the frames ahead with the keys currently pressed, as if they'll be held
+	speculating = true;
+	RunCycles(runAheadFrames * (GetClockFrequency() / TIMER_DECREMENT_FREQUENCY));
+	speculating = false;
+
+	display->Present(state.framebuffer);
+
+	Restore(runAheadState);
+	idle = wasIdle;
+	skippedTime = previousSkippedTime;
+	framebufferChanged = false;
 
-	Opcode opcode = Fetch();
-	DecodeAndExecute(opcode);
-	nextOpcodeTime = SDL_GetTicks() + (1000.f / OPCODES_FREQUENCY);
+	runAheadTime += clock->GetTicksNS() - startTime;
+}
+
+void Emulator::SetInstructionsPerSecond(uint32_t instructionsPerSecond)
+{
+	this->instructionsPerSecond = instructionsPerSecond;
+	cycleAccumulator = 0;
+	owedCycles = 0;
+}
+
+uint32_t Emulator::RunCycles(uint32_t numCycles)
+{
+	uint32_t numExecuted = 0;
+	idle = false;
+
+	while (numExecuted < numCycles)
+	{
+		const uint16_t previousPC = state.PC;
+		if (coverage != nullptr)
+			RecordCoverage(state.PC);
+
+		const uint32_t numStepped = profiler != nullptr ? StepProfiled() : Step(numCycles - numExecuted);
+		HandleTimers(numStepped);
+		state.cycles += numStepped;
+		numExecuted += numStepped;
+
+		// Every loop jumps backwards, so only then can we have arrived at the start of an idle one
+		if (skipIdleLoops && state.PC <= previousPC && numExecuted < numCycles)
+		{
+			const uint32_t numSkipped = SkipIdleLoop(numCycles - numExecuted);
+			state.cycles += numSkipped;
+			numExecuted += numSkipped;
+
+			if (profiler != nullptr)
+				profiler->RecordSkipped(numSkipped);
+		}
+	}
+
+	return numExecuted;
+}
+
+void Emulator::SetCoverage(uint8_t* coverage)
+{
+	this->coverage = coverage;
+	touchedCoverage.clear();
+	touchedCoverage.reserve(MachineState::MEMORY_SIZE);
+}
+
+void Emulator::ClearCoverage()
+{
+	for (uint32_t index : touchedCoverage)
+		coverage[index] = 0;
+
+	touchedCoverage.clear();
+}
+
+void Emulator::RecordCoverage(uint16_t address)
+{
+	static_assert(NUM_OPCODE_KINDS <= 1 << COVERAGE_KIND_BITS, "Every kind of Opcode needs its own coverage counter");
+
+	// Read from memory rather than the instructionCache, whose entries aren't decoded until first executed
+	const uint32_t index = ((address & MEMORY_MASK) << COVERAGE_KIND_BITS) | OPCODE_TABLE[ReadOpcode(address)];
+	uint8_t& counter = coverage[index];
+	if (counter == 0)
+		touchedCoverage.push_back(index);
+
+	counter += counter != 0xFF;
+}
+
+uint32_t Emulator::SkipIdleLoop(uint32_t maxCycles)
+{
+	const Opcode opcode = ReadOpcode(state.PC);
+	uint32_t numSkipped = 0;
+
+	if (opcode == (0x1000 | state.PC) || ((opcode & 0xF0FF) == 0xF00A && state.keys == 0))
+	{
+		// Jumping to itself, or waiting for a key, which is only polled in between Run()s
+		numSkipped = maxCycles;
+	}
+	else if ((opcode & 0xF0FF) == 0xF007)
+	{
+		// FX07, 3XNN or 4XNN, then 1NNN back to the FX07, waiting for the delay timer
+		const uint8_t x = GetOpcodeNibble(opcode, 1);
+		const Opcode skip = ReadOpcode(state.PC + 2);
+		const Opcode jump = ReadOpcode(state.PC + 4);
+		const uint8_t skipType = skip >> 12;
+		if ((skipType != 0x3 && skipType != 0x4) || GetOpcodeNibble(skip, 1) != x || jump != (0x1000 | state.PC))
+			return 0;
+
+		const uint8_t nn = skip & 0xFF;
+		const bool skipsIfEqual = skipType == 0x3;
+		if ((state.delayTimer == nn) == skipsIfEqual)
+			return 0;
+
+		// Skip whole iterations, ending before the one in which the delay timer decrements, if it ever does
+		const uint32_t numIterationCycles = 3;
+		uint32_t numIterations = maxCycles / numIterationCycles;
+		if (state.delayTimer > 0)
+			numIterations = min(numIterations, (GetCyclesUntilTimerDecrement() - 1) / numIterationCycles);
+
+		if (numIterations == 0)
+			return 0;
+
+		state.vars[x] = state.delayTimer;
+		numSkipped = numIterations * numIterationCycles;
+	}
+
+	if (numSkipped == 0)
+		return 0;
+
+	HandleTimers(numSkipped);
+	skippedTime += numSkipped * NS_PER_SECOND / GetClockFrequency();
+	idle = true;
+
+	return numSkipped;
+}
+
+uint32_t Emulator::GetCyclesUntilTimerDecrement() const
+{
+	return (uint32_t)((GetClockFrequency() - state.timerAccumulator + TIMER_DECREMENT_FREQUENCY - 1) / TIMER_DECREMENT_FREQUENCY);
+}
+
+uint32_t Emulator::GetClockFrequency() const
+{
+	return instructionsPerSecond == UNLIMITED_INSTRUCTIONS_PER_SECOND ? OPCODES_FREQUENCY : instructionsPerSecond;
+}
+
+bool Emulator::SetExecutionMode(ExecutionMode mode)
+{
+	if (mode == ExecutionMode::Jit && !jit.Init())
+	{
+		cerr << "JIT is not supported on this host, keeping current execution mode" << endl;
+		return false;
+	}
+
+	if (mode == ExecutionMode::Compiled && compiledRom == nullptr)
+	{
+		cerr << "No compiled translation of '" << romPath << "' available, keeping current execution mode" << endl;
+		return false;
+	}
+
+	executionMode = mode;
+
+	return true;
 }
 
 bool Emulator::LoadROM()
 {
-	cout << "Loading '" << romPath << "'" << endl;
+	if (verbose)
+		cout << "Loading '" << romPath << "'" << endl;
 
 	// Open file
 	ifstream file(romPath, ios::binary | ios::ate);
@@ -78,14 +462,20 @@ bool Emulator::LoadROM()
 
 	// Get size, works due to ios::ate
 	streamsize fileSize = file.tellg();
+	if (fileSize < 0 || fileSize > (streamsize)MAX_ROM_SIZE)
+	{
+		cerr << "Error, 'ROM/" << romPath << "' doesn't fit in memory" << endl;
+		return false;
+	}
 
 	// Rewind
 	file.seekg(0, ios::beg);
 
 	// Reinterpret signed chars to unsigned chars, and start writing from PROGRAM_START in memory
-	if (file.read(reinterpret_cast<char*>(&memory[PROGRAM_START]), fileSize))
+	if (file.read(reinterpret_cast<char*>(&state.memory[PROGRAM_START]), fileSize))
 	{
-		cout << "Loaded ROM..." << endl;
+		if (verbose)
+			cout << "Loaded ROM..." << endl;
 	}
 	else
 	{
@@ -96,9 +486,29 @@ bool Emulator::LoadROM()
 	// Close up
 	file.close();
 
+	FindCompiledTranslation((size_t)fileSize);
+
 	return true;
 }
 
+void Emulator::FindCompiledTranslation(size_t romSize)
+{
+	if (romSize > MEMORY_SIZE - PROGRAM_START)
+		return;
+
+	// A resumed ROM which modified itself no longer matches its translation
+	romHash = HashRom(&state.memory[PROGRAM_START], romSize);
+	compiledRom = FindCompiledRom(&state.memory[PROGRAM_START], romSize);
+	if (compiledRom != nullptr)
+	{
+		if (verbose)
+			cout << "Found compiled translation '" << compiledRom->name << "'" << endl;
+
+		for (uint32_t i = 0; i < compiledRom->numCodeRanges; i++)
+			fill(compiledCode.begin() + compiledRom->codeRanges[i][0], compiledCode.begin() + compiledRom->codeRanges[i][1], true);
+	}
+}
+
 void Emulator::LoadFont()
 {
 	const vector<uint8_t> FONT_DATA
@@ -121,433 +531,598 @@ void Emulator::LoadFont()
 		0xF0, 0x80, 0xF0, 0x80, 0x80  // F
 	};
 
-	memcpy(&memory[FONT_START], FONT_DATA.data(), FONT_DATA.size());
+	memcpy(&state.memory[FONT_START], FONT_DATA.data(), FONT_DATA.size());
 }
 
-void Emulator::HandleKeyboard()
+void Emulator::HandleInput()
 {
-	const bool* keyState = SDL_GetKeyboardState(nullptr);
-	keys = 0;
-	
-	for (size_t i = 0; i < KEY_MAP.size(); i++)
-	{
-		SDL_Scancode scancode = KEY_MAP[i];
-		keys |= keyState[scancode] << i;
-	}
+	const uint16_t keys = input != nullptr ? input->GetKeys() : 0;
+	if (movie != nullptr && keys != state.keys)
+		movie->RecordKeys(state.cycles, keys);
+
+	state.keys = keys;
 }
 
-void Emulator::HandleTimers()
+void Emulator::HandleTimers(uint32_t numCycles)
 {
-	if (SDL_GetTicks() < nextTimerDecrementTime)
-		return;
+	// Emulated time, so the timers keep pace with the opcodes at any instruction rate
+	const uint32_t clockFrequency = GetClockFrequency();
 
-	if (delayTimer > 0)
-		delayTimer--;
+	state.timerAccumulator += (uint64_t)numCycles * TIMER_DECREMENT_FREQUENCY;
+	while (state.timerAccumulator >= clockFrequency)
+	{
+		state.timerAccumulator -= clockFrequency;
 
-	if (soundTimer > 0)
-		soundTimer--;
+		if (state.delayTimer > 0)
+			state.delayTimer--;
 
-	nextTimerDecrementTime = SDL_GetTicks() + (1000.f / TIMER_DECREMENT_FREQUENCY);
+		if (state.soundTimer > 0)
+			state.soundTimer--;
+	}
 }
 
 Opcode Emulator::Fetch()
 {
-	uint8_t opcodeA = memory[PC];
-	uint8_t opcodeB = memory[PC + 1];
+	Opcode opcode = ReadOpcode(state.PC);
 
-	PC += 2;
-
-	return (opcodeA << 8) + opcodeB;
+	state.PC += 2;
 
+	return opcode;
 }
 
-void Emulator::DecodeAndExecute(Opcode opcode)
+Opcode Emulator::ReadOpcode(uint16_t address) const
 {
-	uint8_t x = GetOpcodeNibble(opcode, 1);
-	uint8_t y = GetOpcodeNibble(opcode, 2);
-	uint8_t n = opcode & 0xF;
-	uint8_t nn = opcode & 0xFF;
-	uint16_t nnn = opcode & 0xFFF;
+	uint8_t opcodeA = state.memory[address & MEMORY_MASK];
+	uint8_t opcodeB = state.memory[(address + 1) & MEMORY_MASK];
 
-	switch (GetOpcodeNibble(opcode, 0))
-	{
-		case 0x0:
-		{	
-			switch (nnn)
-			{
-				// 00E0. Clears the screen.
-				case 0x0E0:
-				{
-					renderer->Clear();
-					break;
-				}
+	return (opcodeA << 8) + opcodeB;
+}
 
-				// 00EE. Returns from a subroutine.
-				case 0xEE:
-				{
-					PC = stack.top();
-					stack.pop();
-					break;
-				}
+void Emulator::Snapshot(MachineState& snapshot) const
+{
+	memcpy(&snapshot, &state, sizeof(MachineState));
+}
 
-				default:
-				{
-					printf("*** UNKNOWN CODE: %02X\n", opcode);
-					break;
-				}
-			}
+void Emulator::Restore(const MachineState& snapshot)
+{
+	// Only memory which differs can hold code that was decoded or translated differently, compared a word at a time
+	for (uint32_t address = 0; address < MEMORY_SIZE; address += sizeof(uint64_t))
+	{
+		uint64_t current;
+		uint64_t restored;
+		memcpy(&current, &state.memory[address], sizeof(current));
+		memcpy(&restored, &snapshot.memory[address], sizeof(restored));
 
-			break;
-		}
-		
-		// 1NNN. Jumps to address NNN
-		case 0x1:
+		uint64_t difference = current ^ restored;
+		while (difference != 0)
 		{
-			PC = nnn;
-			break;
+			const int shift = countr_zero(difference) & ~7;
+			InvalidateCode((uint16_t)(address + shift / 8));
+			difference &= ~(0xFFull << shift);
 		}
-		
-		// 2NNN. Calls subroutine at NNN
-		case 0x2:
+	}
+
+	memcpy(&state, &snapshot, sizeof(MachineState));
+	framebufferChanged = true;
+}
+
+void Emulator::SkipElapsedTime()
+{
+	if (clock != nullptr)
+		lastRunTime = clock->GetTicksNS();
+
+	cycleAccumulator = 0;
+	owedCycles = 0;
+}
+
+void Emulator::WriteMemory(uint16_t address, uint8_t value)
+{
+	address &= MEMORY_MASK;
+	state.memory[address] = value;
+	InvalidateCode(address);
+}
+
+void Emulator::InvalidateCode(uint16_t address)
+{
+	// Both the instruction starting at this byte and the one starting the byte before contain it
+	instructionCache[address].handler = &Emulator::DecodeIntoCache;
+	instructionCache[(address - 1) & MEMORY_MASK].handler = &Emulator::DecodeIntoCache;
+	jit.Invalidate(address);
+
+	// Self-modifying code, the ahead-of-time translation no longer matches memory
+	if (compiledRom != nullptr && compiledCode[address])
+	{
+		if (verbose)
+			cout << "ROM modified its own code, disabling compiled translation" << endl;
+
+		compiledRom = nullptr;
+	}
+}
+
+uint32_t Emulator::Step(uint32_t budget)
+{
+	switch (executionMode)
+	{
+		case ExecutionMode::Interpreter:
 		{
-			stack.push(PC);
-			PC = nnn;
-			break;
+			DecodeAndExecute(Fetch());
+			return 1;
 		}
 
-		// 3NNN. Skips the next instruction if VX equals NN
-		case 0x3:
+		case ExecutionMode::Jit:
 		{
-			if (vars[x] == nn)
+			if (state.PC < MEMORY_SIZE)
 			{
-				PC += 2;
+				const JitBlock& block = jit.GetBlock(state.PC, state.memory);
+				if (block.function != nullptr && block.numInstructions <= budget)
+				{
+					state.PC = block.function(state.vars, &state.I);
+					return block.numInstructions;
+				}
 			}
-			break;
+
+			// Untranslatable or too long, fall back to the threaded interpreter
+			[[fallthrough]];
 		}
 
-		// 4NNN. Skips the next instruction if VX does not equal NN
-		case 0x4:
+		case ExecutionMode::Compiled:
 		{
-			if (vars[x] != nn)
+			if (executionMode == ExecutionMode::Compiled && compiledRom != nullptr)
 			{
-				PC += 2;
+				uint32_t numExecuted = compiledRom->function(state.vars, state.I, state.PC, budget < COMPILED_STEP_BUDGET ? budget : COMPILED_STEP_BUDGET);
+				if (numExecuted > 0)
+					return numExecuted;
 			}
-			break;
+
+			// Not translated, fall back to the threaded interpreter
+			[[fallthrough]];
 		}
-		
-		// 5XY0. Skips the next instruction if VX equals VY
-		case 0x5:
+
+		case ExecutionMode::Threaded:
 		{
-			if (vars[x] == vars[y])
-			{
-				PC += 2;
-			}
-			break;
+			return StepThreaded(budget < THREADED_STEP_BUDGET ? budget : THREADED_STEP_BUDGET);
 		}
 
-		// 6XNN. Sets VX to NN
-		case 0x6:
+		case ExecutionMode::CachedInterpreter:
+		default:
 		{
-			vars[x] = nn;
-			break;
+			const Instruction& instruction = instructionCache[state.PC & MEMORY_MASK];
+			state.PC += 2;
+			instruction.handler(*this, instruction);
+			return 1;
 		}
-		
-		// 7XNN. Adds NN to VX (carry flag is not changed)
-		case 0x7:
+	}
+}
+
+uint32_t Emulator::StepProfiled()
+{
+	// Read before executing, as FX55 may overwrite the Opcode itself
+	const uint16_t address = state.PC & MEMORY_MASK;
+	const Opcode opcode = ReadOpcode(address);
+	const uint8_t kind = OPCODE_TABLE[opcode];
+	const uint16_t I = state.I;
+
+	const uint64_t start = Profiler::GetTicks();
+	const uint32_t numStepped = Step(1);
+	profiler->RecordOpcode(address, kind, Profiler::GetTicks() - start);
+	profiler->RecordRead(address, 2);
+
+	// Only these access memory besides fetching, all of them starting at I as it was before executing
+	const uint8_t x = GetOpcodeNibble(opcode, 1);
+	switch ((OpcodeIndex)kind)
+	{
+		case OpcodeIndex::OpDXYN:
 		{
-			vars[x] += nn;
+			profiler->RecordRead(I, GetOpcodeNibble(opcode, 3));
+			profiler->RecordDraw(state.vars[0xF] != 0);
 			break;
 		}
-		
-		case 0x8:
-		{
-			switch (n)
-			{
-				// 8XY0. Sets VX to the value of VY
-				case 0x0:
-				{
-					vars[x] = vars[y];
-					break;
-				}
 
-				// 8XY1. Sets VX to VX or VY. (bitwise OR operation)
-				case 0x1:
-				{
-					vars[x] |= vars[y];
-					break;
-				}
+		case OpcodeIndex::OpFX33: profiler->RecordWrite(I, 3); break;
+		case OpcodeIndex::OpFX55: profiler->RecordWrite(I, x + 1); break;
+		case OpcodeIndex::OpFX65: profiler->RecordRead(I, x + 1); break;
+		default: break;
+	}
 
-				// 8XY2. Sets VX to VX and VY. (bitwise AND operation)
-				case 0x2:
-				{
-					vars[x] &= vars[y];
-					break;
-				}
+	return numStepped;
+}
 
-				// 8XY3. Sets VX to VX xor VY.
-				case 0x3:
-				{
-					vars[x] ^= vars[y];
-					break;
-				}
+const char* Emulator::GetOpcodeName(uint8_t kind)
+{
+	return kind < NUM_OPCODE_KINDS ? OPCODE_NAMES[kind] : OPCODE_NAMES[(uint8_t)OpcodeIndex::OpUnknown];
+}
 
-				// 8XY4. Adds VY to VX. VF is set to 1 when there's an overflow, and to 0 when there is not.
-				case 0x4:
-				{
-					// Overflow handling
-					if (vars[x] + vars[y] > 255)
-						vars[0xF] = 1;
+void Emulator::DecodeAndExecute(Opcode opcode)
+{
+	const Instruction instruction = Decode(opcode);
+	instruction.handler(*this, instruction);
+}
 
-					vars[x] += vars[y];
+void Emulator::DecodeIntoCache(Emulator& emulator, const Instruction&)
+{
+	// The program counter has already moved past the Opcode we're decoding
+	const uint16_t address = (emulator.state.PC - 2) & MEMORY_MASK;
 
-					break;
-				}
+	Instruction& entry = emulator.instructionCache[address];
+	entry = Decode(emulator.ReadOpcode(address));
+	entry.handler(emulator, entry);
+}
 
-				// 8XY5. VY is subtracted from VX. VF is set to 0 when there's an underflow, and 1 when there is not. 
-				// (i.e. VF set to 1 if VX >= VY and 0 if not).
-				case 0x5:
-				{
-					// Underflow handling
-					vars[0xF] = vars[x] >= vars[y];
-					vars[x] = vars[x] - vars[y];
-					break;
-				}
+Instruction Emulator::Decode(Opcode opcode)
+{
+	Instruction instruction;
+	instruction.handler = OPCODE_HANDLERS[OPCODE_TABLE[opcode]];
+	instruction.opcode = opcode;
+	instruction.x = GetOpcodeNibble(opcode, 1);
+	instruction.y = GetOpcodeNibble(opcode, 2);
+	instruction.n = opcode & 0xF;
+	instruction.nn = opcode & 0xFF;
+	instruction.nnn = opcode & 0xFFF;
+
+	return instruction;
+}
+
+uint32_t Emulator::StepThreaded(uint32_t budget)
+{
+	uint32_t numExecuted = 0;
+
+#if defined(__GNUC__)
+	// One label per handler, each ending in its own copy of the dispatch
+	static void* const LABELS[] =
+	{
+#define CHIP8_LABEL(name) &&Label##name,
+		CHIP8_OPCODE_HANDLERS(CHIP8_LABEL)
+#undef CHIP8_LABEL
+	};
+
+	Instruction instruction;
+
+#define CHIP8_DISPATCH() \
+	if (numExecuted == budget) \
+		return numExecuted; \
+	instruction = Decode(ReadOpcode(state.PC)); \
+	if (numExecuted > 0 && IsTimerOpcode(instruction.opcode)) \
+		return numExecuted; \
+	state.PC += 2; \
+	numExecuted++; \
+	goto *LABELS[OPCODE_TABLE[instruction.opcode]]
+
+	CHIP8_DISPATCH();
+
+#define CHIP8_HANDLE(name) \
+	Label##name: \
+	name(*this, instruction); \
+	CHIP8_DISPATCH();
+
+	CHIP8_OPCODE_HANDLERS(CHIP8_HANDLE)
+
+#undef CHIP8_HANDLE
+#undef CHIP8_DISPATCH
+#else
+	// No computed gotos, still skip the switch by dispatching through the table
+	while (numExecuted < budget)
+	{
+		const Opcode opcode = ReadOpcode(state.PC);
+		if (numExecuted > 0 && IsTimerOpcode(opcode))
+			break;
+
+		state.PC += 2;
+		DecodeAndExecute(opcode);
+		numExecuted++;
+	}
+
+	return numExecuted;
+#endif
+}
+
+// 00E0. Clears the screen.
+void Emulator::Op00E0(Emulator& emulator, const Instruction&)
+{
+	emulator.state.framebuffer.Clear();
+	emulator.framebufferChanged = true;
+}
+
+// 00EE. Returns from a subroutine.
+void Emulator::Op00EE(Emulator& emulator, const Instruction&)
+{
+	MachineState& state = emulator.state;
+	state.stackPointer--;
+	state.PC = state.stack[state.stackPointer % MachineState::STACK_SIZE];
+}
+
+// 1NNN. Jumps to address NNN
+void Emulator::Op1NNN(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.PC = instruction.nnn;
+}
+
+// 2NNN. Calls subroutine at NNN
+void Emulator::Op2NNN(Emulator& emulator, const Instruction& instruction)
+{
+	MachineState& state = emulator.state;
+	state.stack[state.stackPointer % MachineState::STACK_SIZE] = state.PC;
+	state.stackPointer++;
+	state.PC = instruction.nnn;
+}
+
+// 3NNN. Skips the next instruction if VX equals NN
+void Emulator::Op3XNN(Emulator& emulator, const Instruction& instruction)
+{
+	if (emulator.state.vars[instruction.x] == instruction.nn)
+		emulator.state.PC += 2;
+}
+
+// 4NNN. Skips the next instruction if VX does not equal NN
+void Emulator::Op4XNN(Emulator& emulator, const Instruction& instruction)
+{
+	if (emulator.state.vars[instruction.x] != instruction.nn)
+		emulator.state.PC += 2;
+}
+
+// 5XY0. Skips the next instruction if VX equals VY
+void Emulator::Op5XY0(Emulator& emulator, const Instruction& instruction)
+{
+	if (emulator.state.vars[instruction.x] == emulator.state.vars[instruction.y])
+		emulator.state.PC += 2;
+}
+
+// 6XNN. Sets VX to NN
+void Emulator::Op6XNN(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] = instruction.nn;
+}
+
+// 7XNN. Adds NN to VX (carry flag is not changed)
+void Emulator::Op7XNN(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] += instruction.nn;
+}
+
+// 8XY0. Sets VX to the value of VY
+void Emulator::Op8XY0(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] = emulator.state.vars[instruction.y];
+}
+
+// 8XY1. Sets VX to VX or VY. (bitwise OR operation)
+void Emulator::Op8XY1(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] |= emulator.state.vars[instruction.y];
+}
+
+// 8XY2. Sets VX to VX and VY. (bitwise AND operation)
+void Emulator::Op8XY2(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] &= emulator.state.vars[instruction.y];
+}
+
+// 8XY3. Sets VX to VX xor VY.
+void Emulator::Op8XY3(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] ^= emulator.state.vars[instruction.y];
+}
+
+// 8XY4. Adds VY to VX. VF is set to 1 when there's an overflow, and to 0 when there is not.
+void Emulator::Op8XY4(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t* vars = emulator.state.vars;
+
+	// Overflow handling
+	if (vars[instruction.x] + vars[instruction.y] > 255)
+		vars[0xF] = 1;
+
+	vars[instruction.x] += vars[instruction.y];
+}
+
+// 8XY5. VY is subtracted from VX. VF is set to 0 when there's an underflow, and 1 when there is not. 
+// (i.e. VF set to 1 if VX >= VY and 0 if not).
+void Emulator::Op8XY5(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t* vars = emulator.state.vars;
+
+	// Underflow handling
+	vars[0xF] = vars[instruction.x] >= vars[instruction.y];
+	vars[instruction.x] = vars[instruction.x] - vars[instruction.y];
+}
+
+// 8XY6. Shifts VX to the right by 1, then stores the least significant bit of VX prior to the shift into VF.
+void Emulator::Op8XY6(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t* vars = emulator.state.vars;
 
-				// 8XY6. Shifts VX to the right by 1, then stores the least significant bit of VX prior to the shift into VF.
-				case 0x6:
-				{
 #ifdef CHIP8_ORIGINAL
-					vars[x] = vars[y];
+	vars[instruction.x] = vars[instruction.y];
 #endif
-					uint8_t shiftedBit = vars[x] & 0x1;
-					vars[x] = vars[x] >> 1;
-					vars[0xF] = shiftedBit;
-					break;
-				}
+	uint8_t shiftedBit = vars[instruction.x] & 0x1;
+	vars[instruction.x] = vars[instruction.x] >> 1;
+	vars[0xF] = shiftedBit;
+}
 
-				// 8XY7. Sets VX to VY minus VX. VF is set to 0 when there's an underflow, and 1 when there is not. 
-				// (i.e. VF set to 1 if VY >= VX).
-				case 0x7:
-				{
-					vars[0xF] = vars[y] >= vars[x];
-					vars[x] = vars[y] - vars[x];
-				}
-					break;
+// 8XY7. Sets VX to VY minus VX. VF is set to 0 when there's an underflow, and 1 when there is not. 
+// (i.e. VF set to 1 if VY >= VX).
+void Emulator::Op8XY7(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t* vars = emulator.state.vars;
+
+	vars[0xF] = vars[instruction.y] >= vars[instruction.x];
+	vars[instruction.x] = vars[instruction.y] - vars[instruction.x];
+}
+
+// 8XYE. Shifts VX to the left by 1, then sets VF to 1 if the most significant bit of VX prior to that 
+// shift was set, or to 0 if it was unset.
+void Emulator::Op8XYE(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t* vars = emulator.state.vars;
 
-				// 8XYE. Shifts VX to the left by 1, then sets VF to 1 if the most significant bit of VX prior to that 
-				// shift was set, or to 0 if it was unset.
-				case 0xE:
-				{
 #ifdef CHIP8_ORIGINAL
-					vars[x] = vars[y];
+	vars[instruction.x] = vars[instruction.y];
 #endif
-					uint8_t shiftedBit = vars[x] >> 7;
-					vars[x] = vars[x] << 1;
-					vars[0xF] = shiftedBit;
-					break;
-				}
-				default:
-				{
-					printf("*** UNKNOWN CODE: %02X\n", opcode);
-					break;
-				}
-			}
-			break;
-		}
-		
-		// 9XY0. Skips the next instruction if VX does not equal VY.
-		case 0x9:
-		{
-			if (vars[x] != vars[y])
-				PC += 2;
+	uint8_t shiftedBit = vars[instruction.x] >> 7;
+	vars[instruction.x] = vars[instruction.x] << 1;
+	vars[0xF] = shiftedBit;
+}
 
-			break;
-		}
-		
-		// ANNN. Sets I to the address NNN.
-		case 0xA:
-		{
-			I = nnn;
-			break;
-		}
-		
-		// BNNN. Jumps to the address NNN plus V0.
-		case 0xB:
-		{
+// 9XY0. Skips the next instruction if VX does not equal VY.
+void Emulator::Op9XY0(Emulator& emulator, const Instruction& instruction)
+{
+	if (emulator.state.vars[instruction.x] != emulator.state.vars[instruction.y])
+		emulator.state.PC += 2;
+}
+
+// ANNN. Sets I to the address NNN.
+void Emulator::OpANNN(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.I = instruction.nnn;
+}
+
+// BNNN. Jumps to the address NNN plus V0.
+void Emulator::OpBNNN(Emulator& emulator, const Instruction& instruction)
+{
 #ifdef CHIP8_ORIGINAL
-			I = nnn + vars[0];
+	emulator.state.I = instruction.nnn + emulator.state.vars[0];
 #else
-			I = nnn + vars[x];
+	emulator.state.I = instruction.nnn + emulator.state.vars[instruction.x];
 #endif
-			break;
-		}
-		
-		// CXNN. Sets VX to the result of a bitwise and operation on a random number (Typically: 0 to 255) and NN.
-		case 0xC:
-		{
-			vars[x] = (rand() % 256) & nn;
-			break;
-		}
-		
-		// DXYN. Draws a sprite at coordinate (VX, VY).
-		case 0xD:
-		{
-			renderer->Display(vars[x], vars[y], n, I, memory, vars);
-			break;
-		}
-		
-		// Key handling
-		case 0xE:
-		{
-			switch (nn)
-			{
-				// EX9E. Skips the next instruction if the key stored in VX(only consider the lowest nibble) is 
-				// pressed (usually the next instruction is a jump to skip a code block).
-				case 0x9E:
-				{
-					uint16_t mask = 1 << vars[x];
-					if (keys & mask)
-						PC += 2;
+}
 
-					break;
-				}
+// CXNN. Sets VX to the result of a bitwise and operation on a random number (Typically: 0 to 255) and NN.
+void Emulator::OpCXNN(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] = (emulator.Random() >> 24) & instruction.nn;
+}
 
-				// EXA1. Skips the next instruction if the key stored in VX(only consider the lowest nibble) is 
-				// not pressed (usually the next instruction is a jump to skip a code block).
-				case 0xA1:
-				{
-					uint16_t mask = 1 << vars[x];
-					if (!(keys & mask))
-						PC += 2;
+// DXYN. Draws a sprite at coordinate (VX, VY).
+void Emulator::OpDXYN(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t* vars = emulator.state.vars;
+	vars[0xF] = emulator.state.framebuffer.Draw(vars[instruction.x], vars[instruction.y], instruction.n, emulator.state.I, emulator.state.memory);
+	emulator.framebufferChanged = true;
+}
 
-					break;
-				}
+// EX9E. Skips the next instruction if the key stored in VX(only consider the lowest nibble) is 
+// pressed (usually the next instruction is a jump to skip a code block).
+void Emulator::OpEX9E(Emulator& emulator, const Instruction& instruction)
+{
+	uint16_t mask = 1 << (emulator.state.vars[instruction.x] & 0xF);
+	if (emulator.state.keys & mask)
+		emulator.state.PC += 2;
+}
 
-				default:
-				{
-					printf("*** UNKNOWN CODE: %02X\n", opcode);
-					break;
-				}
-			}
+// EXA1. Skips the next instruction if the key stored in VX(only consider the lowest nibble) is 
+// not pressed (usually the next instruction is a jump to skip a code block).
+void Emulator::OpEXA1(Emulator& emulator, const Instruction& instruction)
+{
+	uint16_t mask = 1 << (emulator.state.vars[instruction.x] & 0xF);
+	if (!(emulator.state.keys & mask))
+		emulator.state.PC += 2;
+}
 
-			break;
-		}
+// FX07. Sets VX to the value of the delay timer.
+void Emulator::OpFX07(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.vars[instruction.x] = emulator.state.delayTimer;
+}
 
-		case 0xF:
-		{
-			switch (nn)
-			{
-				// FX07. Sets VX to the value of the delay timer.
-				case 0x07:
-				{
-					vars[x] = delayTimer;
-					break;
-				}
+// FX0A. A key press is awaited, and then stored in VX (blocking operation, all instruction halted 
+// until next key event, delay and sound timers should continue processing).
+void Emulator::OpFX0A(Emulator& emulator, const Instruction& instruction)
+{
+	if (!emulator.state.keys)
+		emulator.state.PC -= 2;
+	else
+		emulator.state.vars[instruction.x] = countr_zero(emulator.state.keys);
+}
 
-				// FX0A. A key press is awaited, and then stored in VX (blocking operation, all instruction halted 
-				// until next key event, delay and sound timers should continue processing).
-				case 0x0A:
-				{
-					if (!keys)
-						PC -= 2;
-					else
-						vars[x] = countr_zero(keys);
-					break;
-				}
+// FX15. Sets the delay timer to VX.
+void Emulator::OpFX15(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.delayTimer = emulator.state.vars[instruction.x];
+}
 
-				// FX15. Sets the delay timer to VX.
-				case 0x15:
-				{
-					delayTimer = vars[x];
-					break;
-				}
+// FX18. Sets the sound timer to VX.
+void Emulator::OpFX18(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.soundTimer = emulator.state.vars[instruction.x];
+	if (emulator.audio != nullptr && !emulator.speculating)
+		emulator.audio->StartBeep(emulator.state.vars[instruction.x] * (1000 / TIMER_DECREMENT_FREQUENCY));
+}
 
-				// FX18. Sets the sound timer to VX.
-				case 0x18:
-				{
-					soundTimer = vars[x];
-					sound->StartBeep(vars[x] * (1000 / TIMER_DECREMENT_FREQUENCY));
-					break;
-				}
-			
-				// FX1E. Adds VX to I. VF is not affected
-				case 0x1E:
-				{
-					I += vars[x];
-					break;
-				}
+// FX1E. Adds VX to I. VF is not affected
+void Emulator::OpFX1E(Emulator& emulator, const Instruction& instruction)
+{
+	emulator.state.I += emulator.state.vars[instruction.x];
+}
 
-				// FX29. Sets I to the location of the sprite for the character in VX(only consider the lowest nibble). 
-				// Characters 0-F (in hexadecimal) are represented by a 4x5 font.
-				case 0x29:
-				{
-					uint8_t characterIndex = memory[x] & 0xF; // Only grab last nibble
-					characterIndex *= (uint8_t)(0xFF * 0x5); // Get the right offset in memory
-					I = memory[FONT_START + characterIndex];
-					break;
-				}
+// FX29. Sets I to the location of the sprite for the character in VX(only consider the lowest nibble). 
+// Characters 0-F (in hexadecimal) are represented by a 4x5 font.
+void Emulator::OpFX29(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t characterIndex = emulator.state.memory[instruction.x] & 0xF; // Only grab last nibble
+	characterIndex *= (uint8_t)(0xFF * 0x5); // Get the right offset in memory
+	emulator.state.I = emulator.state.memory[FONT_START + characterIndex];
+}
 
-				// FX33. Stores the binary-coded decimal representation of VX, with the hundreds digit in memory at 
-				// location in I, the tens digit at location I+1, and the ones digit at location I+2.
-				case 0x33:
-				{
-					uint8_t var = vars[x];
-					uint8_t ones = var % 10;
-					var /= 10;
-					uint8_t tens = var % 10;
-					var /= 10;
-					uint8_t hundreds = var % 10;
-
-					memory[I] = hundreds;
-					memory[I + 1] = tens;
-					memory[I + 2] = ones;
-
-					break;
-				}
+// FX33. Stores the binary-coded decimal representation of VX, with the hundreds digit in memory at 
+// location in I, the tens digit at location I+1, and the ones digit at location I+2.
+void Emulator::OpFX33(Emulator& emulator, const Instruction& instruction)
+{
+	uint8_t var = emulator.state.vars[instruction.x];
+	uint8_t ones = var % 10;
+	var /= 10;
+	uint8_t tens = var % 10;
+	var /= 10;
+	uint8_t hundreds = var % 10;
+
+	emulator.WriteMemory(emulator.state.I, hundreds);
+	emulator.WriteMemory(emulator.state.I + 1, tens);
+	emulator.WriteMemory(emulator.state.I + 2, ones);
+}
 
-				// FX55. Stores from V0 to VX (including VX) in memory, starting at address I. The offset from I is 
-				// increased by 1 for each value written, but I itself is left unmodified.
-				case 0x55:
-				{
-					for (uint8_t i = 0; i <= x; i++)
+// FX55. Stores from V0 to VX (including VX) in memory, starting at address I. The offset from I is 
+// increased by 1 for each value written, but I itself is left unmodified.
+void Emulator::OpFX55(Emulator& emulator, const Instruction& instruction)
+{
+	for (uint8_t i = 0; i <= instruction.x; i++)
 #ifdef CHIP8_ORIGINAL
-						memory[I++] = vars[i];
+		emulator.WriteMemory(emulator.state.I++, emulator.state.vars[i]);
 #else
-						memory[I + i] = vars[i];
+		emulator.WriteMemory(emulator.state.I + i, emulator.state.vars[i]);
 #endif
+}
 
-					break;
-				}
-
-				// FX65. Fills from V0 to VX (including VX) with values from memory, starting at address I. The offset 
-				// from I is increased by 1 for each value read, but I itself is left unmodified.
-				case 0x65:
-				{
-					for (uint8_t i = 0; i <= x; i++)
+// FX65. Fills from V0 to VX (including VX) with values from memory, starting at address I. The offset 
+// from I is increased by 1 for each value read, but I itself is left unmodified.
+void Emulator::OpFX65(Emulator& emulator, const Instruction& instruction)
+{
+	for (uint8_t i = 0; i <= instruction.x; i++)
 #ifdef CHIP8_ORIGINAL
-						vars[i] = memory[I++];
+		emulator.state.vars[i] = emulator.state.memory[emulator.state.I++ & MEMORY_MASK];
 #else
-						vars[i] = memory[I + i];
+		emulator.state.vars[i] = emulator.state.memory[(emulator.state.I + i) & MEMORY_MASK];
 #endif
+}
 
-					break;
-				}
+void Emulator::OpUnknown(Emulator& emulator, const Instruction& instruction)
+{
+	if (emulator.verbose)
+		printf("*** UNKNOWN CODE: %02X\n", instruction.opcode);
+}
 
-				default:
-				{
-					printf("*** UNKNOWN CODE: %02X\n", opcode);
-					break;
-				}
-			}
-			break;
-		}
+uint32_t Emulator::Random()
+{
+	// xorshift32, its whole state fits in MachineState
+	uint32_t x = state.randomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	state.randomState = x;
+
+	return x;
+}
 
-		default:
-		{
-			printf("*** UNKNOWN CODE: %02X\n", opcode);
-			break;
-		}
-	}
+bool Emulator::IsTimerOpcode(Opcode opcode)
+{
+	return (opcode & 0xF0FF) == 0xF007 || (opcode & 0xF0FF) == 0xF015 || (opcode & 0xF0FF) == 0xF018;
 }
 
 uint8_t Emulator::GetOpcodeNibble(Opcode opcode, int nibbleIndex)
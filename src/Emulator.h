@@ -4,22 +4,59 @@
 // Includes
 #include <string>
 #include <vector>
-#include <stack>
+#include "Jit.h"
+#include "MachineState.h"
 
 // Forward declarations
-class Renderer;
-class Sound;
-enum SDL_Scancode;
+class DisplaySink;
+class AudioSink;
+class InputSource;
+class Clock;
+class Emulator;
+struct Instruction;
+struct CompiledRom;
+class Movie;
+class Profiler;
 
 // Usings
 using Opcode = uint16_t;
+using OpcodeHandler = void (*)(Emulator& emulator, const Instruction& instruction);
 using namespace std;
 
+/**
+ * @brief A pre-decoded Opcode: the handler executing it, plus all of its operands already extracted.
+ */
+struct Instruction
+{
+	OpcodeHandler handler = nullptr;	///< Static Emulator method executing this instruction.
+	Opcode opcode = 0;					///< The raw Opcode this instruction was decoded from.
+	uint16_t nnn = 0;					///< Lowest 12 bits of the Opcode, typically an address.
+	uint8_t x = 0;						///< Second nibble of the Opcode, typically a register index.
+	uint8_t y = 0;						///< Third nibble of the Opcode, typically a register index.
+	uint8_t n = 0;						///< Lowest nibble of the Opcode.
+	uint8_t nn = 0;						///< Lowest byte of the Opcode.
+};
+
+/**
+ * @brief The ways in which the Emulator can execute opcodes, selectable at runtime so they can be compared.
+ */
+enum class ExecutionMode
+{
+	Interpreter,		///< Fetches and decodes every Opcode on each execution.
+	CachedInterpreter,	///< Decodes each memory location once, reusing the Instruction until that memory is written to.
+	Threaded,			///< Fetches every Opcode, dispatching runs of them as threaded code where computed gotos are supported.
+	Jit,				///< Translates basic blocks into native code, interpreting whatever can't be translated.
+	Compiled,			///< Runs the ROM's ahead-of-time translation by chip8rc, interpreting whatever isn't translated.
+};
+
 /**
  * @brief Emulator is responsible for loading and running CHIP-8 ROMs.
  * 
  * CHIP-8 ROM files consist of nothing but instructions which are dealt with during the Run() method. During a Run() we 
- * update our timers, handle input and handle our opcodes. This class works hand in hand with Renderer and Sound.
+ * update our timers, handle input and handle our opcodes. The Emulator doesn't depend on SDL or any other platform
+ * layer: it presents its Framebuffer to a DisplaySink, beeps through an AudioSink, polls an InputSource for keys and
+ * tells time by a Clock. In the application these are Renderer, Sound and Keyboard, while headless runs can leave them
+ * out entirely.
  */
 class Emulator 
 {
@@ -27,22 +64,230 @@ public:
 	/**
 	 * @brief Constructor
 	 * @param romPath Path to the ROM this Emulator instance should run.
-	 * @param renderer The Renderer we use to draw the visual part of our emulation.
-	 * @param sound The Sound instance, used to play audio for aural part of our emulation.
+	 * @param display The DisplaySink frames are presented to, or nullptr.
+	 * @param audio The AudioSink used to play the aural part of our emulation, or nullptr.
+	 * @param input The InputSource keys are polled from, or nullptr if no keys are ever pressed.
+	 * @param clock The Clock Run() tells time by, or nullptr if only RunCycles() is used.
 	 */
-	Emulator(const string romPath, Renderer* renderer, Sound* sound);
+	Emulator(const string romPath, DisplaySink* display, AudioSink* audio, InputSource* input, Clock* clock);
 
 	/**
 	 * @brief Initializes the Emulator, loading our ROM and font data into memory.
 	 * @return Returns false if initialization fails.
 	 */
 	bool Init();
+
+	/**
+	 * @brief Initializes the Emulator from a ROM already in memory, such as input generated by a fuzzer, loading it and
+	 * our font data into memory.
+	 * @param rom The ROM's bytes, or nullptr if romSize is 0.
+	 * @param romSize Size of the ROM in bytes, at most MAX_ROM_SIZE.
+	 * @return Returns false if the ROM doesn't fit in memory.
+	 */
+	bool Init(const uint8_t* rom, size_t romSize);
+
+	/**
+	 * @brief Initializes the Emulator from a MachineState saved by an earlier run of the same ROM, instead of loading
+	 * the ROM and font data, which are already part of it.
+	 * @param snapshot The MachineState to resume.
+	 * @param romSize Size of the ROM in bytes, to find its compiled translation by.
+	 */
+	void Resume(const MachineState& snapshot, size_t romSize);
 	
 	/**
-	 * @brief A single Run() cycle handles keyboard input, updates timers, and handles an opcode on a specific frequency.
+	 * @brief A single Run() cycle handles keyboard input, then executes all opcodes owed since the previous Run() in a
+	 * single batch, updating the timers as emulated time passes.
 	 */
 	void Run();
 
+	/**
+	 * @brief Sets the rate at which opcodes are executed.
+	 * @param instructionsPerSecond Number of opcodes to execute per second, or UNLIMITED_INSTRUCTIONS_PER_SECOND to
+	 * execute as many as possible, in which case the timers are derived from OPCODES_FREQUENCY.
+	 */
+	void SetInstructionsPerSecond(uint32_t instructionsPerSecond);
+
+	/**
+	 * @brief Executes opcodes as fast as possible, regardless of the instruction rate, until at least a given number
+	 * of them have been executed. The timers are updated along the way, input isn't polled and nothing is presented.
+	 * @param numCycles Number of opcodes to execute.
+	 * @return Returns the number of opcodes executed, exactly numCycles.
+	 */
+	uint32_t RunCycles(uint32_t numCycles);
+
+	/**
+	 * @brief Gets the Framebuffer the ROM draws to.
+	 * @return Returns the current Framebuffer.
+	 */
+	const Framebuffer& GetFramebuffer() const { return state.framebuffer; }
+
+	/**
+	 * @brief Copies the complete MachineState, which is a single memcpy.
+	 * @param snapshot The MachineState to copy into.
+	 */
+	void Snapshot(MachineState& snapshot) const;
+
+	/**
+	 * @brief Replaces the complete MachineState with an earlier snapshot, which is a single memcpy. Decoded and
+	 * translated code is only invalidated where the restored memory differs, and the Framebuffer is presented again.
+	 * @param snapshot The MachineState to restore.
+	 */
+	void Restore(const MachineState& snapshot);
+
+	/**
+	 * @brief Gets the complete MachineState, without copying it.
+	 * @return Returns the current MachineState.
+	 */
+	const MachineState& GetState() const { return state; }
+
+	/**
+	 * @brief Forgets the host time passed since the previous Run(), so the next Run() doesn't catch up on it. For when
+	 * the Emulator deliberately wasn't run for a while, such as while rewinding.
+	 */
+	void SkipElapsedTime();
+
+	/**
+	 * @brief Seeds the random number generator behind CXNN, which is otherwise seeded by the time of construction.
+	 * @param seed The new state of the generator, 0 being replaced by 1 as xorshift would never leave it.
+	 */
+	void SetSeed(uint32_t seed) { state.randomState = seed != 0 ? seed : 1; }
+
+	/**
+	 * @brief Sets the keys being pressed, for when the Emulator is driven by RunCycles() rather than an InputSource.
+	 * @param keys Bitset of keys being pressed, ranging from [0xF..0x0].
+	 */
+	void SetKeys(uint16_t keys) { state.keys = keys; }
+
+	/**
+	 * @brief Records every change of the keys polled from the InputSource into a Movie from now on.
+	 * @param movie The Movie to record into, or nullptr to stop recording.
+	 */
+	void SetMovie(Movie* movie) { this->movie = movie; }
+
+	/**
+	 * @brief Gets the hash of the loaded ROM, as computed by HashRom().
+	 * @return Returns the hash.
+	 */
+	uint64_t GetRomHash() const { return romHash; }
+
+	/**
+	 * @brief Gets the rate of the emulated clock the timers are derived from.
+	 * @return Returns instructionsPerSecond, or OPCODES_FREQUENCY when running at an unlimited rate.
+	 */
+	uint32_t GetClockFrequency() const;
+
+	static const uint32_t OPCODES_FREQUENCY = 700;					///< Default number of opcodes that should be handled per second.
+	static const uint32_t UNLIMITED_INSTRUCTIONS_PER_SECOND = 0;	///< Instruction rate which runs the Emulator as fast as possible.
+	static const uint32_t PROGRAM_START = 0x200;					///< Start point in memory where ROM data is copied to.
+	static const uint32_t MAX_ROM_SIZE = MachineState::MEMORY_SIZE - PROGRAM_START;	///< Size of the largest ROM which fits in memory.
+	static const uint32_t NUM_OPCODE_KINDS = 35;					///< Number of kinds of Opcode, one per handler, including unknown ones.
+	static const uint32_t COVERAGE_KIND_BITS = 6;					///< Low bits of a coverage counter's index holding the kind of Opcode.
+	static const uint32_t COVERAGE_SIZE = MachineState::MEMORY_SIZE << COVERAGE_KIND_BITS;	///< Number of counters SetCoverage() expects, one per address and kind.
+
+	/**
+	 * @brief Gets the name of a kind of Opcode, as in https://en.wikipedia.org/wiki/CHIP-8#Opcode_table.
+	 * @param kind Kind of Opcode, in [0..NUM_OPCODE_KINDS).
+	 * @return Returns the name, such as "8XY4", or "Unknown".
+	 */
+	static const char* GetOpcodeName(uint8_t kind);
+
+	/**
+	 * @brief Whether the most recent Run() found the ROM idling, ie. spinning in a loop which only the timers or input
+	 * can break out of.
+	 * @return Returns true if cycles were skipped during the most recent Run().
+	 */
+	bool IsIdle() const { return idle; }
+
+	/**
+	 * @brief Gets the total amount of emulated time fast-forwarded through idle loops, rather than executed.
+	 * @return Returns the skipped time in nanoseconds.
+	 */
+	uint64_t GetSkippedTimeNS() const { return skippedTime; }
+
+	/**
+	 * @brief Sets whether idle loops are fast-forwarded through, or executed opcode by opcode like any other, such as when
+	 * measuring how fast opcodes are dispatched.
+	 * @param skipIdleLoops Whether to skip idle loops, true by default.
+	 */
+	void SetSkipIdleLoops(bool skipIdleLoops) { this->skipIdleLoops = skipIdleLoops; }
+
+	/**
+	 * @brief Sets how many frames Run() emulates ahead of the actual MachineState, to present the outcome of input
+	 * that many frames early. Every host frame the MachineState is snapshot, the frames are emulated with the keys
+	 * currently pressed, the result is presented, and the snapshot is restored. Ignored at an unlimited rate.
+	 * @param runAheadFrames Number of frames to run ahead, 0 to present the actual MachineState.
+	 */
+	void SetRunAheadFrames(uint32_t runAheadFrames) { this->runAheadFrames = runAheadFrames; }
+
+	/**
+	 * @brief Marks the opcodes executed from now on as speculative, such as frames simulated again after a rollback,
+	 * so they don't have effects outside the MachineState, like beeping.
+	 * @param speculating Whether opcodes are executed speculatively.
+	 */
+	void SetSpeculating(bool speculating) { this->speculating = speculating; }
+
+	/**
+	 * @brief Sets whether progress, such as loading the ROM, and unknown opcodes are logged. Errors loading the ROM are
+	 * logged regardless.
+	 * @param verbose Whether to log progress, true by default.
+	 */
+	void SetVerbose(bool verbose) { this->verbose = verbose; }
+
+	/**
+	 * @brief Counts how often every address executes every kind of Opcode from now on, such as for coverage-guided
+	 * fuzzing. Every Step() counts the Opcode at the program counter, which is every Opcode in ExecutionMode::Interpreter
+	 * and ExecutionMode::CachedInterpreter but only the first of a block or run in the others.
+	 * @param coverage COVERAGE_SIZE counters, saturating at 0xFF and indexed by the address shifted left by
+	 * COVERAGE_KIND_BITS, or'ed with the kind. Or nullptr to stop counting.
+	 */
+	void SetCoverage(uint8_t* coverage);
+
+	/**
+	 * @brief Gets the index of every coverage counter which went from 0 to 1 since the last ClearCoverage(), so a run
+	 * can be merged at the cost of what it covered rather than of all counters.
+	 * @return Returns the indices, in the order they were first counted.
+	 */
+	const vector<uint32_t>& GetTouchedCoverage() const { return touchedCoverage; }
+
+	/**
+	 * @brief Zeroes only the coverage counters touched since the last call, and forgets about them.
+	 */
+	void ClearCoverage();
+
+	/**
+	 * @brief Profiles every Opcode executed from now on. This executes them one at a time whatever the ExecutionMode, so
+	 * every one is counted, but Jit blocks and runs of more than one Opcode aren't taken while profiling. Opcodes skipped
+	 * through idle loops are only counted as skipped.
+	 * @param profiler The Profiler, or nullptr to stop profiling and take the usual path again.
+	 */
+	void SetProfiler(Profiler* profiler) { this->profiler = profiler; }
+
+	/**
+	 * @brief Gets the total host time spent in Run(), including running ahead.
+	 * @return Returns the time in nanoseconds.
+	 */
+	uint64_t GetRunTimeNS() const { return runTime; }
+
+	/**
+	 * @brief Gets the total host time spent running ahead, which is the extra cost of doing so.
+	 * @return Returns the time in nanoseconds.
+	 */
+	uint64_t GetRunAheadTimeNS() const { return runAheadTime; }
+
+	/**
+	 * @brief Selects how opcodes are executed from now on.
+	 * @param mode The ExecutionMode to use.
+	 * @return Returns false if the mode isn't supported on this host, or for ExecutionMode::Compiled when no translation
+	 * of the loaded ROM was linked in. In both cases the current mode is kept.
+	 */
+	bool SetExecutionMode(ExecutionMode mode);
+
+	/**
+	 * @brief Gets the ExecutionMode currently in use.
+	 * @return Returns the current ExecutionMode.
+	 */
+	ExecutionMode GetExecutionMode() const { return executionMode; }
+
 private:
 	/**
 	 * @brief Tries to load a ROM from romPath.
@@ -56,14 +301,48 @@ private:
 	void LoadFont();
 
 	/**
-	 * @brief Sets the correct bits for keys, based on KEY_MAP.
+	 * @brief Hashes the ROM in memory, then looks for an ahead-of-time translation of it and marks the memory its code
+	 * covers.
+	 * @param romSize Size of the ROM in bytes.
+	 */
+	void FindCompiledTranslation(size_t romSize);
+
+	/**
+	 * @brief Polls the InputSource for the keys being pressed.
+	 */
+	void HandleInput();
+
+	/**
+	 * @brief Updates the delay timer and sound timer, decrementing them at TIMER_DECREMENT_FREQUENCY in emulated time.
+	 * @param numCycles Number of opcodes executed since the previous call.
+	 */
+	void HandleTimers(uint32_t numCycles);
+
+	/**
+	 * @brief Recognizes idle loops starting at the program counter, and fast-forwards through them. These are 1NNN jumping
+	 * to itself, FX0A waiting while no key is pressed, and FX07 polling loops (FX07, 3XNN or 4XNN, 1NNN back to FX07)
+	 * waiting for the delay timer. The latter are only skipped up to the next timer decrement.
+	 * @param maxCycles Maximum number of opcodes to skip.
+	 * @return Returns the number of opcodes skipped, having the same effect as executing them.
+	 */
+	uint32_t SkipIdleLoop(uint32_t maxCycles);
+
+	/**
+	 * @brief Counts the Opcode at an address in the coverage counters.
+	 * @param address The address of the Opcode's first byte.
 	 */
-	void HandleKeyboard();
+	void RecordCoverage(uint16_t address);
 
 	/**
-	 * @brief Updates the delay timer and sound timer. 
+	 * @brief Emulates runAheadFrames frames, presents the result and restores the MachineState from before.
 	 */
-	void HandleTimers();
+	void RunAhead();
+
+	/**
+	 * @brief Gets the number of opcodes left until the timers are next decremented.
+	 * @return Returns the number of opcodes, at least 1.
+	 */
+	uint32_t GetCyclesUntilTimerDecrement() const;
 
 	/**
 	 * @brief Fetches the currently relevant Opcode and increments the instruction pointer.
@@ -71,13 +350,126 @@ private:
 	 */
 	Opcode Fetch();
 
+	/**
+	 * @brief Reads the Opcode located at a specific address, without touching the program counter.
+	 * @param address The address of the Opcode's first byte.
+	 * @return The Opcode at the given address.
+	 */
+	Opcode ReadOpcode(uint16_t address) const;
+
+	/**
+	 * @brief Writes a byte to memory, invalidating any cached Instruction that byte is part of.
+	 * @param address The address to write to, wrapping around the end of memory.
+	 * @param value The value to write.
+	 */
+	void WriteMemory(uint16_t address, uint8_t value);
+
+	/**
+	 * @brief Invalidates any cached Instruction, Jit block or compiled translation a byte of memory is part of, as it's
+	 * about to change.
+	 * @param address The address of the byte, within memory.
+	 */
+	void InvalidateCode(uint16_t address);
+
+	/**
+	 * @brief Executes the Opcode at the program counter, using the current ExecutionMode. When using the Jit, this
+	 * executes an entire block, unless it's longer than the budget.
+	 * @param budget Maximum number of opcodes to execute, at least 1.
+	 * @return Returns the number of opcodes executed.
+	 */
+	uint32_t Step(uint32_t budget);
+
+	/**
+	 * @brief Executes a single Opcode through Step(), counting it, the memory it accessed and the sprite it drew in the
+	 * Profiler. Kept apart from Step() so none of this costs anything without a Profiler.
+	 * @return Returns the number of opcodes executed.
+	 */
+	uint32_t StepProfiled();
+
+	/**
+	 * @brief Executes up to budget opcodes back to back, fetching each one from memory. On compilers supporting computed
+	 * gotos every opcode handler is inlined and ends in its own dispatch to the next, rather than all of them sharing
+	 * a single, hard to predict, indirect branch. Opcodes accessing the delay timer end the run before them, so they only
+	 * ever execute first, once the timers have caught up with all opcodes before them.
+	 * @param budget Maximum number of opcodes to execute.
+	 * @return Returns the number of opcodes executed.
+	 */
+	uint32_t StepThreaded(uint32_t budget);
+
 	/**
 	 * @brief Core of the emulation process. It deals with the given Opcode, and acts accordingly. An overview of all
 	 * opcodes can be found on https://en.wikipedia.org/wiki/CHIP-8#Opcode_table.
 	 * @param opcode The Opcode which should be handled.
 	 */
 	void DecodeAndExecute(Opcode opcode);
+
+	/**
+	 * @brief Decodes an Opcode into an Instruction, looking up its handler in OPCODE_TABLE and extracting its operands.
+	 * @param opcode The Opcode to decode.
+	 * @return The decoded Instruction.
+	 */
+	static Instruction Decode(Opcode opcode);
+
+	/**
+	 * @brief Handler of every invalid instructionCache entry. Decodes the Opcode the program counter just moved past,
+	 * stores it in the instructionCache and executes it.
+	 * @param emulator The Emulator executing the instruction.
+	 * @param instruction The invalid cache entry.
+	 */
+	static void DecodeIntoCache(Emulator& emulator, const Instruction& instruction);
+
+	// Opcode handlers, one per Opcode listed on https://en.wikipedia.org/wiki/CHIP-8#Opcode_table.
+	static void Op00E0(Emulator& emulator, const Instruction& instruction);
+	static void Op00EE(Emulator& emulator, const Instruction& instruction);
+	static void Op1NNN(Emulator& emulator, const Instruction& instruction);
+	static void Op2NNN(Emulator& emulator, const Instruction& instruction);
+	static void Op3XNN(Emulator& emulator, const Instruction& instruction);
+	static void Op4XNN(Emulator& emulator, const Instruction& instruction);
+	static void Op5XY0(Emulator& emulator, const Instruction& instruction);
+	static void Op6XNN(Emulator& emulator, const Instruction& instruction);
+	static void Op7XNN(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY0(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY1(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY2(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY3(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY4(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY5(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY6(Emulator& emulator, const Instruction& instruction);
+	static void Op8XY7(Emulator& emulator, const Instruction& instruction);
+	static void Op8XYE(Emulator& emulator, const Instruction& instruction);
+	static void Op9XY0(Emulator& emulator, const Instruction& instruction);
+	static void OpANNN(Emulator& emulator, const Instruction& instruction);
+	static void OpBNNN(Emulator& emulator, const Instruction& instruction);
+	static void OpCXNN(Emulator& emulator, const Instruction& instruction);
+	static void OpDXYN(Emulator& emulator, const Instruction& instruction);
+	static void OpEX9E(Emulator& emulator, const Instruction& instruction);
+	static void OpEXA1(Emulator& emulator, const Instruction& instruction);
+	static void OpFX07(Emulator& emulator, const Instruction& instruction);
+	static void OpFX0A(Emulator& emulator, const Instruction& instruction);
+	static void OpFX15(Emulator& emulator, const Instruction& instruction);
+	static void OpFX18(Emulator& emulator, const Instruction& instruction);
+	static void OpFX1E(Emulator& emulator, const Instruction& instruction);
+	static void OpFX29(Emulator& emulator, const Instruction& instruction);
+	static void OpFX33(Emulator& emulator, const Instruction& instruction);
+	static void OpFX55(Emulator& emulator, const Instruction& instruction);
+	static void OpFX65(Emulator& emulator, const Instruction& instruction);
+	static void OpUnknown(Emulator& emulator, const Instruction& instruction);
 	
+	/**
+	 * @brief Advances the random number generator stored in the MachineState, so random opcodes replay identically
+	 * after a Restore().
+	 * @return Returns the next 32 bit random number.
+	 */
+	uint32_t Random();
+
+	/**
+	 * @brief Whether an Opcode reads or writes a timer, ie. is FX07, FX15 or FX18. As the timers are only updated in
+	 * between Step()s, these must be the first opcode of a Step() to behave the same in every ExecutionMode.
+	 * @param opcode The Opcode to check.
+	 * @return Returns true for FX07, FX15 and FX18.
+	 */
+	static bool IsTimerOpcode(Opcode opcode);
+
 	/**
 	 * @brief Simple helper function, returning a nibble (4 bits) of a complete Opcode (16 bits). 
 	 * @param opcode The Opcode to analyze.
@@ -86,24 +478,49 @@ private:
 	 */
 	static uint8_t GetOpcodeNibble(Opcode opcode, int nibbleIndex);
 
-	static const uint32_t PROGRAM_START = 0x200;			///< Start point in memory where ROM data is copied to.
+	static const uint32_t MEMORY_SIZE = MachineState::MEMORY_SIZE;	///< Size of CHIP-8's internal memory in bytes.
+	static const uint32_t MEMORY_MASK = MEMORY_SIZE - 1;	///< Mask wrapping addresses around the end of memory.
 	static const uint32_t FONT_START = 0x50;				///< Start point in memory where font data is copied to.
-	static const uint32_t OPCODES_FREQUENCY = 700;			///< Number of opcodes that should be handled per second.
 	static const uint32_t TIMER_DECREMENT_FREQUENCY = 60;	///< Frequency at which the timers should be decremented.
-	static const vector<SDL_Scancode> KEY_MAP;				///< Mapping of SDL scan codes in a 0x0 to 0xF fashion.
+	static const uint64_t NS_PER_SECOND = 1000000000;		///< Number of nanoseconds in a second.
+	static const uint64_t MAX_CATCH_UP_NS = 250000000;		///< Maximum host time a single Run() catches up on, after stalls or breakpoints.
+	static const uint64_t UNLIMITED_SLICE_NS = 8000000;	///< Host time a single Run() executes for at an unlimited instruction rate.
+	static const uint32_t UNLIMITED_BATCH_CYCLES = 4096;	///< Number of opcodes executed between clock checks at an unlimited instruction rate.
+	static const uint32_t COMPILED_STEP_BUDGET = 32;		///< Maximum number of opcodes a single Step() runs through a CompiledRom.
+	static const uint32_t THREADED_STEP_BUDGET = 32;		///< Maximum number of opcodes a single Step() runs through StepThreaded().
+	static const OpcodeHandler OPCODE_HANDLERS[];			///< Every opcode handler, indexed by the entries of OPCODE_TABLE.
 
-	vector<uint8_t> memory;									///< CHIP-8's core internal memory.
-	vector<uint8_t> vars;									///< CHIP-8's variable register.
-	uint16_t PC = PROGRAM_START;							///< CHIP8's program counter, pointing to a specific instruction in memory.
-	uint16_t I = 0;											///< CHIP8's index register, pointing to a specific memory location.
-	stack<uint16_t> stack;									///< CHIP8's call stack, used for nested calls.
-	uint8_t delayTimer = 0;									///< CHIP8's delay timer, used internally for timing events.
-	uint8_t soundTimer = 0;									///< CHIP8's sound timer, which plays a sound when nonzero.
-	uint16_t keys = 0;										///< Bitset of keys being pressed, ranging from [0xF..0x0].
+	MachineState state;										///< Memory, registers, timers, keys and display of the emulated machine.
 
 	const string romPath;									///< Path of the ROM we're emulating.
-	Renderer* renderer = nullptr;							///< Reference to the Renderer, used for Clear() and Display() opcodes.
-	Sound* sound = nullptr;									///< Sound class, used to play audio when soundTimer > 0.
-	float nextOpcodeTime = 0.f;								///< Internal clockwork for when the next Opcode should be dealt with.
-	float nextTimerDecrementTime = 0.f;						///< Internal clockwork for when the timers should be decremented.
+	uint64_t romHash = 0;									///< HashRom() of the ROM we're emulating.
+	DisplaySink* display = nullptr;							///< Where the Framebuffer is presented after it changed, if anywhere.
+	AudioSink* audio = nullptr;								///< Used to play audio when soundTimer > 0, if set.
+	InputSource* input = nullptr;							///< Where keys are polled from, if anywhere.
+	Clock* clock = nullptr;									///< Host time Run() schedules opcodes by.
+	Movie* movie = nullptr;									///< Where changes of input are recorded, if anywhere.
+	bool framebufferChanged = true;							///< Whether framebuffer needs to be presented, initially true to present a clear frame.
+	uint32_t instructionsPerSecond = OPCODES_FREQUENCY;		///< Number of opcodes executed per second, or UNLIMITED_INSTRUCTIONS_PER_SECOND.
+	uint64_t lastRunTime = 0;								///< Host time of the previous Run(), in nanoseconds.
+	uint64_t cycleAccumulator = 0;							///< Fractional opcodes owed, in opcodes times nanoseconds per second.
+	int64_t owedCycles = 0;									///< Whole opcodes owed, negative when a batch executed more than owed.
+	bool idle = false;										///< Whether the most recent Run() skipped through an idle loop.
+	uint64_t skippedTime = 0;								///< Total emulated time skipped through idle loops, in nanoseconds.
+	bool skipIdleLoops = true;								///< Whether idle loops are fast-forwarded through rather than executed.
+	uint32_t runAheadFrames = 0;							///< Number of frames presented ahead of the actual MachineState.
+	bool speculating = false;								///< Whether opcodes are being executed ahead, and mustn't have effects outside the MachineState.
+	uint64_t lastRunAheadTime = 0;							///< Host time of the most recent RunAhead(), in nanoseconds.
+	uint64_t runTime = 0;									///< Total host time spent in Run(), in nanoseconds.
+	uint64_t runAheadTime = 0;								///< Total host time spent in RunAhead(), in nanoseconds.
+	bool verbose = true;									///< Whether progress and unknown opcodes are logged, besides errors.
+	uint8_t* coverage = nullptr;							///< Counters of the Opcodes executed per address, if counting.
+	vector<uint32_t> touchedCoverage;						///< Index of every coverage counter counted since ClearCoverage().
+	Profiler* profiler = nullptr;							///< Profiler of every Opcode executed, if profiling.
+	MachineState runAheadState;								///< The actual MachineState, while running ahead.
+
+	ExecutionMode executionMode = ExecutionMode::CachedInterpreter;	///< How opcodes are currently being executed.
+	vector<Instruction> instructionCache;					///< Decoded Instruction for every address in memory.
+	Jit jit;												///< Dynamic recompiler, used by ExecutionMode::Jit.
+	const CompiledRom* compiledRom = nullptr;				///< Ahead-of-time translation of the loaded ROM, if linked in and still valid.
+	vector<bool> compiledCode;								///< Whether a byte of memory is covered by compiledRom's translated code.
 };
@@ -0,0 +1,39 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "Framebuffer.h"
+#include "MachineState.h"
+
+void Framebuffer::Clear()
+{
+	for (int y = 0; y < HEIGHT; y++)
+		rows[y] = 0;
+}
+
+bool Framebuffer::Draw(uint8_t x, uint8_t y, uint8_t n, uint16_t I, const uint8_t* memory)
+{
+	x = x % WIDTH;
+	y = y % HEIGHT;
+
+	uint64_t collisions = 0;
+
+	for (uint8_t row = 0; row < n && y < HEIGHT; row++, y++)
+	{
+		// Placing the sprite's byte at the leftmost pixel and shifting it right drops whatever passes the right edge
+		const uint8_t spriteData = memory[(I + row) & (MachineState::MEMORY_SIZE - 1)]; // I may point anywhere, wrap around like every other access
+		const uint64_t bits = ((uint64_t)spriteData << (WIDTH - 8)) >> x;
+
+		collisions |= rows[y] & bits;
+		rows[y] ^= bits;
+	}
+
+	return collisions != 0;
+}
+
+uint64_t Framebuffer::GetHash() const
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (int y = 0; y < HEIGHT; y++)
+		hash = (hash ^ rows[y]) * 0x100000001B3ull;
+
+	return hash;
+}
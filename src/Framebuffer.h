@@ -0,0 +1,69 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+// Usings
+using namespace std;
+
+/**
+ * @brief CHIP-8's monochrome 64x32 display, as drawn to by the Emulator and shown by a DisplaySink.
+ *
+ * Every row is packed into a single 64 bit word, the leftmost pixel being the most significant bit. This keeps the
+ * Framebuffer trivially copyable and 256 bytes small, so it can be part of a MachineState.
+ */
+class Framebuffer
+{
+public:
+	/**
+	 * @brief Clears the frame buffer. Intended for CHIP-8's 00E0 instruction.
+	 */
+	void Clear();
+
+	/**
+	 * @brief XORs a sprite onto the frame buffer. Intended for CHIP-8's DXYN instruction. The starting position wraps
+	 * around the edges, the sprite itself is clipped by them.
+	 * @param x The X coordinate at which we should be drawing.
+	 * @param y The Y coordinate at which we should be drawing.
+	 * @param n Number of rows we should be drawing (height).
+	 * @param I Start location in memory from which we should be drawing.
+	 * @param memory The Emulator's memory, MachineState::MEMORY_SIZE bytes which sprites wrap around the end of.
+	 * @return Returns whether any pixel was switched off, ie. whether the sprite collided.
+	 */
+	bool Draw(uint8_t x, uint8_t y, uint8_t n, uint16_t I, const uint8_t* memory);
+
+	/**
+	 * @brief Gets whether a single pixel is on.
+	 * @param x The X coordinate of the pixel, in [0..WIDTH).
+	 * @param y The Y coordinate of the pixel, in [0..HEIGHT).
+	 * @return Returns true if the pixel is on.
+	 */
+	bool GetPixel(int x, int y) const { return (rows[y] >> (WIDTH - 1 - x)) & 1; }
+
+	/**
+	 * @brief Gets all pixels of a row at once.
+	 * @param y The Y coordinate of the row, in [0..HEIGHT).
+	 * @return Returns the row, the leftmost pixel being the most significant bit.
+	 */
+	uint64_t GetRow(int y) const { return rows[y]; }
+
+	/**
+	 * @brief Flips the pixels of a row whose bits are set, such as to apply a difference between two Framebuffers.
+	 * @param y The Y coordinate of the row, in [0..HEIGHT).
+	 * @param bits The pixels to flip, the leftmost pixel being the most significant bit.
+	 */
+	void XorRow(int y, uint64_t bits) { rows[y] ^= bits; }
+
+	/**
+	 * @brief Hashes the pixels (64 bit FNV-1a, a row at a time), so the outcome of runs can be compared.
+	 * @return Returns the hash.
+	 */
+	uint64_t GetHash() const;
+
+	static const int WIDTH = 64;					///< The number of horizontal pixels CHIP-8's display holds.
+	static const int HEIGHT = 32;					///< The number of vertical pixels CHIP-8's display holds.
+
+private:
+	uint64_t rows[HEIGHT] = {};						///< CHIP-8's pixels being either on or off, one row per word.
+};
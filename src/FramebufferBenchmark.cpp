@@ -0,0 +1,114 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "FramebufferBenchmark.h"
+#include <iostream>
+#include <vector>
+#include "Framebuffer.h"
+#include "MachineState.h"
+#include "SteadyClock.h"
+
+/**
+ * @brief Draws a sprite the way Framebuffer::Draw() used to, one pixel at a time with a branch per pixel, which the
+ * draw benchmark compares against.
+ * @param framebuffer The Framebuffer to draw onto.
+ * @param x The X coordinate at which to draw, wrapping around.
+ * @param y The Y coordinate at which to draw, wrapping around.
+ * @param n Number of rows to draw.
+ * @param I Start location in memory of the sprite.
+ * @param memory MachineState::MEMORY_SIZE bytes which sprites wrap around the end of.
+ * @return Returns whether any pixel was switched off.
+ */
+static bool DrawPerPixel(Framebuffer& framebuffer, uint8_t x, uint8_t y, uint8_t n, uint16_t I, const uint8_t* memory)
+{
+	x = x % Framebuffer::WIDTH;
+	const uint8_t originalX = x;
+	y = y % Framebuffer::HEIGHT;
+
+	bool collision = false;
+
+	for (uint8_t row = 0; row < n && y < Framebuffer::HEIGHT; row++, y++)
+	{
+		const uint8_t spriteData = memory[(I + row) & (MachineState::MEMORY_SIZE - 1)];
+		x = originalX;
+
+		for (int col = 7; col >= 0 && x < Framebuffer::WIDTH; col--, x++)
+		{
+			const bool currentPixel = framebuffer.GetPixel(x, y);
+			const bool newPixel = spriteData & (1 << col);
+
+			if (newPixel && currentPixel)
+				collision = true;
+
+			if (newPixel)
+				framebuffer.XorRow(y, 1ull << (Framebuffer::WIDTH - 1 - x));
+		}
+	}
+
+	return collision;
+}
+
+int RunDrawBenchmark(uint32_t numDraws)
+{
+	struct Sprite
+	{
+		uint8_t x;
+		uint8_t y;
+		uint8_t n;
+		uint16_t I;
+	};
+
+	static const uint32_t DRAWS_PER_CLEAR = 64;
+
+	uint32_t random = 1;
+	const auto next = [&random]()
+	{
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return random;
+	};
+
+	std::vector<uint8_t> memory(MachineState::MEMORY_SIZE);
+	for (uint8_t& byte : memory)
+		byte = (uint8_t)next();
+
+	std::vector<Sprite> sprites(numDraws);
+	for (Sprite& sprite : sprites)
+		sprite = { (uint8_t)next(), (uint8_t)next(), (uint8_t)(next() % 16), (uint16_t)(next() % MachineState::MEMORY_SIZE) };
+
+	// Collisions are summed, so neither loop can be optimized away
+	SteadyClock clock;
+	Framebuffer packed;
+	uint32_t packedCollisions = 0;
+	uint64_t startTime = clock.GetTicksNS();
+	for (uint32_t i = 0; i < numDraws; i++)
+	{
+		if (i % DRAWS_PER_CLEAR == 0)
+			packed.Clear();
+
+		packedCollisions += packed.Draw(sprites[i].x, sprites[i].y, sprites[i].n, sprites[i].I, memory.data()) ? 1 : 0;
+	}
+
+	const uint64_t packedTime = clock.GetTicksNS() - startTime;
+
+	Framebuffer perPixel;
+	uint32_t perPixelCollisions = 0;
+	startTime = clock.GetTicksNS();
+	for (uint32_t i = 0; i < numDraws; i++)
+	{
+		if (i % DRAWS_PER_CLEAR == 0)
+			perPixel.Clear();
+
+		perPixelCollisions += DrawPerPixel(perPixel, sprites[i].x, sprites[i].y, sprites[i].n, sprites[i].I, memory.data()) ? 1 : 0;
+	}
+
+	const uint64_t perPixelTime = clock.GetTicksNS() - startTime;
+
+	const bool agree = packedCollisions == perPixelCollisions && packed.GetHash() == perPixel.GetHash();
+	std::cout << "Drew " << numDraws << " sprites, " << packedCollisions << " of which collided" << std::endl;
+	std::cout << "Per row: " << packedTime / (double)numDraws << " ns per draw" << std::endl;
+	std::cout << "Per pixel: " << perPixelTime / (double)numDraws << " ns per draw" << std::endl;
+	std::cout << "Per row is " << perPixelTime / (double)std::max<uint64_t>(packedTime, 1) << "x as fast, " << (agree ? "both agree" : "results differ") << std::endl;
+
+	return agree ? 0 : -1;
+}
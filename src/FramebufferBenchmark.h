@@ -0,0 +1,14 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+/**
+ * @brief Draws the same random sprites, at random positions including ones clipped by the edges, with Framebuffer::Draw()
+ * and with DrawPerPixel(), clearing every few draws like a game redrawing its frame. Reports the time per draw of both,
+ * and checks they agree on every collision and on the final pixels.
+ * @param numDraws Number of sprites to draw.
+ * @return Returns 0 if both agreed.
+ */
+int RunDrawBenchmark(uint32_t numDraws);
@@ -0,0 +1,380 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+// Defined when linking with libFuzzer (-fsanitize=fuzzer, or /fsanitize=fuzzer on MSVC), which brings its own main()
+//#define CHIP8_LIBFUZZER
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include "Emulator.h"
+#include "MachineState.h"
+#include "SteadyClock.h"
+
+static const uint32_t FUZZ_CYCLES = 1024;	///< Most opcodes an input runs for, half without keys and half with all of them held.
+static const uint32_t FUZZ_SLICE_CYCLES = 32;	///< Opcodes run at a time, each half ending after a slice which reached nothing new.
+
+/**
+ * @brief Counters of the Opcodes executed per address during a single run. With libFuzzer on ELF platforms they're
+ * placed where it looks for extra counters, so inputs reaching new CHIP-8 code count as new coverage, not just inputs
+ * reaching new Emulator code. Elsewhere libFuzzer only sees the Emulator's own code.
+ */
+#if defined(CHIP8_LIBFUZZER) && defined(__clang__) && defined(__ELF__)
+__attribute__((used, section("__libfuzzer_extra_counters")))
+#endif
+static uint8_t coverage[Emulator::COVERAGE_SIZE];
+
+/**
+ * @brief The Emulator every run reuses, so a run costs a Restore() rather than constructing an Emulator and its caches.
+ */
+struct FuzzTarget
+{
+	Emulator emulator { "fuzz input", nullptr, nullptr, nullptr, nullptr };	///< The Emulator running every input.
+	MachineState bootState;						///< MachineState right after booting without a ROM.
+	MachineState runState;						///< bootState with the input loaded, restored at the start of a run.
+
+	FuzzTarget()
+	{
+		emulator.SetVerbose(false);
+		emulator.SetSeed(1);
+		emulator.Init(nullptr, 0);
+		emulator.SetCoverage(coverage);
+		bootState = emulator.GetState();
+	}
+};
+
+/**
+ * @brief Gets the FuzzTarget, created on first use.
+ * @return Returns the FuzzTarget.
+ */
+static FuzzTarget& GetTarget()
+{
+	static FuzzTarget target;
+	return target;
+}
+
+/**
+ * @brief Runs half of an input's opcodes, a slice at a time, until it ran them all or a slice reached nothing new.
+ * @param emulator The Emulator running the input.
+ * @param seen Buckets of every counter seen by earlier runs, or nullptr to only look at this run.
+ */
+static void RunHalf(Emulator& emulator, const std::vector<uint8_t>* seen)
+{
+	const std::vector<uint32_t>& touched = emulator.GetTouchedCoverage();
+	for (uint32_t numExecuted = 0; numExecuted < FUZZ_CYCLES / 2; numExecuted += FUZZ_SLICE_CYCLES)
+	{
+		const size_t numTouched = touched.size();
+		emulator.RunCycles(FUZZ_SLICE_CYCLES);
+
+		// Going round code this run, or any run before it, already reached. More of the same would at most count
+		// counters into higher buckets, so it's cut short in favour of running more inputs
+		bool reachedNew = false;
+		for (size_t i = numTouched; i < touched.size() && !reachedNew; i++)
+			reachedNew = seen == nullptr || (*seen)[touched[i]] == 0;
+
+		if (!reachedNew)
+			break;
+	}
+}
+
+/**
+ * @brief Runs an input as a ROM loaded at PROGRAM_START, cutting off whatever doesn't fit in memory.
+ * @param data The input.
+ * @param size Size of the input in bytes.
+ * @param seen Buckets of every counter seen by earlier runs, or nullptr when libFuzzer keeps track of them.
+ */
+static void RunInput(const uint8_t* data, size_t size, const std::vector<uint8_t>* seen = nullptr)
+{
+	FuzzTarget& target = GetTarget();
+
+	// Only the counters the previous run touched
+	target.emulator.ClearCoverage();
+
+	// Restore() only invalidates decoded code where the previous input differs
+	target.runState = target.bootState;
+	memcpy(&target.runState.memory[Emulator::PROGRAM_START], data, std::min<size_t>(size, Emulator::MAX_ROM_SIZE));
+	target.emulator.Restore(target.runState);
+
+	// Both with and without keys, so either outcome of key checks can be reached
+	RunHalf(target.emulator, seen);
+	target.emulator.SetKeys(0xFFFF);
+	RunHalf(target.emulator, seen);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	RunInput(data, size);
+	return 0;
+}
+
+#ifndef CHIP8_LIBFUZZER
+
+/**
+ * @brief Prints how the application should be started.
+ * @param executable Path of the executable, as found in argv[0].
+ */
+static void PrintUsage(const char* executable)
+{
+	std::cout << "Usage: " << std::filesystem::path(executable).filename().string() << " [--runs=<count>] [--seed=<seed>] [--output=<corpus directory>] [<seed ROM path or directory>...]" << std::endl;
+	std::cout << "Fuzzes the Emulator in-process with mutations of the seed ROMs, keeping every input which executes new opcodes at new addresses." << std::endl;
+	std::cout << "Inputs adding coverage are written to the corpus directory, if given. Build with CHIP8_LIBFUZZER defined to run under libFuzzer instead." << std::endl;
+}
+
+/**
+ * @brief Advances a xorshift generator.
+ * @param state State of the generator, never zero.
+ * @return Returns the next 64 bit random number.
+ */
+static uint64_t Random(uint64_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+/**
+ * @brief Mutates an input, a few times over.
+ * @param input The input to mutate.
+ * @param corpus Inputs to splice from.
+ * @param random State of the random number generator.
+ */
+static void Mutate(std::vector<uint8_t>& input, const std::vector<std::vector<uint8_t>>& corpus, uint64_t& random)
+{
+	const uint32_t numMutations = 1 + Random(random) % 4;
+	for (uint32_t i = 0; i < numMutations; i++)
+	{
+		const size_t position = input.empty() ? 0 : Random(random) % input.size();
+		switch (Random(random) % 6)
+		{
+			case 0: // Flip a bit
+				if (!input.empty())
+					input[position] ^= 1 << (Random(random) % 8);
+				break;
+
+			case 1: // Replace a byte
+				if (!input.empty())
+					input[position] = (uint8_t)Random(random);
+				break;
+
+			case 2: // Replace an Opcode, aligned as code usually is
+				if (input.size() >= 2)
+				{
+					const size_t aligned = position & ~(size_t)1;
+					const uint16_t opcode = (uint16_t)Random(random);
+					input[aligned] = opcode >> 8;
+					input[std::min(aligned + 1, input.size() - 1)] = opcode & 0xFF;
+				}
+				break;
+
+			case 3: // Insert an Opcode
+				if (input.size() + 2 <= Emulator::MAX_ROM_SIZE)
+				{
+					const uint16_t opcode = (uint16_t)Random(random);
+					const uint8_t bytes[] = { (uint8_t)(opcode >> 8), (uint8_t)opcode };
+					input.insert(input.begin() + (position & ~(size_t)1), bytes, bytes + 2);
+				}
+				break;
+
+			case 4: // Erase an Opcode
+				if ((position & ~(size_t)1) + 2 <= input.size())
+					input.erase(input.begin() + (position & ~(size_t)1), input.begin() + (position & ~(size_t)1) + 2);
+				break;
+
+			case 5: // Splice in part of another input
+			{
+				const std::vector<uint8_t>& other = corpus[Random(random) % corpus.size()];
+				if (!other.empty())
+				{
+					const size_t begin = Random(random) % other.size();
+					const size_t length = std::min<size_t>(1 + Random(random) % 64, other.size() - begin);
+					input.resize(std::max(input.size(), position + length));
+					std::copy(other.begin() + begin, other.begin() + begin + length, input.begin() + position);
+				}
+				break;
+			}
+		}
+	}
+
+	if (input.size() > Emulator::MAX_ROM_SIZE)
+		input.resize(Emulator::MAX_ROM_SIZE);
+}
+
+/**
+ * @brief Buckets a counter like libFuzzer and AFL do, so only hitting code a different order of magnitude of times counts.
+ * @param count The counter.
+ * @return Returns a single bit per bucket: 1, 2, 3, 4-7, 8-15, 16-31, 32-127 and 128 or more.
+ */
+static constexpr uint8_t GetBucket(uint8_t count)
+{
+	if (count <= 3)
+		return count == 0 ? 0 : 1 << (count - 1);
+
+	if (count < 32)
+		return count < 8 ? 1 << 3 : count < 16 ? 1 << 4 : 1 << 5;
+
+	return count < 128 ? 1 << 6 : 1 << 7;
+}
+
+/**
+ * @brief Builds BUCKETS at compile time.
+ * @return The bucket of every possible counter.
+ */
+static constexpr std::array<uint8_t, 256> BuildBuckets()
+{
+	std::array<uint8_t, 256> buckets = {};
+	for (uint32_t count = 0; count < buckets.size(); count++)
+		buckets[count] = GetBucket((uint8_t)count);
+
+	return buckets;
+}
+
+static constexpr std::array<uint8_t, 256> BUCKETS = BuildBuckets();	///< Bucket of every possible counter, see GetBucket().
+
+/**
+ * @brief Merges the coverage of the latest run into everything seen so far.
+ * @param seen Buckets of every counter seen so far.
+ * @param numCovered Incremented for every counter seen for the first time.
+ * @return Returns true if any counter reached a bucket it never reached before.
+ */
+static bool MergeCoverage(std::vector<uint8_t>& seen, size_t& numCovered)
+{
+	// Only the counters this run touched, a few hundred out of all of them
+	bool isNew = false;
+	for (uint32_t i : GetTarget().emulator.GetTouchedCoverage())
+	{
+		const uint8_t bucket = BUCKETS[coverage[i]];
+		if ((bucket & ~seen[i]) != 0)
+		{
+			numCovered += seen[i] == 0 ? 1 : 0;
+			seen[i] |= bucket;
+			isNew = true;
+		}
+	}
+
+	return isNew;
+}
+
+/**
+ * @brief Reads a file entirely.
+ * @param path Path to the file.
+ * @param data Set to the contents, cut off at MAX_ROM_SIZE.
+ * @return Returns false if the file couldn't be opened.
+ */
+static bool ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& data)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Could not open '" << path.string() << "'" << std::endl;
+		return false;
+	}
+
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	if (data.size() > Emulator::MAX_ROM_SIZE)
+		data.resize(Emulator::MAX_ROM_SIZE);
+
+	return true;
+}
+
+int main(int argc, const char* argv[])
+{
+	uint64_t numRuns = 1000000;
+	uint64_t random = 1;
+	std::string outputPath;
+	std::vector<std::filesystem::path> seedPaths;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+
+		if (argument.rfind("--runs=", 0) == 0 && std::atoll(argument.c_str() + 7) > 0)
+			numRuns = std::atoll(argument.c_str() + 7);
+		else if (argument.rfind("--seed=", 0) == 0 && std::atoll(argument.c_str() + 7) > 0)
+			random = std::atoll(argument.c_str() + 7);
+		else if (argument.rfind("--output=", 0) == 0 && argument.size() > 9)
+			outputPath = argument.substr(9);
+		else if (argument.rfind("--", 0) != 0)
+		{
+			std::error_code error;
+			if (std::filesystem::is_directory(argument, error))
+			{
+				for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(argument, error))
+				{
+					if (entry.is_regular_file(error))
+						seedPaths.push_back(entry.path());
+				}
+			}
+			else
+				seedPaths.push_back(argument);
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	// Sorted so the same seed ROMs and seed fuzz the same way
+	std::sort(seedPaths.begin(), seedPaths.end());
+
+	std::vector<std::vector<uint8_t>> corpus;
+	std::vector<uint8_t> seen(Emulator::COVERAGE_SIZE, 0);
+	size_t numCovered = 0;
+
+	for (const std::filesystem::path& path : seedPaths)
+	{
+		std::vector<uint8_t> input;
+		if (!ReadFile(path, input))
+			return -1;
+
+		RunInput(input.data(), input.size());
+		MergeCoverage(seen, numCovered);
+		corpus.push_back(input);
+	}
+
+	if (corpus.empty())
+		corpus.emplace_back();
+
+	if (!outputPath.empty())
+		std::filesystem::create_directories(outputPath);
+
+	SteadyClock clock;
+	const uint64_t startTime = clock.GetTicksNS();
+	uint64_t nextReport = 1 << 16;
+	std::vector<uint8_t> input;
+
+	for (uint64_t run = 1; run <= numRuns; run++)
+	{
+		input = corpus[Random(random) % corpus.size()];
+		Mutate(input, corpus, random);
+
+		RunInput(input.data(), input.size(), &seen);
+		if (MergeCoverage(seen, numCovered))
+		{
+			if (!outputPath.empty())
+			{
+				std::ofstream file(std::filesystem::path(outputPath) / ("input-" + std::to_string(run) + ".ch8"), std::ios::binary);
+				file.write(reinterpret_cast<const char*>(input.data()), input.size());
+			}
+
+			corpus.push_back(input);
+		}
+
+		if (run == nextReport || run == numRuns)
+		{
+			const uint64_t elapsed = std::max<uint64_t>(clock.GetTicksNS() - startTime, 1);
+			std::cout << "Run " << run << ": " << (uint64_t)(run * 1e9 / elapsed) << " runs per second, " << corpus.size() << " inputs in corpus, " << numCovered << " counters covered" << std::endl;
+			nextReport *= 2;
+		}
+	}
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,258 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include "Emulator.h"
+#include "Framebuffer.h"
+#include "SteadyClock.h"
+#include "Movie.h"
+#include "Profiler.h"
+#include "NetplayLoopback.h"
+#include "BroadcastBenchmark.h"
+#include "LockstepBenchmark.h"
+#include "VecEnvBenchmark.h"
+#include "FramebufferBenchmark.h"
+#include "DispatchBenchmark.h"
+#include "JitDifferentialTest.h"
+
+/**
+ * @brief Prints how the application should be started.
+ * @param executable Path of the executable, as found in argv[0].
+ */
+static void PrintUsage(const char* executable)
+{
+	std::cout << "Usage: " << std::filesystem::path(executable).filename().string() << " [--mode=interpreter|cached|threaded|jit|compiled] [--cycles=<count>|--frames=<count>] [--ips=<opcodes per second>] [--replay=<movie path>] [--netplay-loopback [--latency=<ms>] [--loss=<percent>]] [--spectators=<count> [--broadcast=<address>]] [--lockstep=<instances>] [--envs=<count> [--frameskip=<frames>] [--threads=<count>]] [--draw-bench=<draws>] [--jit-diff=<programs> [--seed=<seed>]] [--dispatch-bench=<opcodes>] [--profile=<path>.json|.csv|.folded] [--print] <ROM path>" << std::endl;
+	std::cout << "Runs a ROM as fast as possible without window, GPU or audio device, and reports how long it took." << std::endl;
+	std::cout << "With --replay, the input recorded in the movie is replayed instead, up to where recording stopped." << std::endl;
+	std::cout << "With --netplay-loopback, two players play over loopback with scripted input, checking they stay in sync." << std::endl;
+	std::cout << "With --spectators, every frame is broadcast to that many local spectators, measuring the cost of publishing." << std::endl;
+	std::cout << "The broadcast address is either unix:<path> or [<host>:]<port>, and defaults to a free TCP port." << std::endl;
+	std::cout << "With --lockstep, that many instances run on an Emulator each and on a LockstepInterpreter, comparing their speed." << std::endl;
+	std::cout << "With --envs, that many VecEnv environments take --frames steps with random actions, measuring frames per second." << std::endl;
+	std::cout << "With --draw-bench, no ROM is run: that many random sprites are drawn per row and per pixel, comparing their speed." << std::endl;
+	std::cout << "With --jit-diff, no ROM is run: that many random programs run interpreted and on the JIT, checking they agree." << std::endl;
+	std::cout << "With --dispatch-bench, the ROM runs that many opcodes in every mode without skipping idle loops, comparing their speed." << std::endl;
+	std::cout << "With --profile, every opcode is profiled and the profile saved to the path, in the format of its extension." << std::endl;
+}
+
+/**
+ * @brief Prints a Framebuffer as text, one character per pixel.
+ * @param framebuffer The Framebuffer to print.
+ */
+static void PrintFramebuffer(const Framebuffer& framebuffer)
+{
+	for (int y = 0; y < Framebuffer::HEIGHT; y++)
+	{
+		std::string line(Framebuffer::WIDTH, '.');
+		for (int x = 0; x < Framebuffer::WIDTH; x++)
+		{
+			if (framebuffer.GetPixel(x, y))
+				line[x] = '#';
+		}
+
+		std::cout << line << std::endl;
+	}
+}
+
+/**
+ * @brief Runs a ROM as fast as possible, optionally replaying a movie and profiling every opcode, then reports how long
+ * it took.
+ * @param emulator The Emulator to run, already initialized.
+ * @param numCycles Number of opcodes to execute, unless numFrames or a movie decide.
+ * @param numFrames Number of frames to run, or 0 to run numCycles opcodes.
+ * @param moviePath Path to a movie to replay, or empty to run without input.
+ * @param profilePath Path to save the profile to, or empty to not profile.
+ * @param print Whether to print the final Framebuffer.
+ * @return Returns 0 if the ROM ran and the profile could be saved.
+ */
+static int RunRom(Emulator& emulator, uint64_t numCycles, uint64_t numFrames, const std::string& moviePath, const std::string& profilePath, bool print)
+{
+	// Too large for the stack, with several counters per address
+	std::unique_ptr<Profiler> profiler;
+	if (!profilePath.empty())
+	{
+		profiler = std::make_unique<Profiler>();
+		emulator.SetProfiler(profiler.get());
+	}
+
+	Movie movie;
+	if (!moviePath.empty())
+	{
+		if (!movie.Load(moviePath))
+			return -1;
+
+		// The movie decides the rate of the clock the timers are derived from
+		emulator.SetInstructionsPerSecond(movie.GetClockFrequency());
+	}
+
+	// A frame lasts as many opcodes as fit in one decrement of the timers
+	const uint32_t cyclesPerFrame = emulator.GetClockFrequency() / 60 > 0 ? emulator.GetClockFrequency() / 60 : 1;
+	if (numFrames > 0)
+		numCycles = numFrames * cyclesPerFrame;
+
+	SteadyClock clock;
+	const uint64_t startTime = clock.GetTicksNS();
+
+	uint64_t numExecuted = 0;
+	if (!moviePath.empty())
+	{
+		numExecuted = movie.Replay(emulator);
+		if (numExecuted == 0)
+			return -1;
+	}
+	else
+	{
+		while (numExecuted < numCycles)
+			numExecuted += emulator.RunCycles((uint32_t)std::min<uint64_t>(numCycles - numExecuted, cyclesPerFrame));
+	}
+
+	const uint64_t elapsed = clock.GetTicksNS() - startTime;
+
+	if (print)
+		PrintFramebuffer(emulator.GetFramebuffer());
+
+	std::cout << "Executed " << numExecuted << " opcodes (" << numExecuted / cyclesPerFrame << " frames) in " << elapsed / 1e6 << " ms" << std::endl;
+	std::cout << "Skipped " << emulator.GetSkippedTimeNS() / 1e9 << " s of idle emulated time" << std::endl;
+	std::cout << elapsed / (double)numExecuted << " ns per opcode, " << numExecuted * 1e3 / elapsed << " million opcodes per second" << std::endl;
+	std::cout << "Framebuffer hash: " << std::hex << emulator.GetFramebuffer().GetHash() << std::dec << std::endl;
+
+	if (profiler != nullptr)
+	{
+		profiler->WriteSummary(std::cout);
+		if (!profiler->Save(profilePath))
+			return -1;
+
+		std::cout << "Profile saved to " << profilePath << std::endl;
+	}
+
+	return 0;
+}
+
+int main(int argc, const char* argv[])
+{
+	std::string romPath;
+	ExecutionMode executionMode = ExecutionMode::CachedInterpreter;
+	uint32_t instructionsPerSecond = Emulator::OPCODES_FREQUENCY;
+	uint64_t numCycles = 10000000;
+	uint64_t numFrames = 0;
+	std::string moviePath;
+	bool netplayLoopback = false;
+	uint32_t latencyMS = 0;
+	uint32_t lossPercent = 0;
+	uint32_t numSpectators = 0;
+	std::string broadcastAddress = "0";
+	uint32_t numLockstepInstances = 0;
+	uint32_t numEnvs = 0;
+	uint32_t frameskip = 4;
+	uint32_t numThreads = 0;
+	uint32_t numBenchDraws = 0;
+	uint32_t numJitPrograms = 0;
+	uint32_t seed = 1;
+	uint64_t numDispatchOpcodes = 0;
+	std::string profilePath;
+	bool print = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string argument = argv[i];
+
+		if (argument == "--mode=interpreter")
+			executionMode = ExecutionMode::Interpreter;
+		else if (argument == "--mode=cached")
+			executionMode = ExecutionMode::CachedInterpreter;
+		else if (argument == "--mode=threaded")
+			executionMode = ExecutionMode::Threaded;
+		else if (argument == "--mode=jit")
+			executionMode = ExecutionMode::Jit;
+		else if (argument == "--mode=compiled")
+			executionMode = ExecutionMode::Compiled;
+		else if (argument.rfind("--cycles=", 0) == 0 && std::atoll(argument.c_str() + 9) > 0)
+			numCycles = std::atoll(argument.c_str() + 9);
+		else if (argument.rfind("--frames=", 0) == 0 && std::atoll(argument.c_str() + 9) > 0)
+			numFrames = std::atoll(argument.c_str() + 9);
+		else if (argument.rfind("--ips=", 0) == 0 && std::atoi(argument.c_str() + 6) > 0)
+			instructionsPerSecond = std::atoi(argument.c_str() + 6);
+		else if (argument.rfind("--replay=", 0) == 0 && argument.size() > 9)
+			moviePath = argument.substr(9);
+		else if (argument == "--netplay-loopback")
+			netplayLoopback = true;
+		else if (argument.rfind("--latency=", 0) == 0 && std::atoi(argument.c_str() + 10) >= 0)
+			latencyMS = std::atoi(argument.c_str() + 10);
+		else if (argument.rfind("--loss=", 0) == 0 && std::atoi(argument.c_str() + 7) >= 0)
+			lossPercent = std::atoi(argument.c_str() + 7);
+		else if (argument.rfind("--spectators=", 0) == 0 && std::atoi(argument.c_str() + 13) > 0)
+			numSpectators = std::atoi(argument.c_str() + 13);
+		else if (argument.rfind("--broadcast=", 0) == 0 && argument.size() > 12)
+			broadcastAddress = argument.substr(12);
+		else if (argument.rfind("--lockstep=", 0) == 0 && std::atoi(argument.c_str() + 11) > 0)
+			numLockstepInstances = std::atoi(argument.c_str() + 11);
+		else if (argument.rfind("--envs=", 0) == 0 && std::atoi(argument.c_str() + 7) > 0)
+			numEnvs = std::atoi(argument.c_str() + 7);
+		else if (argument.rfind("--frameskip=", 0) == 0 && std::atoi(argument.c_str() + 12) > 0)
+			frameskip = std::atoi(argument.c_str() + 12);
+		else if (argument.rfind("--threads=", 0) == 0 && std::atoi(argument.c_str() + 10) > 0)
+			numThreads = std::atoi(argument.c_str() + 10);
+		else if (argument.rfind("--draw-bench=", 0) == 0 && std::atoi(argument.c_str() + 13) > 0)
+			numBenchDraws = std::atoi(argument.c_str() + 13);
+		else if (argument.rfind("--jit-diff=", 0) == 0 && std::atoi(argument.c_str() + 11) > 0)
+			numJitPrograms = std::atoi(argument.c_str() + 11);
+		else if (argument.rfind("--seed=", 0) == 0 && std::atoll(argument.c_str() + 7) > 0)
+			seed = (uint32_t)std::atoll(argument.c_str() + 7);
+		else if (argument.rfind("--dispatch-bench=", 0) == 0 && std::atoll(argument.c_str() + 17) > 0)
+			numDispatchOpcodes = std::atoll(argument.c_str() + 17);
+		else if (argument.rfind("--profile=", 0) == 0 && argument.size() > 10)
+			profilePath = argument.substr(10);
+		else if (argument == "--print")
+			print = true;
+		else if (romPath.empty() && argument.rfind("--", 0) != 0)
+			romPath = argument;
+		else
+		{
+			PrintUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	if (numBenchDraws > 0)
+		return RunDrawBenchmark(numBenchDraws);
+
+	if (numJitPrograms > 0)
+		return RunJitDifferentialTest(numJitPrograms, seed);
+
+	if (romPath.empty())
+	{
+		PrintUsage(argv[0]);
+		return -1;
+	}
+
+	if (numDispatchOpcodes > 0)
+		return RunDispatchBenchmark(romPath, instructionsPerSecond, numDispatchOpcodes);
+
+	if (netplayLoopback)
+		return RunNetplayLoopback(romPath, executionMode, instructionsPerSecond, numFrames > 0 ? (uint32_t)numFrames : 3600, latencyMS, lossPercent);
+
+	if (numLockstepInstances > 0)
+		return RunLockstepBenchmark(romPath, executionMode, instructionsPerSecond, numFrames > 0 ? (uint32_t)numFrames : 600, numLockstepInstances);
+
+	if (numEnvs > 0)
+		return RunVecEnvBenchmark(romPath, executionMode, instructionsPerSecond, numFrames > 0 ? (uint32_t)numFrames : 1000, numEnvs, frameskip, numThreads);
+
+	// No display, audio, input or clock, we drive the Emulator ourselves
+	Emulator emulator(romPath, nullptr, nullptr, nullptr, nullptr);
+	if (!emulator.Init())
+		return -1;
+
+	if (!emulator.SetExecutionMode(executionMode))
+		return -1;
+
+	emulator.SetInstructionsPerSecond(instructionsPerSecond);
+
+	if (numSpectators > 0)
+		return RunBroadcastBenchmark(emulator, numFrames > 0 ? (uint32_t)numFrames : 3600, broadcastAddress, numSpectators);
+
+	return RunRom(emulator, numCycles, numFrames, moviePath, profilePath, print);
+}
@@ -0,0 +1,24 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "InputQueue.h"
+
+bool InputQueue::Push(const InputEvent& event)
+{
+	const uint32_t position = tail.load(memory_order_relaxed);
+	if (position - head.load(memory_order_acquire) == CAPACITY)
+		return false;
+
+	events[position % CAPACITY] = event;
+	tail.store(position + 1, memory_order_release);
+	return true;
+}
+
+void InputQueue::Poll()
+{
+	const uint32_t position = head.load(memory_order_relaxed);
+	if (position == tail.load(memory_order_acquire))
+		return;
+
+	current = events[position % CAPACITY];
+	head.store(position + 1, memory_order_release);
+}
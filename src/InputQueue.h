@@ -0,0 +1,64 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <atomic>
+#include <cstdint>
+#include "InputSource.h"
+
+// Usings
+using namespace std;
+
+/**
+ * @brief A change of the input, as sent from the thread handling window events to the emulation thread.
+ */
+struct InputEvent
+{
+	uint16_t keys = 0;					///< Bitset of keys being pressed, ranging from [0xF..0x0].
+	bool rewind = false;				///< Whether the rewind hotkey is being held.
+};
+
+/**
+ * @brief Single producer, single consumer queue of InputEvents, from the thread handling window events to the emulation
+ * thread, acting as the InputSource of the Emulator.
+ *
+ * Every change of the input is queued rather than just the latest one, and the emulation thread takes at most one per
+ * Poll(), so a key pressed and released in between two Emulator::Run()s is still seen pressed by one of them. Neither
+ * thread ever waits: the producer owns the tail and the consumer the head, each only reading the other's index.
+ */
+class InputQueue : public InputSource
+{
+public:
+	/**
+	 * @brief Queues a change of the input. Only to be called by the producing thread.
+	 * @param event The new input.
+	 * @return Returns false if the queue is full, in which case the change should be pushed again later.
+	 */
+	bool Push(const InputEvent& event);
+
+	/**
+	 * @brief Takes the oldest change of the input from the queue, if any, making it the current input. Only to be called
+	 * by the consuming thread, like the getters below.
+	 */
+	void Poll();
+
+	/**
+	 * @brief Gets the keys of the current input.
+	 * @return Returns a bitset of keys being pressed, ranging from [0xF..0x0].
+	 */
+	uint16_t GetKeys() override { return current.keys; }
+
+	/**
+	 * @brief Gets whether the rewind hotkey is held in the current input.
+	 * @return Returns true while the rewind hotkey is held.
+	 */
+	bool IsRewindPressed() const { return current.rewind; }
+
+private:
+	static const uint32_t CAPACITY = 256;				///< Number of events the queue holds, a power of two.
+
+	InputEvent events[CAPACITY];						///< Ring buffer of queued events.
+	alignas(64) atomic<uint32_t> head = 0;				///< Number of events taken, written by the consumer.
+	alignas(64) atomic<uint32_t> tail = 0;				///< Number of events queued, written by the producer.
+	alignas(64) InputEvent current;						///< The current input, owned by the consumer.
+};
@@ -0,0 +1,23 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+/**
+ * @brief Provides the state of CHIP-8's hexadecimal keypad, such as Keyboard reading it from SDL.
+ */
+class InputSource
+{
+public:
+	/**
+	 * @brief Destructor
+	 */
+	virtual ~InputSource() = default;
+
+	/**
+	 * @brief Polls which keys are currently pressed, called once per Emulator::Run().
+	 * @return Returns a bitset of keys being pressed, ranging from [0xF..0x0].
+	 */
+	virtual uint16_t GetKeys() = 0;
+};
@@ -0,0 +1,778 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+//#define CHIP8_ORIGINAL
+
+#include "Jit.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CHIP8_JIT_SUPPORTED
+#endif
+
+namespace
+{
+	/**
+	 * @brief x86-64 general purpose registers, numbered as they're encoded.
+	 */
+	enum HostRegister : uint8_t
+	{
+		RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15
+	};
+
+	/**
+	 * @brief x86-64 condition codes, as used by Jcc, SETcc and CMOVcc.
+	 */
+	enum Condition : uint8_t
+	{
+		CONDITION_AE = 0x3,
+		CONDITION_E = 0x4,
+		CONDITION_NE = 0x5,
+		CONDITION_BE = 0x6,
+	};
+
+	/**
+	 * @brief Opcode bytes of the register/register ALU instructions we use, in their "r/m, reg" form.
+	 */
+	enum AluOperation : uint8_t
+	{
+		ALU_ADD = 0x01,
+		ALU_OR = 0x09,
+		ALU_AND = 0x21,
+		ALU_SUB = 0x29,
+		ALU_XOR = 0x31,
+		ALU_CMP = 0x39,
+		ALU_MOV = 0x89,
+	};
+
+	/**
+	 * @brief ModRM reg field extensions of the immediate ALU and shift instructions we use.
+	 */
+	enum Extension : uint8_t
+	{
+		EXTENSION_ADD = 0,
+		EXTENSION_AND = 4,
+		EXTENSION_SHL = 4,
+		EXTENSION_SHR = 5,
+		EXTENSION_CMP = 7,
+	};
+
+#ifdef _WIN32
+	const HostRegister ARGUMENT_0 = RCX;
+	const HostRegister ARGUMENT_1 = RDX;
+#else
+	const HostRegister ARGUMENT_0 = RDI;
+	const HostRegister ARGUMENT_1 = RSI;
+#endif
+
+	const HostRegister VARS_POINTER = RBP;		///< Holds the vars pointer for the lifetime of a block.
+	const HostRegister I_POINTER = R15;			///< Holds the I pointer for the lifetime of a block.
+
+	/// Registers a block may cache CHIP-8 registers in, volatile ones first. RAX and RCX are kept free as scratch.
+	const HostRegister ALLOCATABLE_REGISTERS[] = { RDX, R8, R9, R10, R11, RBX, RSI, RDI, R12, R13, R14 };
+
+	/// Registers the prologue saves when a block uses them; the union of callee-saved registers of both ABIs.
+	const HostRegister CALLEE_SAVED_REGISTERS[] = { RBX, RBP, RSI, RDI, R12, R13, R14, R15 };
+
+	/**
+	 * @brief Minimal x86-64 machine code emitter, supporting only the instruction forms the Jit needs.
+	 */
+	class Assembler
+	{
+	public:
+		Assembler(uint8_t* code) : code(code) {}
+
+		size_t GetSize() const { return size; }
+
+		void Push(HostRegister reg) { Rex(false, 0, reg, false); Byte(0x50 + (reg & 7)); }
+		void Pop(HostRegister reg) { Rex(false, 0, reg, false); Byte(0x58 + (reg & 7)); }
+		void Ret() { Byte(0xC3); }
+
+		void MovRegReg64(HostRegister dst, HostRegister src)
+		{
+			Rex(true, src, dst, false);
+			Byte(ALU_MOV);
+			ModRM(3, src, dst);
+		}
+
+		void Alu(AluOperation operation, HostRegister dst, HostRegister src)
+		{
+			Rex(false, src, dst, false);
+			Byte(operation);
+			ModRM(3, src, dst);
+		}
+
+		void AluImmediate(Extension extension, HostRegister dst, uint32_t immediate)
+		{
+			Rex(false, 0, dst, false);
+			Byte(0x81);
+			ModRM(3, extension, dst);
+			Dword(immediate);
+		}
+
+		void Shift(Extension extension, HostRegister dst, uint8_t amount)
+		{
+			Rex(false, 0, dst, false);
+			Byte(0xC1);
+			ModRM(3, extension, dst);
+			Byte(amount);
+		}
+
+		void MovImmediate(HostRegister dst, uint32_t immediate)
+		{
+			Rex(false, 0, dst, false);
+			Byte(0xB8 + (dst & 7));
+			Dword(immediate);
+		}
+
+		void XorEaxEax() { Alu(ALU_XOR, RAX, RAX); }
+
+		// Always REX prefixed, so registers 4-7 address SPL/BPL/SIL/DIL rather than AH/CH/DH/BH
+		void MovzxByte(HostRegister dst, HostRegister src)
+		{
+			Rex(false, dst, src, true);
+			Byte(0x0F);
+			Byte(0xB6);
+			ModRM(3, dst, src);
+		}
+
+		void MovzxWord(HostRegister dst, HostRegister src)
+		{
+			Rex(false, dst, src, false);
+			Byte(0x0F);
+			Byte(0xB7);
+			ModRM(3, dst, src);
+		}
+
+		void LoadByte(HostRegister dst, HostRegister base, uint8_t displacement)
+		{
+			assert((base & 7) != RSP);
+			Rex(false, dst, base, false);
+			Byte(0x0F);
+			Byte(0xB6);
+			ModRM(1, dst, base);
+			Byte(displacement);
+		}
+
+		void StoreByte(HostRegister base, uint8_t displacement, HostRegister src)
+		{
+			assert((base & 7) != RSP);
+			Rex(false, src, base, true);
+			Byte(0x88);
+			ModRM(1, src, base);
+			Byte(displacement);
+		}
+
+		void LoadWord(HostRegister dst, HostRegister base)
+		{
+			assert((base & 7) != RSP && (base & 7) != RBP);
+			Rex(false, dst, base, false);
+			Byte(0x0F);
+			Byte(0xB7);
+			ModRM(0, dst, base);
+		}
+
+		void StoreWord(HostRegister base, HostRegister src)
+		{
+			assert((base & 7) != RSP && (base & 7) != RBP);
+			Byte(0x66);
+			Rex(false, src, base, false);
+			Byte(ALU_MOV);
+			ModRM(0, src, base);
+		}
+
+		void SetAl(Condition condition)
+		{
+			Byte(0x0F);
+			Byte(0x90 + condition);
+			Byte(0xC0);
+		}
+
+		void Cmov(Condition condition, HostRegister dst, HostRegister src)
+		{
+			Rex(false, dst, src, false);
+			Byte(0x0F);
+			Byte(0x40 + condition);
+			ModRM(3, dst, src);
+		}
+
+		/**
+		 * @brief Emits a short conditional jump, whose target is filled in later by PatchJump().
+		 * @return Returns the position of the jump.
+		 */
+		size_t JumpShort(Condition condition)
+		{
+			size_t position = size;
+			Byte(0x70 + condition);
+			Byte(0);
+			return position;
+		}
+
+		void PatchJump(size_t position)
+		{
+			code[position + 1] = (uint8_t)(size - (position + 2));
+		}
+
+	private:
+		void Byte(uint8_t value) { code[size++] = value; }
+
+		void Dword(uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+				Byte((value >> (i * 8)) & 0xFF);
+		}
+
+		void Rex(bool wide, int reg, int rm, bool force)
+		{
+			uint8_t rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+			if (rex != 0x40 || force)
+				Byte(rex);
+		}
+
+		void ModRM(int mod, int reg, int rm)
+		{
+			Byte((uint8_t)((mod << 6) | ((reg & 7) << 3) | (rm & 7)));
+		}
+
+		uint8_t* code;
+		size_t size = 0;
+	};
+
+	/**
+	 * @brief Host registers assigned to CHIP-8 registers throughout a single block.
+	 */
+	struct RegisterAllocation
+	{
+		int8_t vars[16] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
+		int8_t I = -1;
+		uint16_t dirtyVars = 0;
+		bool dirtyI = false;
+		int numAllocated = 0;
+
+		HostRegister Var(uint8_t index) const { return (HostRegister)vars[index]; }
+		HostRegister Index() const { return (HostRegister)I; }
+	};
+
+	/**
+	 * @brief Which CHIP-8 registers a single opcode reads and writes.
+	 */
+	struct RegisterUsage
+	{
+		bool translatable = false;
+		bool endsBlock = false;
+		uint16_t usedVars = 0;
+		uint16_t writtenVars = 0;
+		bool usesI = false;
+	};
+
+	RegisterUsage GetRegisterUsage(uint16_t opcode)
+	{
+		const uint8_t x = (opcode >> 8) & 0xF;
+		const uint8_t y = (opcode >> 4) & 0xF;
+		const uint16_t X = 1 << x;
+		const uint16_t Y = 1 << y;
+		const uint16_t F = 1 << 0xF;
+
+		RegisterUsage usage;
+		usage.translatable = true;
+
+		switch (opcode >> 12)
+		{
+			case 0x1: usage.endsBlock = true; break;
+			case 0x3: usage.endsBlock = true; usage.usedVars = X; break;
+			case 0x4: usage.endsBlock = true; usage.usedVars = X; break;
+			case 0x5: usage.endsBlock = true; usage.usedVars = X | Y; break;
+			case 0x6: usage.usedVars = usage.writtenVars = X; break;
+			case 0x7: usage.usedVars = usage.writtenVars = X; break;
+			case 0x8:
+			{
+				switch (opcode & 0xF)
+				{
+					case 0x0:
+					case 0x1:
+					case 0x2:
+					case 0x3: usage.usedVars = X | Y; usage.writtenVars = X; break;
+					case 0x4:
+					case 0x5:
+					case 0x7: usage.usedVars = X | Y | F; usage.writtenVars = X | F; break;
+					case 0x6:
+					case 0xE:
+#ifdef CHIP8_ORIGINAL
+						usage.usedVars = X | Y | F;
+#else
+						usage.usedVars = X | F;
+#endif
+						usage.writtenVars = X | F;
+						break;
+					default: usage.translatable = false; break;
+				}
+				break;
+			}
+			case 0x9: usage.endsBlock = true; usage.usedVars = X | Y; break;
+			case 0xA: usage.usesI = true; break;
+			case 0xF:
+			{
+				if ((opcode & 0xFF) == 0x1E)
+				{
+					usage.usedVars = X;
+					usage.usesI = true;
+				}
+				else
+				{
+					usage.translatable = false;
+				}
+				break;
+			}
+			default: usage.translatable = false; break;
+		}
+
+		return usage;
+	}
+
+	/**
+	 * @brief Assigns host registers to everything an opcode uses, unless that would exceed ALLOCATABLE_REGISTERS.
+	 * @return Returns false if the opcode doesn't fit in the remaining host registers, leaving allocation untouched.
+	 */
+	bool Allocate(RegisterAllocation& allocation, const RegisterUsage& usage)
+	{
+		int needed = (usage.usesI && allocation.I < 0) ? 1 : 0;
+		for (int i = 0; i < 16; i++)
+		{
+			if ((usage.usedVars & (1 << i)) && allocation.vars[i] < 0)
+				needed++;
+		}
+
+		if (allocation.numAllocated + needed > (int)size(ALLOCATABLE_REGISTERS))
+			return false;
+
+		for (int i = 0; i < 16; i++)
+		{
+			if ((usage.usedVars & (1 << i)) && allocation.vars[i] < 0)
+				allocation.vars[i] = ALLOCATABLE_REGISTERS[allocation.numAllocated++];
+		}
+
+		if (usage.usesI && allocation.I < 0)
+			allocation.I = ALLOCATABLE_REGISTERS[allocation.numAllocated++];
+
+		allocation.dirtyVars |= usage.writtenVars;
+		allocation.dirtyI |= usage.usesI; // Both ANNN and FX1E write I
+
+		return true;
+	}
+
+	/**
+	 * @brief Emits the machine code of a single translatable opcode.
+	 * @param assembler Assembler to emit into.
+	 * @param allocation Host registers assigned to the CHIP-8 registers.
+	 * @param opcode The opcode to translate.
+	 * @param address Address of the opcode, needed by the skip opcodes.
+	 */
+	void EmitOpcode(Assembler& assembler, const RegisterAllocation& allocation, uint16_t opcode, uint16_t address)
+	{
+		const uint8_t x = (opcode >> 8) & 0xF;
+		const uint8_t y = (opcode >> 4) & 0xF;
+		const uint8_t nn = opcode & 0xFF;
+		const uint16_t nnn = opcode & 0xFFF;
+		const uint16_t nextAddress = address + 2;
+		const uint16_t skipAddress = address + 4;
+
+		switch (opcode >> 12)
+		{
+			// 1NNN. Jumps to address NNN
+			case 0x1:
+			{
+				assembler.MovImmediate(RAX, nnn);
+				break;
+			}
+
+			// 3XNN, 4XNN, 5XY0 and 9XY0. Conditionally skips the next instruction
+			case 0x3:
+			case 0x4:
+			case 0x5:
+			case 0x9:
+			{
+				assembler.MovImmediate(RAX, nextAddress);
+				assembler.MovImmediate(RCX, skipAddress);
+
+				if ((opcode >> 12) == 0x3 || (opcode >> 12) == 0x4)
+					assembler.AluImmediate(EXTENSION_CMP, allocation.Var(x), nn);
+				else
+					assembler.Alu(ALU_CMP, allocation.Var(x), allocation.Var(y));
+
+				const bool skipOnEqual = (opcode >> 12) == 0x3 || (opcode >> 12) == 0x5;
+				assembler.Cmov(skipOnEqual ? CONDITION_E : CONDITION_NE, RAX, RCX);
+				break;
+			}
+
+			// 6XNN. Sets VX to NN
+			case 0x6:
+			{
+				assembler.MovImmediate(allocation.Var(x), nn);
+				break;
+			}
+
+			// 7XNN. Adds NN to VX (carry flag is not changed)
+			case 0x7:
+			{
+				assembler.AluImmediate(EXTENSION_ADD, allocation.Var(x), nn);
+				assembler.MovzxByte(allocation.Var(x), allocation.Var(x));
+				break;
+			}
+
+			case 0x8:
+			{
+				const HostRegister VX = allocation.Var(x);
+				const HostRegister VY = allocation.Var(y);
+				const HostRegister VF = allocation.Var(0xF);
+
+				switch (opcode & 0xF)
+				{
+					// 8XY0. Sets VX to the value of VY
+					case 0x0:
+					{
+						if (x != y)
+							assembler.Alu(ALU_MOV, VX, VY);
+						break;
+					}
+
+					// 8XY1, 8XY2 and 8XY3. Bitwise OR, AND and XOR
+					case 0x1: assembler.Alu(ALU_OR, VX, VY); break;
+					case 0x2: assembler.Alu(ALU_AND, VX, VY); break;
+					case 0x3: assembler.Alu(ALU_XOR, VX, VY); break;
+
+					// 8XY4. Adds VY to VX. Mirrors the interpreter, which only sets VF on overflow
+					case 0x4:
+					{
+						assembler.Alu(ALU_MOV, RAX, VX);
+						assembler.Alu(ALU_ADD, RAX, VY);
+						assembler.AluImmediate(EXTENSION_CMP, RAX, 255);
+						size_t noOverflow = assembler.JumpShort(CONDITION_BE);
+						assembler.MovImmediate(VF, 1);
+						assembler.PatchJump(noOverflow);
+						assembler.Alu(ALU_ADD, VX, VY);
+						assembler.MovzxByte(VX, VX);
+						break;
+					}
+
+					// 8XY5. VY is subtracted from VX, VF set to 1 if VX >= VY
+					case 0x5:
+					{
+						assembler.XorEaxEax();
+						assembler.Alu(ALU_CMP, VX, VY);
+						assembler.SetAl(CONDITION_AE);
+						assembler.Alu(ALU_MOV, VF, RAX);
+						assembler.Alu(ALU_SUB, VX, VY);
+						assembler.MovzxByte(VX, VX);
+						break;
+					}
+
+					// 8XY6. Shifts VX to the right by 1, storing the shifted out bit into VF
+					case 0x6:
+					{
+#ifdef CHIP8_ORIGINAL
+						if (x != y)
+							assembler.Alu(ALU_MOV, VX, VY);
+#endif
+						assembler.Alu(ALU_MOV, RAX, VX);
+						assembler.AluImmediate(EXTENSION_AND, RAX, 1);
+						assembler.Shift(EXTENSION_SHR, VX, 1);
+						assembler.Alu(ALU_MOV, VF, RAX);
+						break;
+					}
+
+					// 8XY7. Sets VX to VY minus VX, VF set to 1 if VY >= VX
+					case 0x7:
+					{
+						assembler.XorEaxEax();
+						assembler.Alu(ALU_CMP, VY, VX);
+						assembler.SetAl(CONDITION_AE);
+						assembler.Alu(ALU_MOV, VF, RAX);
+						assembler.Alu(ALU_MOV, RCX, VY);
+						assembler.Alu(ALU_SUB, RCX, VX);
+						assembler.MovzxByte(VX, RCX);
+						break;
+					}
+
+					// 8XYE. Shifts VX to the left by 1, storing the shifted out bit into VF
+					case 0xE:
+					{
+#ifdef CHIP8_ORIGINAL
+						if (x != y)
+							assembler.Alu(ALU_MOV, VX, VY);
+#endif
+						assembler.Alu(ALU_MOV, RAX, VX);
+						assembler.Shift(EXTENSION_SHR, RAX, 7);
+						assembler.Shift(EXTENSION_SHL, VX, 1);
+						assembler.MovzxByte(VX, VX);
+						assembler.Alu(ALU_MOV, VF, RAX);
+						break;
+					}
+				}
+				break;
+			}
+
+			// ANNN. Sets I to the address NNN.
+			case 0xA:
+			{
+				assembler.MovImmediate(allocation.Index(), nnn);
+				break;
+			}
+
+			// FX1E. Adds VX to I. VF is not affected
+			case 0xF:
+			{
+				assembler.Alu(ALU_ADD, allocation.Index(), allocation.Var(x));
+				assembler.MovzxWord(allocation.Index(), allocation.Index());
+				break;
+			}
+		}
+	}
+
+#if defined(CHIP8_JIT_SUPPORTED) && !defined(_WIN32)
+	/**
+	 * @brief Creates an anonymous file for the code buffer, so it can be mapped twice.
+	 * @return Returns the file descriptor, or -1 if it couldn't be created.
+	 */
+	int CreateCodeFile()
+	{
+#ifdef __linux__
+		return memfd_create("chip8 jit", MFD_CLOEXEC);
+#else
+		// Unique per Jit, even across threads, and unlinked right away so only the mappings keep it alive
+		static atomic<uint32_t> numCreated = 0;
+		const string name = "/chip8-jit-" + to_string(getpid()) + "-" + to_string(numCreated++);
+		const int file = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (file >= 0)
+			shm_unlink(name.c_str());
+
+		return file;
+#endif
+	}
+#endif
+}
+
+Jit::~Jit()
+{
+	Shutdown();
+}
+
+bool Jit::Init()
+{
+#ifdef CHIP8_JIT_SUPPORTED
+	if (codeBuffer != nullptr)
+		return true;
+
+	// The same memory twice, rather than flipping the protection of a single view for every block translated
+#ifdef _WIN32
+	HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_EXECUTE_READWRITE, 0, (DWORD)CODE_BUFFER_SIZE, nullptr);
+	if (mapping != nullptr)
+	{
+		writableCode = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, CODE_BUFFER_SIZE);
+		codeBuffer = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_EXECUTE, 0, 0, CODE_BUFFER_SIZE);
+		CloseHandle(mapping);
+	}
+#else
+	const int file = CreateCodeFile();
+	if (file >= 0)
+	{
+		if (ftruncate(file, CODE_BUFFER_SIZE) == 0)
+		{
+			void* writable = mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+			void* executable = mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC, MAP_SHARED, file, 0);
+			writableCode = writable == MAP_FAILED ? nullptr : (uint8_t*)writable;
+			codeBuffer = executable == MAP_FAILED ? nullptr : (uint8_t*)executable;
+		}
+
+		close(file);
+	}
+#endif
+
+	if (codeBuffer == nullptr || writableCode == nullptr)
+	{
+		Shutdown();
+		return false;
+	}
+
+	Flush();
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Jit::Shutdown()
+{
+	for (uint8_t* view : { codeBuffer, writableCode })
+	{
+		if (view == nullptr)
+			continue;
+
+#ifdef _WIN32
+		UnmapViewOfFile(view);
+#else
+		munmap(view, CODE_BUFFER_SIZE);
+#endif
+	}
+
+	codeBuffer = nullptr;
+	writableCode = nullptr;
+	Flush();
+}
+
+const JitBlock& Jit::GetBlock(uint16_t address, const uint8_t* memory)
+{
+	JitBlock& block = blocks[address];
+	if (!block.translated)
+		block = Translate(address, memory);
+
+	return block;
+}
+
+void Jit::Invalidate(uint16_t address)
+{
+	address &= MEMORY_SIZE - 1;
+
+	// Self-modifying code, start over rather than tracking which blocks overlap the write
+	if (translatedBytes[address])
+	{
+		Flush();
+		return;
+	}
+
+	// Forget failed translations the written byte belongs to, as it might be translatable now
+	blocks[address] = JitBlock();
+	blocks[(address - 1) & (MEMORY_SIZE - 1)] = JitBlock();
+}
+
+void Jit::Flush()
+{
+	fill(blocks.begin(), blocks.end(), JitBlock());
+	fill(translatedBytes.begin(), translatedBytes.end(), false);
+	codeSize = 0;
+}
+
+JitBlock Jit::Translate(uint16_t address, const uint8_t* memory)
+{
+	JitBlock block;
+	block.translated = true;
+
+	if (codeBuffer == nullptr)
+		return block;
+
+	// Gather opcodes, until one ends the block or doesn't fit
+	RegisterAllocation allocation;
+	uint16_t opcodes[MAX_BLOCK_INSTRUCTIONS];
+	uint32_t numOpcodes = 0;
+
+	for (uint32_t pc = address; numOpcodes < MAX_BLOCK_INSTRUCTIONS && pc + 1 < MEMORY_SIZE; pc += 2)
+	{
+		const uint16_t opcode = (memory[pc] << 8) | memory[pc + 1];
+		const RegisterUsage usage = GetRegisterUsage(opcode);
+
+		if (!usage.translatable || !Allocate(allocation, usage))
+			break;
+
+		opcodes[numOpcodes++] = opcode;
+
+		if (usage.endsBlock)
+			break;
+	}
+
+	if (numOpcodes == 0)
+		return block;
+
+	// Out of space, start over. Other blocks' entries get reset, but the caller's entry is still assigned afterwards
+	if (codeSize + MAX_BLOCK_BYTES > CODE_BUFFER_SIZE)
+		Flush();
+
+	// Written through one view, executed through the other
+	uint8_t* code = writableCode + codeSize;
+	Assembler assembler(code);
+
+	// Prologue, only saving what this block actually touches
+	uint32_t usedRegisters = 0;
+	for (int i = 0; i < allocation.numAllocated; i++)
+		usedRegisters |= 1 << ALLOCATABLE_REGISTERS[i];
+
+	if (allocation.numAllocated > 0)
+		usedRegisters |= 1 << VARS_POINTER;
+
+	if (allocation.I >= 0)
+		usedRegisters |= 1 << I_POINTER;
+
+	for (HostRegister reg : CALLEE_SAVED_REGISTERS)
+	{
+		if (usedRegisters & (1 << reg))
+			assembler.Push(reg);
+	}
+
+	if (usedRegisters & (1 << VARS_POINTER))
+		assembler.MovRegReg64(VARS_POINTER, ARGUMENT_0);
+
+	if (usedRegisters & (1 << I_POINTER))
+		assembler.MovRegReg64(I_POINTER, ARGUMENT_1);
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (allocation.vars[i] >= 0)
+			assembler.LoadByte(allocation.Var(i), VARS_POINTER, i);
+	}
+
+	if (allocation.I >= 0)
+		assembler.LoadWord(allocation.Index(), I_POINTER);
+
+	// Body, the last opcode leaves the next program counter in RAX if it ends the block
+	for (uint32_t i = 0; i < numOpcodes; i++)
+		EmitOpcode(assembler, allocation, opcodes[i], (uint16_t)(address + i * 2));
+
+	if (!GetRegisterUsage(opcodes[numOpcodes - 1]).endsBlock)
+		assembler.MovImmediate(RAX, address + numOpcodes * 2);
+
+	// Epilogue
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (allocation.dirtyVars & (1 << i))
+			assembler.StoreByte(VARS_POINTER, i, allocation.Var(i));
+	}
+
+	if (allocation.dirtyI)
+		assembler.StoreWord(I_POINTER, allocation.Index());
+
+	for (int i = (int)size(CALLEE_SAVED_REGISTERS) - 1; i >= 0; i--)
+	{
+		if (usedRegisters & (1 << CALLEE_SAVED_REGISTERS[i]))
+			assembler.Pop(CALLEE_SAVED_REGISTERS[i]);
+	}
+
+	assembler.Ret();
+
+	assert(assembler.GetSize() <= MAX_BLOCK_BYTES);
+	uint8_t* function = codeBuffer + codeSize;
+	codeSize += assembler.GetSize();
+
+#ifdef _WIN32
+	FlushInstructionCache(GetCurrentProcess(), function, assembler.GetSize());
+#endif
+
+	for (uint32_t i = 0; i < numOpcodes * 2; i++)
+		translatedBytes[address + i] = true;
+
+	block.function = (JitBlock::Function)function;
+	block.numInstructions = (uint16_t)numOpcodes;
+
+	return block;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <vector>
+
+// Usings
+using namespace std;
+
+/**
+ * @brief A straight-line run of CHIP-8 opcodes, translated into native code.
+ */
+struct JitBlock
+{
+	/**
+	 * @brief Signature of translated code. Registers and I are read from and written back to the given pointers.
+	 * @param vars Pointer to the Emulator's 16 variable registers.
+	 * @param I Pointer to the Emulator's index register.
+	 * @return Returns the program counter execution should continue at.
+	 */
+	using Function = uint16_t (*)(uint8_t* vars, uint16_t* I);
+
+	Function function = nullptr;	///< Translated code, nullptr if the opcode at this address can't be translated.
+	uint16_t numInstructions = 0;	///< Number of CHIP-8 opcodes the block executes.
+	bool translated = false;		///< Whether a translation of this address has been attempted.
+};
+
+/**
+ * @brief Dynamic recompiler, translating basic blocks of CHIP-8 opcodes into x86-64 machine code.
+ *
+ * A block starts at any address and runs until the first opcode which either ends control flow (1NNN and the skips
+ * 3XNN, 4XNN, 5XY0 and 9XY0, which are included in the block) or can't be translated (calls, returns, BNNN, drawing,
+ * timers, input and memory access, which are left to the interpreter). Within a block, every register it touches lives
+ * in a host register, and is only written back on exit.
+ *
+ * Translated code never writes to memory itself. Emulator notifies the Jit about every memory write through
+ * Invalidate(), which flushes all translated code when a write touches a translated opcode, so self-modifying ROMs
+ * fall back to a fresh translation.
+ *
+ * The code buffer is mapped twice: writable where blocks are translated to, and executable where they run from. No
+ * view is ever both, and translating a block doesn't change the protection of either.
+ *
+ * On hosts other than x86-64 Init() fails, and Emulator keeps interpreting.
+ */
+class Jit
+{
+public:
+	/**
+	 * @brief Destructor, releases the code buffer.
+	 */
+	~Jit();
+
+	/**
+	 * @brief Allocates the code buffer, and maps it both writable and executable.
+	 * @return Returns false if the host isn't supported or memory couldn't be allocated or mapped.
+	 */
+	bool Init();
+
+	/**
+	 * @brief Releases the code buffer and forgets all translated blocks.
+	 */
+	void Shutdown();
+
+	/**
+	 * @brief Gets the block starting at an address, translating it first if that hasn't happened yet.
+	 * @param address Address of the block's first opcode.
+	 * @param memory The Emulator's MEMORY_SIZE bytes of memory, from which opcodes are read.
+	 * @return Returns the JitBlock, whose function is nullptr if the first opcode can't be translated.
+	 */
+	const JitBlock& GetBlock(uint16_t address, const uint8_t* memory);
+
+	/**
+	 * @brief Forgets all translations which include the byte at the given address. Should be called on every write.
+	 * @param address Address of the written byte.
+	 */
+	void Invalidate(uint16_t address);
+
+	/**
+	 * @brief Forgets all translated blocks and resets the code buffer.
+	 */
+	void Flush();
+
+private:
+	/**
+	 * @brief Translates the block starting at an address into the code buffer.
+	 * @param address Address of the block's first opcode.
+	 * @param memory The Emulator's MEMORY_SIZE bytes of memory, from which opcodes are read.
+	 * @return Returns the resulting JitBlock.
+	 */
+	JitBlock Translate(uint16_t address, const uint8_t* memory);
+
+	static const uint32_t MEMORY_SIZE = 4096;				///< Size of CHIP-8's memory, matching Emulator.
+	static const uint32_t MAX_BLOCK_INSTRUCTIONS = 32;		///< Upper bound of opcodes per block, keeping timing granular.
+	static const uint32_t MAX_BLOCK_BYTES = 2048;			///< Upper bound of machine code a single block may produce.
+	static const size_t CODE_BUFFER_SIZE = 1024 * 1024;		///< Size of the executable code buffer.
+
+	uint8_t* codeBuffer = nullptr;							///< Executable view of the memory holding all translated blocks.
+	uint8_t* writableCode = nullptr;						///< Writable view of the same memory, which blocks are translated to.
+	size_t codeSize = 0;									///< Number of bytes in codeBuffer currently in use.
+	vector<JitBlock> blocks = vector<JitBlock>(MEMORY_SIZE);	///< Translated block for every start address.
+	vector<bool> translatedBytes = vector<bool>(MEMORY_SIZE);	///< Whether a byte of memory is part of any translated block.
+};
@@ -0,0 +1,152 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "JitDifferentialTest.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "Emulator.h"
+#include "MachineState.h"
+#include "SteadyClock.h"
+
+static const uint32_t MAX_PROGRAM_OPCODES = 48;		///< Most random opcodes per program, besides those setting up registers.
+static const uint32_t PROGRAM_CYCLES = 256;			///< Opcodes every program runs for, enough to reach its end.
+static const uint32_t MAX_REPORTED_MISMATCHES = 5;	///< Most programs whose MachineStates differ that are printed.
+static const uint16_t ALU_OPERATIONS[] = { 0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0xE };	///< Last nibble of every 8XYN opcode.
+static const uint16_t UNTRANSLATABLE[] = { 0xC000, 0xD005, 0xF033, 0xF055, 0xF065, 0xF029, 0xF015, 0xF007 };	///< Opcodes the Jit leaves to the interpreter, X, Y and NN being filled in.
+
+/**
+ * @brief Prints the registers of a MachineState on a single line.
+ * @param name Name of the ExecutionMode which ran the program.
+ * @param state The MachineState to print.
+ */
+static void PrintRegisters(const char* name, const MachineState& state)
+{
+	std::cout << "  " << name << ": PC=" << std::hex << state.PC << " I=" << state.I << " V=";
+	for (uint32_t x = 0; x < MachineState::NUM_VARS; x++)
+		std::cout << std::setw(2) << std::setfill('0') << (int)state.vars[x] << (x + 1 < MachineState::NUM_VARS ? "," : "");
+
+	std::cout << std::dec << std::setfill(' ') << std::endl;
+}
+
+int RunJitDifferentialTest(uint32_t numPrograms, uint32_t seed)
+{
+	uint32_t random = seed != 0 ? seed : 1;
+	const auto next = [&random]()
+	{
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		return random;
+	};
+
+	// Restored for every program, so only memory a program changed gets decoded and translated again
+	Emulator interpreter("jit-diff", nullptr, nullptr, nullptr, nullptr);
+	Emulator jit("jit-diff", nullptr, nullptr, nullptr, nullptr);
+	for (Emulator* emulator : { &interpreter, &jit })
+	{
+		emulator->SetVerbose(false);
+		emulator->SetSeed(1);
+		if (!emulator->Init(nullptr, 0))
+			return -1;
+	}
+
+	if (!interpreter.SetExecutionMode(ExecutionMode::Interpreter) || !jit.SetExecutionMode(ExecutionMode::Jit))
+		return -1;
+
+	const MachineState bootState = interpreter.GetState();
+	MachineState programState;
+	SteadyClock clock;
+	uint64_t interpreterTime = 0;
+	uint64_t jitTime = 0;
+	uint32_t numMismatches = 0;
+
+	for (uint32_t program = 0; program < numPrograms; program++)
+	{
+		std::vector<uint16_t> opcodes;
+
+		// Every register and I start out random, small values half the time so skips go either way
+		for (uint16_t x = 0; x < MachineState::NUM_VARS; x++)
+			opcodes.push_back(0x6000 | (x << 8) | (next() % 2 ? next() & 0x3 : next() & 0xFF));
+
+		opcodes.push_back(0xA000 | (next() & 0xFFF));
+
+		const uint32_t numOpcodes = (uint32_t)opcodes.size() + 1 + next() % MAX_PROGRAM_OPCODES;
+		while (opcodes.size() < numOpcodes)
+		{
+			// VF is an operand a quarter of the time, to catch it being both an input and the flag
+			const uint16_t x = next() % 4 == 0 ? 0xF : next() & 0xF;
+			const uint16_t y = next() % 4 == 0 ? 0xF : next() & 0xF;
+			const uint16_t nn = next() % 2 ? next() & 0x3 : next() & 0xFF;
+
+			switch (next() % 17)
+			{
+				case 0: case 1: opcodes.push_back(0x6000 | (x << 8) | nn); break;
+				case 2: case 3: opcodes.push_back(0x7000 | (x << 8) | nn); break;
+				case 4: case 5: case 6: case 7: case 8: opcodes.push_back(0x8000 | (x << 8) | (y << 4) | ALU_OPERATIONS[next() % std::size(ALU_OPERATIONS)]); break;
+				case 9: opcodes.push_back(0x3000 | (x << 8) | nn); break;
+				case 10: opcodes.push_back(0x4000 | (x << 8) | nn); break;
+				case 11: opcodes.push_back(0x5000 | (x << 8) | (y << 4)); break;
+				case 12: opcodes.push_back(0x9000 | (x << 8) | (y << 4)); break;
+				case 13: opcodes.push_back(0xA000 | (next() & 0xFFF)); break;
+				case 14: opcodes.push_back(0xF01E | (x << 8)); break;
+
+				// Forward only, so every program ends up at its final jump
+				case 15:
+				{
+					const uint32_t target = (uint32_t)opcodes.size() + 1 + next() % (numOpcodes - (uint32_t)opcodes.size());
+					opcodes.push_back(0x1000 | (Emulator::PROGRAM_START + target * 2));
+					break;
+				}
+
+				// Left to the interpreter, splitting blocks and writing to memory, which may hold the program itself
+				default:
+				{
+					const uint16_t opcode = UNTRANSLATABLE[next() % std::size(UNTRANSLATABLE)];
+					opcodes.push_back(opcode | (x << 8) | ((opcode >> 12) == 0xD ? y << 4 : 0) | ((opcode >> 12) == 0xC ? nn : 0));
+					break;
+				}
+			}
+		}
+
+		opcodes.push_back(0x1000 | (Emulator::PROGRAM_START + numOpcodes * 2));
+
+		programState = bootState;
+		for (size_t i = 0; i < opcodes.size(); i++)
+		{
+			programState.memory[Emulator::PROGRAM_START + i * 2] = (uint8_t)(opcodes[i] >> 8);
+			programState.memory[Emulator::PROGRAM_START + i * 2 + 1] = (uint8_t)opcodes[i];
+		}
+
+		uint64_t startTime = clock.GetTicksNS();
+		interpreter.Restore(programState);
+		interpreter.RunCycles(PROGRAM_CYCLES);
+		interpreterTime += clock.GetTicksNS() - startTime;
+
+		startTime = clock.GetTicksNS();
+		jit.Restore(programState);
+		jit.RunCycles(PROGRAM_CYCLES);
+		jitTime += clock.GetTicksNS() - startTime;
+
+		if (memcmp(&interpreter.GetState(), &jit.GetState(), sizeof(MachineState)) == 0)
+			continue;
+
+		if (++numMismatches <= MAX_REPORTED_MISMATCHES)
+		{
+			std::cout << "Program " << program << " differs:" << std::hex;
+			for (uint16_t opcode : opcodes)
+				std::cout << " " << std::setw(4) << std::setfill('0') << opcode;
+
+			std::cout << std::dec << std::setfill(' ') << std::endl;
+			PrintRegisters("Interpreter", interpreter.GetState());
+			PrintRegisters("Jit", jit.GetState());
+		}
+	}
+
+	std::cout << "Ran " << numPrograms << " random programs for " << PROGRAM_CYCLES << " opcodes each, seed " << seed << std::endl;
+	std::cout << "Interpreter: " << interpreterTime / 1e6 << " ms, Jit including translation: " << jitTime / 1e6 << " ms" << std::endl;
+	std::cout << numPrograms - numMismatches << " of " << numPrograms << " programs ended up in the same MachineState" << std::endl;
+
+	return numMismatches == 0 ? 0 : -1;
+}
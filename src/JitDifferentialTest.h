@@ -0,0 +1,15 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+/**
+ * @brief Generates random programs of mostly translatable opcodes, including skips, forward jumps, VF as an operand and
+ * opcodes writing to memory, and runs every one of them with ExecutionMode::Interpreter and ExecutionMode::Jit, checking
+ * they end up in the same MachineState. Reports the first programs which don't, and how long both took.
+ * @param numPrograms Number of programs to run.
+ * @param seed Seed of the generated programs, the same seed always generating the same programs.
+ * @return Returns 0 if every program ended up in the same MachineState.
+ */
+int RunJitDifferentialTest(uint32_t numPrograms, uint32_t seed);
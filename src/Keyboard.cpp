@@ -0,0 +1,45 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "Keyboard.h"
+#include "SDL3/SDL.h"
+
+const vector<SDL_Scancode> Keyboard::KEY_MAP =
+{
+	{ SDL_SCANCODE_X }, // 0
+	{ SDL_SCANCODE_1 }, // 1
+	{ SDL_SCANCODE_2 }, // 2
+	{ SDL_SCANCODE_3 }, // 3
+	{ SDL_SCANCODE_Q }, // 4
+	{ SDL_SCANCODE_W }, // 5
+	{ SDL_SCANCODE_E }, // 6
+	{ SDL_SCANCODE_A }, // 7
+	{ SDL_SCANCODE_S }, // 8
+	{ SDL_SCANCODE_D }, // 9
+	{ SDL_SCANCODE_Z }, // A
+	{ SDL_SCANCODE_C }, // B
+	{ SDL_SCANCODE_4 }, // C
+	{ SDL_SCANCODE_R }, // D
+	{ SDL_SCANCODE_F }, // E
+	{ SDL_SCANCODE_V }, // F
+};
+
+const SDL_Scancode Keyboard::REWIND_KEY = SDL_SCANCODE_BACKSPACE;
+
+uint16_t Keyboard::GetKeys()
+{
+	const bool* keyState = SDL_GetKeyboardState(nullptr);
+	uint16_t keys = 0;
+
+	for (size_t i = 0; i < KEY_MAP.size(); i++)
+	{
+		SDL_Scancode scancode = KEY_MAP[i];
+		keys |= keyState[scancode] << i;
+	}
+
+	return keys;
+}
+
+bool Keyboard::IsRewindPressed() const
+{
+	return SDL_GetKeyboardState(nullptr)[REWIND_KEY];
+}
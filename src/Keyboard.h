@@ -0,0 +1,35 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <vector>
+#include "InputSource.h"
+
+// Forward declarations
+enum SDL_Scancode;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief InputSource reading CHIP-8's hexadecimal keypad from SDL's keyboard state.
+ */
+class Keyboard : public InputSource
+{
+public:
+	/**
+	 * @brief Gets the keys currently being pressed, based on KEY_MAP.
+	 * @return Returns a bitset of keys being pressed, ranging from [0xF..0x0].
+	 */
+	uint16_t GetKeys() override;
+
+	/**
+	 * @brief Gets whether the rewind hotkey is being held, which isn't part of CHIP-8's keypad.
+	 * @return Returns true while REWIND_KEY is pressed.
+	 */
+	bool IsRewindPressed() const;
+
+private:
+	static const vector<SDL_Scancode> KEY_MAP;		///< Mapping of SDL scan codes in a 0x0 to 0xF fashion.
+	static const SDL_Scancode REWIND_KEY;			///< Key stepping back through the RewindBuffer while held.
+};
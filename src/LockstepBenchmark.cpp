@@ -0,0 +1,78 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "LockstepBenchmark.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "Emulator.h"
+#include "SteadyClock.h"
+#include "LockstepInterpreter.h"
+#include "ScriptedKeys.h"
+
+int RunLockstepBenchmark(const std::string& romPath, ExecutionMode executionMode, uint32_t instructionsPerSecond, uint32_t numFrames, uint32_t numInstances)
+{
+	std::vector<std::unique_ptr<Emulator>> emulators;
+	for (uint32_t i = 0; i < numInstances; i++)
+	{
+		emulators.push_back(std::make_unique<Emulator>(romPath, nullptr, nullptr, nullptr, nullptr));
+		Emulator& emulator = *emulators.back();
+		emulator.SetVerbose(i == 0);
+		if (!emulator.Init() || !emulator.SetExecutionMode(executionMode))
+			return -1;
+
+		emulator.SetInstructionsPerSecond(instructionsPerSecond);
+	}
+
+	const uint32_t clockFrequency = emulators[0]->GetClockFrequency();
+	const uint32_t cyclesPerFrame = clockFrequency / 60 > 0 ? clockFrequency / 60 : 1;
+	LockstepInterpreter lockstep(emulators[0]->GetState(), numInstances, clockFrequency);
+	for (uint32_t i = 0; i < numInstances; i++)
+	{
+		emulators[i]->SetSeed(i + 1);
+		lockstep.SetSeed(i, i + 1);
+	}
+
+	// Instances alternate between the scripted players, so they diverge through their input as well as their seeds
+	SteadyClock clock;
+	uint64_t startTime = clock.GetTicksNS();
+	for (uint32_t i = 0; i < numInstances; i++)
+	{
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			emulators[i]->SetKeys(GetScriptedKeys(i % 2, frame));
+			emulators[i]->RunCycles(cyclesPerFrame);
+		}
+	}
+
+	const uint64_t scalarTime = clock.GetTicksNS() - startTime;
+
+	startTime = clock.GetTicksNS();
+	for (uint32_t frame = 0; frame < numFrames; frame++)
+	{
+		for (uint32_t i = 0; i < numInstances; i++)
+			lockstep.SetKeys(i, GetScriptedKeys(i % 2, frame));
+
+		lockstep.RunCycles(cyclesPerFrame);
+	}
+
+	const uint64_t lockstepTime = clock.GetTicksNS() - startTime;
+
+	uint32_t numInSync = 0;
+	for (uint32_t i = 0; i < numInstances; i++)
+	{
+		MachineState state = emulators[i]->GetState();
+		lockstep.Save(i, state);
+		numInSync += memcmp(&state, &emulators[i]->GetState(), sizeof(MachineState)) == 0 ? 1 : 0;
+	}
+
+	const double numOpcodes = (double)numFrames * cyclesPerFrame * numInstances;
+	std::cout << "Ran " << numInstances << " instances for " << numFrames << " frames each" << std::endl;
+	std::cout << "Emulator per instance: " << scalarTime / 1e6 << " ms, " << scalarTime / numOpcodes << " ns per opcode" << std::endl;
+	std::cout << "LockstepInterpreter (" << LockstepInterpreter::GetInstructionSet() << "): " << lockstepTime / 1e6 << " ms, " << lockstepTime / numOpcodes << " ns per opcode, "
+		<< lockstep.GetNumGroups() / (double)std::max<uint64_t>(lockstep.GetNumSteps(), 1) << " groups per step" << std::endl;
+	std::cout << "Lockstep is " << scalarTime / (double)lockstepTime << "x as fast, " << numInSync << " of " << numInstances << " instances are in sync" << std::endl;
+
+	return numInSync == numInstances ? 0 : -1;
+}
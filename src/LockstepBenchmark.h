@@ -0,0 +1,21 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+// Forward declarations
+enum class ExecutionMode;
+
+/**
+ * @brief Runs many instances of a ROM, each with its own seed and scripted input, first on an Emulator per instance and
+ * then on a single LockstepInterpreter, comparing their throughput and checking they end up in the same MachineStates.
+ * @param romPath Path to the ROM to run.
+ * @param executionMode How the Emulators execute opcodes.
+ * @param instructionsPerSecond Rate of the emulated clock the timers are derived from.
+ * @param numFrames Number of frames every instance runs.
+ * @param numInstances Number of instances to run.
+ * @return Returns 0 if every instance ended up in the same MachineState.
+ */
+int RunLockstepBenchmark(const std::string& romPath, ExecutionMode executionMode, uint32_t instructionsPerSecond, uint32_t numFrames, uint32_t numInstances);
@@ -0,0 +1,835 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+//#define CHIP8_ORIGINAL
+
+// Define to process lanes one at a time, such as to compare with the vector instructions
+//#define CHIP8_LOCKSTEP_SCALAR
+
+#include "LockstepInterpreter.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+// The widest instruction set the compiler targets is used, chip8headless targeting AVX2
+#ifndef CHIP8_LOCKSTEP_SCALAR
+#if defined(__AVX512BW__)
+#define CHIP8_LOCKSTEP_AVX512
+#elif defined(__AVX2__)
+#define CHIP8_LOCKSTEP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHIP8_LOCKSTEP_SSE2
+#endif
+#endif
+
+#if defined(CHIP8_LOCKSTEP_AVX512) || defined(CHIP8_LOCKSTEP_AVX2) || defined(CHIP8_LOCKSTEP_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	// The operations on lanes, all of them on unsigned bytes. Masks have all bits of a lane set, or none. Rows hold a 64
+	// bit Framebuffer row per lane instead, sharing the bitwise operations with bytes when both are the same vector.
+#if defined(CHIP8_LOCKSTEP_AVX512)
+	using Lanes = __m512i;
+	const uint32_t VECTOR_SIZE = 64;
+	const char* const INSTRUCTION_SET = "AVX-512";
+
+	inline Lanes LoadLanes(const uint8_t* lanes) { return _mm512_loadu_si512(lanes); }
+	inline void StoreLanes(uint8_t* lanes, Lanes value) { _mm512_storeu_si512(lanes, value); }
+	inline Lanes Broadcast(uint8_t value) { return _mm512_set1_epi8((char)value); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm512_add_epi8(a, b); }
+	inline Lanes AddSaturated(Lanes a, Lanes b) { return _mm512_adds_epu8(a, b); }
+	inline Lanes Subtract(Lanes a, Lanes b) { return _mm512_sub_epi8(a, b); }
+	inline Lanes SubtractSaturated(Lanes a, Lanes b) { return _mm512_subs_epu8(a, b); }
+	inline Lanes Maximum(Lanes a, Lanes b) { return _mm512_max_epu8(a, b); }
+	inline Lanes And(Lanes a, Lanes b) { return _mm512_and_si512(a, b); }
+	inline Lanes AndNot(Lanes a, Lanes b) { return _mm512_ternarylogic_epi32(a, b, b, 0x0C); } // ~a & b, as GCC warns about _mm512_andnot_si512()
+	inline Lanes Or(Lanes a, Lanes b) { return _mm512_or_si512(a, b); }
+	inline Lanes Xor(Lanes a, Lanes b) { return _mm512_xor_si512(a, b); }
+	inline Lanes ShiftRight(Lanes a) { return _mm512_and_si512(_mm512_srli_epi16(a, 1), _mm512_set1_epi8(0x7F)); }
+	inline Lanes Equal(Lanes a, Lanes b) { return _mm512_movm_epi8(_mm512_cmpeq_epi8_mask(a, b)); }
+	inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm512_mask_blend_epi8(_mm512_movepi8_mask(mask), b, a); }
+
+	using Rows = __m512i;
+	const uint32_t ROWS_PER_VECTOR = 8;
+
+	inline Rows LoadRows(const uint64_t* rows) { return _mm512_loadu_si512(rows); }
+	inline void StoreRows(uint64_t* rows, Rows value) { _mm512_storeu_si512(rows, value); }
+	inline Rows BroadcastRows(uint64_t value) { return _mm512_set1_epi64((long long)value); }
+	inline Rows WidenLanes(const uint8_t* lanes) { return _mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lanes))); }
+	inline Rows WidenMask(const uint8_t* lanes) { return _mm512_cvtepi8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lanes))); }
+	inline Rows ShiftRowsRight(Rows a, Rows counts) { return _mm512_srlv_epi64(a, counts); }
+#elif defined(CHIP8_LOCKSTEP_AVX2)
+	using Lanes = __m256i;
+	const uint32_t VECTOR_SIZE = 32;
+	const char* const INSTRUCTION_SET = "AVX2";
+
+	inline Lanes LoadLanes(const uint8_t* lanes) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes)); }
+	inline void StoreLanes(uint8_t* lanes, Lanes value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), value); }
+	inline Lanes Broadcast(uint8_t value) { return _mm256_set1_epi8((char)value); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_epi8(a, b); }
+	inline Lanes AddSaturated(Lanes a, Lanes b) { return _mm256_adds_epu8(a, b); }
+	inline Lanes Subtract(Lanes a, Lanes b) { return _mm256_sub_epi8(a, b); }
+	inline Lanes SubtractSaturated(Lanes a, Lanes b) { return _mm256_subs_epu8(a, b); }
+	inline Lanes Maximum(Lanes a, Lanes b) { return _mm256_max_epu8(a, b); }
+	inline Lanes And(Lanes a, Lanes b) { return _mm256_and_si256(a, b); }
+	inline Lanes AndNot(Lanes a, Lanes b) { return _mm256_andnot_si256(a, b); }
+	inline Lanes Or(Lanes a, Lanes b) { return _mm256_or_si256(a, b); }
+	inline Lanes Xor(Lanes a, Lanes b) { return _mm256_xor_si256(a, b); }
+	inline Lanes ShiftRight(Lanes a) { return _mm256_and_si256(_mm256_srli_epi16(a, 1), _mm256_set1_epi8(0x7F)); }
+	inline Lanes Equal(Lanes a, Lanes b) { return _mm256_cmpeq_epi8(a, b); }
+	inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_epi8(b, a, mask); }
+
+	using Rows = __m256i;
+	const uint32_t ROWS_PER_VECTOR = 4;
+
+	inline __m128i LoadFourLanes(const uint8_t* lanes) { int32_t value; memcpy(&value, lanes, sizeof(value)); return _mm_cvtsi32_si128(value); }
+	inline Rows LoadRows(const uint64_t* rows) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows)); }
+	inline void StoreRows(uint64_t* rows, Rows value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(rows), value); }
+	inline Rows BroadcastRows(uint64_t value) { return _mm256_set1_epi64x((long long)value); }
+	inline Rows WidenLanes(const uint8_t* lanes) { return _mm256_cvtepu8_epi64(LoadFourLanes(lanes)); }
+	inline Rows WidenMask(const uint8_t* lanes) { return _mm256_cvtepi8_epi64(LoadFourLanes(lanes)); }
+	inline Rows ShiftRowsRight(Rows a, Rows counts) { return _mm256_srlv_epi64(a, counts); }
+#elif defined(CHIP8_LOCKSTEP_SSE2)
+	using Lanes = __m128i;
+	const uint32_t VECTOR_SIZE = 16;
+	const char* const INSTRUCTION_SET = "SSE2";
+
+	inline Lanes LoadLanes(const uint8_t* lanes) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes)); }
+	inline void StoreLanes(uint8_t* lanes, Lanes value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), value); }
+	inline Lanes Broadcast(uint8_t value) { return _mm_set1_epi8((char)value); }
+	inline Lanes Add(Lanes a, Lanes b) { return _mm_add_epi8(a, b); }
+	inline Lanes AddSaturated(Lanes a, Lanes b) { return _mm_adds_epu8(a, b); }
+	inline Lanes Subtract(Lanes a, Lanes b) { return _mm_sub_epi8(a, b); }
+	inline Lanes SubtractSaturated(Lanes a, Lanes b) { return _mm_subs_epu8(a, b); }
+	inline Lanes Maximum(Lanes a, Lanes b) { return _mm_max_epu8(a, b); }
+	inline Lanes And(Lanes a, Lanes b) { return _mm_and_si128(a, b); }
+	inline Lanes AndNot(Lanes a, Lanes b) { return _mm_andnot_si128(a, b); }
+	inline Lanes Or(Lanes a, Lanes b) { return _mm_or_si128(a, b); }
+	inline Lanes Xor(Lanes a, Lanes b) { return _mm_xor_si128(a, b); }
+	inline Lanes ShiftRight(Lanes a) { return _mm_and_si128(_mm_srli_epi16(a, 1), _mm_set1_epi8(0x7F)); }
+	inline Lanes Equal(Lanes a, Lanes b) { return _mm_cmpeq_epi8(a, b); }
+	inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+	using Rows = __m128i;
+	const uint32_t ROWS_PER_VECTOR = 2;
+
+	inline Rows LoadRows(const uint64_t* rows) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows)); }
+	inline void StoreRows(uint64_t* rows, Rows value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(rows), value); }
+	inline Rows BroadcastRows(uint64_t value) { return _mm_set1_epi64x((long long)value); }
+	inline Rows WidenLanes(const uint8_t* lanes) { return _mm_set_epi64x(lanes[1], lanes[0]); }
+	inline Rows WidenMask(const uint8_t* lanes) { return _mm_set_epi64x((int8_t)lanes[1], (int8_t)lanes[0]); }
+	inline Rows ShiftRowsRight(Rows a, Rows counts) { return _mm_unpacklo_epi64(_mm_srl_epi64(a, counts), _mm_srl_epi64(_mm_unpackhi_epi64(a, a), _mm_unpackhi_epi64(counts, counts))); } // SSE2 only shifts both by the same count
+#else
+	using Lanes = uint8_t;
+	const uint32_t VECTOR_SIZE = 1;
+	const char* const INSTRUCTION_SET = "scalar";
+
+	inline Lanes LoadLanes(const uint8_t* lanes) { return *lanes; }
+	inline void StoreLanes(uint8_t* lanes, Lanes value) { *lanes = value; }
+	inline Lanes Broadcast(uint8_t value) { return value; }
+	inline Lanes Add(Lanes a, Lanes b) { return (uint8_t)(a + b); }
+	inline Lanes AddSaturated(Lanes a, Lanes b) { return (uint8_t)min(a + b, 0xFF); }
+	inline Lanes Subtract(Lanes a, Lanes b) { return (uint8_t)(a - b); }
+	inline Lanes SubtractSaturated(Lanes a, Lanes b) { return a > b ? (uint8_t)(a - b) : 0; }
+	inline Lanes Maximum(Lanes a, Lanes b) { return max(a, b); }
+	inline Lanes And(Lanes a, Lanes b) { return a & b; }
+	inline Lanes AndNot(Lanes a, Lanes b) { return (uint8_t)(~a & b); }
+	inline Lanes Or(Lanes a, Lanes b) { return a | b; }
+	inline Lanes Xor(Lanes a, Lanes b) { return a ^ b; }
+	inline Lanes ShiftRight(Lanes a) { return a >> 1; }
+	inline Lanes Equal(Lanes a, Lanes b) { return a == b ? 0xFF : 0; }
+	inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return (uint8_t)((mask & a) | (~mask & b)); }
+
+	using Rows = uint64_t;
+	const uint32_t ROWS_PER_VECTOR = 1;
+
+	inline Rows LoadRows(const uint64_t* rows) { return *rows; }
+	inline void StoreRows(uint64_t* rows, Rows value) { *rows = value; }
+	inline Rows BroadcastRows(uint64_t value) { return value; }
+	inline Rows WidenLanes(const uint8_t* lanes) { return *lanes; }
+	inline Rows WidenMask(const uint8_t* lanes) { return *lanes ? ~0ull : 0; }
+	inline Rows ShiftRowsRight(Rows a, Rows counts) { return a >> counts; }
+	inline Rows And(Rows a, Rows b) { return a & b; }
+	inline Rows AndNot(Rows a, Rows b) { return ~a & b; }
+	inline Rows Or(Rows a, Rows b) { return a | b; }
+	inline Rows Xor(Rows a, Rows b) { return a ^ b; }
+#endif
+
+	/**
+	 * @brief Calls an operation for every vector of lanes overlapping a range of lanes.
+	 * @tparam size Number of lanes per vector, VECTOR_SIZE for bytes and ROWS_PER_VECTOR for Rows.
+	 * @param begin First lane of the range.
+	 * @param end One past the last lane of the range.
+	 * @param operation Called with the first lane of every vector.
+	 */
+	template<uint32_t size = VECTOR_SIZE, typename Operation>
+	inline void ForEachVector(uint32_t begin, uint32_t end, Operation operation)
+	{
+		for (uint32_t lane = begin / size * size; lane < end; lane += size)
+			operation(lane);
+	}
+}
+
+LockstepInterpreter::LockstepInterpreter(const MachineState& state, uint32_t numInstances, uint32_t clockFrequency) :
+	numInstances(numInstances),
+	numLanes((numInstances + LANE_ALIGNMENT - 1) / LANE_ALIGNMENT * LANE_ALIGNMENT),
+	clockFrequency(clockFrequency),
+	cycles(state.cycles),
+	timerAccumulator(state.timerAccumulator),
+	memory((size_t)numInstances * MEMORY_STRIDE),
+	sharedMemory(state.memory, state.memory + MachineState::MEMORY_SIZE),
+	divergedMemory(MachineState::MEMORY_SIZE, false),
+	framebufferRows(Framebuffer::HEIGHT * numLanes),
+	vars(MachineState::NUM_VARS * numLanes),
+	delayTimer(numLanes),
+	soundTimer(numLanes),
+	stackPointer(numLanes),
+	stack(MachineState::STACK_SIZE * numLanes),
+	PC(numLanes),
+	I(numLanes),
+	keys(numLanes),
+	randomState(numLanes, 1),
+	activeMask(numLanes),
+	groupMask(numLanes),
+	skipMask(numLanes),
+	laneGroups(numLanes, NO_GROUP),
+	laneTags(numLanes, NO_TAG),
+	opcodeGroups(0x10000),
+	opcodeStamps(0x10000)
+{
+	fill(activeMask.begin(), activeMask.begin() + numInstances, 0xFF);
+
+	for (uint32_t instance = 0; instance < numInstances; instance++)
+		Load(instance, state);
+}
+
+void LockstepInterpreter::Load(uint32_t instance, const MachineState& state)
+{
+	uint8_t* instanceMemory = &memory[(size_t)instance * MEMORY_STRIDE];
+	memcpy(instanceMemory, state.memory, MachineState::MEMORY_SIZE);
+
+	// Code which differs from what the other instances run can no longer be fetched for all of them at once
+	for (uint32_t address = 0; address < MachineState::MEMORY_SIZE; address++)
+	{
+		if (state.memory[address] != sharedMemory[address])
+			divergedMemory[address] = true;
+	}
+
+	for (int y = 0; y < Framebuffer::HEIGHT; y++)
+		framebufferRows[y * numLanes + instance] = state.framebuffer.GetRow(y);
+
+	for (uint32_t x = 0; x < MachineState::NUM_VARS; x++)
+		Vars(x)[instance] = state.vars[x];
+
+	for (uint32_t i = 0; i < MachineState::STACK_SIZE; i++)
+		stack[i * numLanes + instance] = state.stack[i];
+
+	PC[instance] = state.PC;
+	I[instance] = state.I;
+	keys[instance] = state.keys;
+	stackPointer[instance] = state.stackPointer;
+	delayTimer[instance] = state.delayTimer;
+	soundTimer[instance] = state.soundTimer;
+	randomState[instance] = state.randomState;
+}
+
+void LockstepInterpreter::Save(uint32_t instance, MachineState& state) const
+{
+	memcpy(state.memory, &memory[(size_t)instance * MEMORY_STRIDE], MachineState::MEMORY_SIZE);
+	state.framebuffer = GetFramebuffer(instance);
+	state.cycles = cycles;
+	state.timerAccumulator = timerAccumulator;
+
+	for (uint32_t x = 0; x < MachineState::NUM_VARS; x++)
+		state.vars[x] = GetVars(x)[instance];
+
+	for (uint32_t i = 0; i < MachineState::STACK_SIZE; i++)
+		state.stack[i] = stack[i * numLanes + instance];
+
+	state.PC = PC[instance];
+	state.I = I[instance];
+	state.keys = keys[instance];
+	state.stackPointer = stackPointer[instance];
+	state.delayTimer = delayTimer[instance];
+	state.soundTimer = soundTimer[instance];
+	state.randomState = randomState[instance];
+}
+
+Framebuffer LockstepInterpreter::GetFramebuffer(uint32_t instance) const
+{
+	Framebuffer framebuffer;
+	for (int y = 0; y < Framebuffer::HEIGHT; y++)
+		framebuffer.XorRow(y, framebufferRows[y * numLanes + instance]);
+
+	return framebuffer;
+}
+
+void LockstepInterpreter::RunCycles(uint32_t numCycles)
+{
+	for (uint32_t numExecuted = 0; numExecuted < numCycles; numExecuted++)
+	{
+		if (!Step())
+		{
+			// Idling until the end, as if the remaining opcodes were executed
+			HandleTimers(numCycles - numExecuted);
+			return;
+		}
+
+		HandleTimers(1);
+	}
+}
+
+const char* LockstepInterpreter::GetInstructionSet()
+{
+	return INSTRUCTION_SET;
+}
+
+bool LockstepInterpreter::Step()
+{
+	numSteps++;
+
+	// Usually every instance is at the same PC, running code none of them modified
+	const uint16_t address = PC[0];
+	uint16_t diverged = divergedMemory[address & MEMORY_MASK] | divergedMemory[(address + 1) & MEMORY_MASK];
+	for (uint32_t instance = 0; instance < numInstances; instance++)
+		diverged |= PC[instance] ^ address;
+
+	if (diverged == 0)
+	{
+		const Opcode opcode = (sharedMemory[address & MEMORY_MASK] << 8) | sharedMemory[(address + 1) & MEMORY_MASK];
+
+		// Jumping to itself, or waiting for a key, which none of the instances press
+		if (opcode == (0x1000 | address))
+			return false;
+
+		if ((opcode & 0xF0FF) == 0xF00A)
+		{
+			uint16_t anyKeys = 0;
+			for (uint32_t instance = 0; instance < numInstances; instance++)
+				anyKeys |= keys[instance];
+
+			if (anyKeys == 0)
+				return false;
+		}
+
+		for (uint32_t instance = 0; instance < numInstances; instance++)
+			PC[instance] += 2;
+
+		numGroups++;
+		Execute(opcode, activeMask.data(), 0, numInstances);
+		return true;
+	}
+
+	// Group the instances by the opcode they fetched, instead of by PC, as different code may share opcodes
+	if (++stamp == 0)
+	{
+		fill(opcodeStamps.begin(), opcodeStamps.end(), 0);
+		stamp = 1;
+	}
+
+	groups.clear();
+	for (uint32_t instance = 0; instance < numInstances; instance++)
+	{
+		const uint16_t instanceAddress = PC[instance];
+		const uint16_t first = instanceAddress & MEMORY_MASK;
+		const uint16_t second = (instanceAddress + 1) & MEMORY_MASK;
+		const uint8_t* source = divergedMemory[first] | divergedMemory[second] ? &memory[(size_t)instance * MEMORY_STRIDE] : sharedMemory.data();
+		const Opcode opcode = (source[first] << 8) | source[second];
+		PC[instance] = instanceAddress + 2;
+
+		if (opcodeStamps[opcode] != stamp)
+		{
+			opcodeStamps[opcode] = stamp;
+			opcodeGroups[opcode] = (uint32_t)groups.size();
+			groups.push_back(Group{ opcode, instance, instance });
+		}
+
+		const uint32_t group = opcodeGroups[opcode];
+		groups[group].last = instance;
+		laneGroups[instance] = group;
+		laneTags[instance] = (uint8_t)min<uint32_t>(group, NO_TAG);
+	}
+
+	for (uint32_t group = 0; group < groups.size(); group++)
+	{
+		const uint32_t begin = groups[group].first / VECTOR_SIZE * VECTOR_SIZE;
+		const uint32_t end = min((groups[group].last / VECTOR_SIZE + 1) * VECTOR_SIZE, numLanes);
+
+		// Groups spread over many lanes when instances diverge, so they're masked a vector at a time while they fit a byte
+		if (group < NO_TAG)
+			ForEachVector(begin, end, [&](uint32_t lane) { StoreLanes(&groupMask[lane], Equal(LoadLanes(&laneTags[lane]), Broadcast((uint8_t)group))); });
+		else
+		{
+			for (uint32_t lane = begin; lane < end; lane++)
+				groupMask[lane] = laneGroups[lane] == group ? 0xFF : 0;
+		}
+
+		Execute(groups[group].opcode, groupMask.data(), groups[group].first, groups[group].last + 1);
+	}
+
+	numGroups += groups.size();
+	return true;
+}
+
+void LockstepInterpreter::Execute(Opcode opcode, const uint8_t* mask, uint32_t begin, uint32_t end)
+{
+	const uint16_t nnn = opcode & 0xFFF;
+	const uint8_t nn = opcode & 0xFF;
+	const uint8_t n = opcode & 0xF;
+	const uint8_t x = (opcode >> 8) & 0xF;
+	const uint8_t y = (opcode >> 4) & 0xF;
+	uint8_t* VX = Vars(x);
+	uint8_t* VY = Vars(y);
+	uint8_t* VF = Vars(0xF);
+
+	// Skips only differ in their comparison, the PC of lanes in skipMask moving past the next opcode
+	auto skip = [&](bool skipIfEqual, auto equal)
+	{
+		ForEachVector(begin, end, [&](uint32_t lane)
+		{
+			const Lanes group = LoadLanes(&mask[lane]);
+			StoreLanes(&skipMask[lane], skipIfEqual ? And(equal(lane), group) : AndNot(equal(lane), group));
+		});
+
+		for (uint32_t instance = begin; instance < end; instance++)
+			PC[instance] += skipMask[instance] & 2;
+	};
+
+	switch (opcode >> 12)
+	{
+		case 0x0:
+		{
+			// 00E0. Clears the screen.
+			if (nnn == 0x0E0)
+			{
+				ForEachVector<ROWS_PER_VECTOR>(begin, end, [&](uint32_t lane)
+				{
+					const Rows group = WidenMask(&mask[lane]);
+					for (int row = 0; row < Framebuffer::HEIGHT; row++)
+						StoreRows(&framebufferRows[row * numLanes + lane], AndNot(group, LoadRows(&framebufferRows[row * numLanes + lane])));
+				});
+			}
+			// 00EE. Returns from a subroutine.
+			else if (nnn == 0x0EE)
+			{
+				for (uint32_t instance = begin; instance < end; instance++)
+				{
+					if (mask[instance])
+					{
+						stackPointer[instance]--;
+						PC[instance] = stack[(stackPointer[instance] % MachineState::STACK_SIZE) * numLanes + instance];
+					}
+				}
+			}
+			break;
+		}
+
+		// 1NNN. Jumps to address NNN
+		case 0x1:
+		{
+			for (uint32_t instance = begin; instance < end; instance++)
+				PC[instance] = mask[instance] ? nnn : PC[instance];
+			break;
+		}
+
+		// 2NNN. Calls subroutine at NNN
+		case 0x2:
+		{
+			for (uint32_t instance = begin; instance < end; instance++)
+			{
+				if (mask[instance])
+				{
+					stack[(stackPointer[instance] % MachineState::STACK_SIZE) * numLanes + instance] = PC[instance];
+					stackPointer[instance]++;
+					PC[instance] = nnn;
+				}
+			}
+			break;
+		}
+
+		// 3XNN. Skips the next instruction if VX equals NN
+		case 0x3:
+			skip(true, [&](uint32_t lane) { return Equal(LoadLanes(&VX[lane]), Broadcast(nn)); });
+			break;
+
+		// 4XNN. Skips the next instruction if VX does not equal NN
+		case 0x4:
+			skip(false, [&](uint32_t lane) { return Equal(LoadLanes(&VX[lane]), Broadcast(nn)); });
+			break;
+
+		// 5XY0. Skips the next instruction if VX equals VY
+		case 0x5:
+			skip(true, [&](uint32_t lane) { return Equal(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])); });
+			break;
+
+		// 6XNN. Sets VX to NN
+		case 0x6:
+			ForEachVector(begin, end, [&](uint32_t lane) { StoreLanes(&VX[lane], Select(LoadLanes(&mask[lane]), Broadcast(nn), LoadLanes(&VX[lane]))); });
+			break;
+
+		// 7XNN. Adds NN to VX (carry flag is not changed)
+		case 0x7:
+			ForEachVector(begin, end, [&](uint32_t lane) { StoreLanes(&VX[lane], Select(LoadLanes(&mask[lane]), Add(LoadLanes(&VX[lane]), Broadcast(nn)), LoadLanes(&VX[lane]))); });
+			break;
+
+		case 0x8:
+		{
+			// Every lane in order of the scalar handlers, as X or Y may be F, so VF is reloaded after writing it
+			ForEachVector(begin, end, [&](uint32_t lane)
+			{
+				const Lanes group = LoadLanes(&mask[lane]);
+				const Lanes one = Broadcast(1);
+
+				switch (n)
+				{
+					// 8XY0. Sets VX to the value of VY
+					case 0x0: StoreLanes(&VX[lane], Select(group, LoadLanes(&VY[lane]), LoadLanes(&VX[lane]))); break;
+
+					// 8XY1. Sets VX to VX or VY
+					case 0x1: StoreLanes(&VX[lane], Select(group, Or(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), LoadLanes(&VX[lane]))); break;
+
+					// 8XY2. Sets VX to VX and VY
+					case 0x2: StoreLanes(&VX[lane], Select(group, And(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), LoadLanes(&VX[lane]))); break;
+
+					// 8XY3. Sets VX to VX xor VY
+					case 0x3: StoreLanes(&VX[lane], Select(group, Xor(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), LoadLanes(&VX[lane]))); break;
+
+					// 8XY4. Adds VY to VX. VF is set to 1 when there's an overflow, and left as is when there is not.
+					case 0x4:
+					{
+						// Only an overflowing sum differs from the saturated one
+						const Lanes sum = Add(LoadLanes(&VX[lane]), LoadLanes(&VY[lane]));
+						const Lanes overflow = AndNot(Equal(AddSaturated(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), sum), group);
+						StoreLanes(&VF[lane], Select(overflow, one, LoadLanes(&VF[lane])));
+						StoreLanes(&VX[lane], Select(group, Add(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), LoadLanes(&VX[lane])));
+						break;
+					}
+
+					// 8XY5. VY is subtracted from VX. VF is set to 1 if VX >= VY and 0 if not.
+					case 0x5:
+					{
+						const Lanes greaterOrEqual = Equal(Maximum(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), LoadLanes(&VX[lane]));
+						StoreLanes(&VF[lane], Select(group, And(greaterOrEqual, one), LoadLanes(&VF[lane])));
+						StoreLanes(&VX[lane], Select(group, Subtract(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])), LoadLanes(&VX[lane])));
+						break;
+					}
+
+					// 8XY6. Shifts VX to the right by 1, then stores the least significant bit of VX prior to the shift into VF.
+					case 0x6:
+					{
+#ifdef CHIP8_ORIGINAL
+						StoreLanes(&VX[lane], Select(group, LoadLanes(&VY[lane]), LoadLanes(&VX[lane])));
+#endif
+						const Lanes shiftedBit = And(LoadLanes(&VX[lane]), one);
+						StoreLanes(&VX[lane], Select(group, ShiftRight(LoadLanes(&VX[lane])), LoadLanes(&VX[lane])));
+						StoreLanes(&VF[lane], Select(group, shiftedBit, LoadLanes(&VF[lane])));
+						break;
+					}
+
+					// 8XY7. Sets VX to VY minus VX. VF is set to 1 if VY >= VX and 0 if not.
+					case 0x7:
+					{
+						const Lanes greaterOrEqual = Equal(Maximum(LoadLanes(&VY[lane]), LoadLanes(&VX[lane])), LoadLanes(&VY[lane]));
+						StoreLanes(&VF[lane], Select(group, And(greaterOrEqual, one), LoadLanes(&VF[lane])));
+						StoreLanes(&VX[lane], Select(group, Subtract(LoadLanes(&VY[lane]), LoadLanes(&VX[lane])), LoadLanes(&VX[lane])));
+						break;
+					}
+
+					// 8XYE. Shifts VX to the left by 1, then sets VF to the most significant bit of VX prior to that shift.
+					case 0xE:
+					{
+#ifdef CHIP8_ORIGINAL
+						StoreLanes(&VX[lane], Select(group, LoadLanes(&VY[lane]), LoadLanes(&VX[lane])));
+#endif
+						const Lanes shiftedBit = And(Equal(Maximum(LoadLanes(&VX[lane]), Broadcast(0x80)), LoadLanes(&VX[lane])), one);
+						StoreLanes(&VX[lane], Select(group, Add(LoadLanes(&VX[lane]), LoadLanes(&VX[lane])), LoadLanes(&VX[lane])));
+						StoreLanes(&VF[lane], Select(group, shiftedBit, LoadLanes(&VF[lane])));
+						break;
+					}
+				}
+			});
+			break;
+		}
+
+		// 9XY0. Skips the next instruction if VX does not equal VY.
+		case 0x9:
+			skip(false, [&](uint32_t lane) { return Equal(LoadLanes(&VX[lane]), LoadLanes(&VY[lane])); });
+			break;
+
+		// ANNN. Sets I to the address NNN.
+		case 0xA:
+		{
+			for (uint32_t instance = begin; instance < end; instance++)
+				I[instance] = mask[instance] ? nnn : I[instance];
+			break;
+		}
+
+		// BNNN. Jumps to the address NNN plus V0.
+		case 0xB:
+		{
+#ifdef CHIP8_ORIGINAL
+			const uint8_t* offsets = Vars(0);
+#else
+			const uint8_t* offsets = VX;
+#endif
+			for (uint32_t instance = begin; instance < end; instance++)
+				I[instance] = mask[instance] ? nnn + offsets[instance] : I[instance];
+			break;
+		}
+
+		// CXNN. Sets VX to the result of a bitwise and operation on a random number and NN.
+		case 0xC:
+		{
+			for (uint32_t instance = begin; instance < end; instance++)
+			{
+				if (mask[instance])
+				{
+					// xorshift32, as Emulator::Random()
+					uint32_t random = randomState[instance];
+					random ^= random << 13;
+					random ^= random >> 17;
+					random ^= random << 5;
+					randomState[instance] = random;
+					VX[instance] = (random >> 24) & nn;
+				}
+			}
+			break;
+		}
+
+		// DXYN. Draws a sprite at coordinate (VX, VY), exactly as Framebuffer::Draw().
+		case 0xD:
+		{
+			ForEachVector<ROWS_PER_VECTOR>(begin, end, [&](uint32_t lane)
+			{
+				// Diverged groups are spread thinly over their lanes, most vectors holding none of them
+				uint64_t inGroup = 0;
+				memcpy(&inGroup, &mask[lane], ROWS_PER_VECTOR);
+				if (inGroup == 0)
+					return;
+
+				// Each row of the sprite is placed at the leftmost pixel and shifted right by VX of its lane
+				const Rows shifts = And(WidenLanes(&VX[lane]), BroadcastRows(Framebuffer::WIDTH - 1));
+				Rows collisions = BroadcastRows(0);
+
+				for (uint8_t row = 0; row < n; row++)
+				{
+					// Gathered a lane at a time, as every instance reads its sprite from its own I, and lanes outside the
+					// group or past the bottom edge draw nothing
+					alignas(64) uint64_t sprites[ROWS_PER_VECTOR];
+					uint32_t ys[ROWS_PER_VECTOR];
+					uint32_t sharedY = Framebuffer::HEIGHT;
+					bool isSharedY = true;
+					for (uint32_t i = 0; i < ROWS_PER_VECTOR; i++)
+					{
+						const uint32_t instance = lane + i;
+						ys[i] = VY[instance] % Framebuffer::HEIGHT + row;
+						sprites[i] = 0;
+						if (!mask[instance] || ys[i] >= Framebuffer::HEIGHT)
+						{
+							ys[i] = 0;
+							continue;
+						}
+
+						const uint16_t address = (I[instance] + row) & MEMORY_MASK;
+						const uint8_t* source = divergedMemory[address] ? &memory[(size_t)instance * MEMORY_STRIDE] : sharedMemory.data();
+						sprites[i] = (uint64_t)source[address] << (Framebuffer::WIDTH - 8);
+
+						isSharedY &= sharedY == Framebuffer::HEIGHT || sharedY == ys[i];
+						sharedY = ys[i];
+					}
+
+					if (sharedY == Framebuffer::HEIGHT)
+						continue;
+
+					const Rows bits = ShiftRowsRight(LoadRows(sprites), shifts);
+
+					// Drawing to the same row of every instance, such as while they didn't diverge, the rows are contiguous
+					if (isSharedY)
+					{
+						uint64_t* rows = &framebufferRows[sharedY * numLanes + lane];
+						const Rows drawn = LoadRows(rows);
+						collisions = Or(collisions, And(drawn, bits));
+						StoreRows(rows, Xor(drawn, bits));
+						continue;
+					}
+
+					alignas(64) uint64_t drawn[ROWS_PER_VECTOR];
+					for (uint32_t i = 0; i < ROWS_PER_VECTOR; i++)
+						drawn[i] = framebufferRows[ys[i] * numLanes + lane + i];
+
+					collisions = Or(collisions, And(LoadRows(drawn), bits));
+					StoreRows(drawn, Xor(LoadRows(drawn), bits));
+					for (uint32_t i = 0; i < ROWS_PER_VECTOR; i++)
+						framebufferRows[ys[i] * numLanes + lane + i] = drawn[i];
+				}
+
+				// Only now, as X or Y may be F
+				alignas(64) uint64_t collided[ROWS_PER_VECTOR];
+				StoreRows(collided, collisions);
+				for (uint32_t i = 0; i < ROWS_PER_VECTOR; i++)
+				{
+					if (mask[lane + i])
+						VF[lane + i] = collided[i] != 0;
+				}
+			});
+			break;
+		}
+
+		case 0xE:
+		{
+			// EX9E. Skips the next instruction if the key stored in VX is pressed.
+			// EXA1. Skips the next instruction if the key stored in VX is not pressed.
+			if (nn != 0x9E && nn != 0xA1)
+				break;
+
+			const bool skipIfPressed = nn == 0x9E;
+			for (uint32_t instance = begin; instance < end; instance++)
+			{
+				const uint16_t keyMask = 1 << (VX[instance] & 0xF);
+				if (mask[instance] && ((keys[instance] & keyMask) != 0) == skipIfPressed)
+					PC[instance] += 2;
+			}
+			break;
+		}
+
+		case 0xF:
+		{
+			switch (nn)
+			{
+				// FX07. Sets VX to the value of the delay timer.
+				case 0x07:
+					ForEachVector(begin, end, [&](uint32_t lane) { StoreLanes(&VX[lane], Select(LoadLanes(&mask[lane]), LoadLanes(&delayTimer[lane]), LoadLanes(&VX[lane]))); });
+					break;
+
+				// FX0A. A key press is awaited, and then stored in VX.
+				case 0x0A:
+				{
+					for (uint32_t instance = begin; instance < end; instance++)
+					{
+						if (!mask[instance])
+							continue;
+
+						if (!keys[instance])
+							PC[instance] -= 2;
+						else
+							VX[instance] = (uint8_t)countr_zero(keys[instance]);
+					}
+					break;
+				}
+
+				// FX15. Sets the delay timer to VX.
+				case 0x15:
+					ForEachVector(begin, end, [&](uint32_t lane) { StoreLanes(&delayTimer[lane], Select(LoadLanes(&mask[lane]), LoadLanes(&VX[lane]), LoadLanes(&delayTimer[lane]))); });
+					break;
+
+				// FX18. Sets the sound timer to VX, no instance having audio.
+				case 0x18:
+					ForEachVector(begin, end, [&](uint32_t lane) { StoreLanes(&soundTimer[lane], Select(LoadLanes(&mask[lane]), LoadLanes(&VX[lane]), LoadLanes(&soundTimer[lane]))); });
+					break;
+
+				// FX1E. Adds VX to I. VF is not affected
+				case 0x1E:
+				{
+					for (uint32_t instance = begin; instance < end; instance++)
+						I[instance] += mask[instance] ? VX[instance] : 0;
+					break;
+				}
+
+				// FX29. Sets I to the location of the sprite for the character in VX, exactly as Emulator::OpFX29().
+				case 0x29:
+				{
+					for (uint32_t instance = begin; instance < end; instance++)
+					{
+						if (!mask[instance])
+							continue;
+
+						const uint8_t* instanceMemory = &memory[(size_t)instance * MEMORY_STRIDE];
+						uint8_t characterIndex = instanceMemory[x] & 0xF;
+						characterIndex *= (uint8_t)(0xFF * 0x5);
+						I[instance] = instanceMemory[FONT_START + characterIndex];
+					}
+					break;
+				}
+
+				// FX33. Stores the binary-coded decimal representation of VX at I, I+1 and I+2.
+				case 0x33:
+				{
+					for (uint32_t instance = begin; instance < end; instance++)
+					{
+						if (!mask[instance])
+							continue;
+
+						const uint8_t var = VX[instance];
+						WriteMemory(instance, I[instance], var / 100 % 10);
+						WriteMemory(instance, I[instance] + 1, var / 10 % 10);
+						WriteMemory(instance, I[instance] + 2, var % 10);
+					}
+					break;
+				}
+
+				// FX55. Stores from V0 to VX (including VX) in memory, starting at address I.
+				case 0x55:
+				{
+					for (uint32_t instance = begin; instance < end; instance++)
+					{
+						if (!mask[instance])
+							continue;
+
+						for (uint8_t i = 0; i <= x; i++)
+#ifdef CHIP8_ORIGINAL
+							WriteMemory(instance, I[instance]++, Vars(i)[instance]);
+#else
+							WriteMemory(instance, I[instance] + i, Vars(i)[instance]);
+#endif
+					}
+					break;
+				}
+
+				// FX65. Fills from V0 to VX (including VX) with values from memory, starting at address I.
+				case 0x65:
+				{
+					for (uint32_t instance = begin; instance < end; instance++)
+					{
+						if (!mask[instance])
+							continue;
+
+						const uint8_t* instanceMemory = &memory[(size_t)instance * MEMORY_STRIDE];
+						for (uint8_t i = 0; i <= x; i++)
+#ifdef CHIP8_ORIGINAL
+							Vars(i)[instance] = instanceMemory[I[instance]++ & MEMORY_MASK];
+#else
+							Vars(i)[instance] = instanceMemory[(I[instance] + i) & MEMORY_MASK];
+#endif
+					}
+					break;
+				}
+			}
+			break;
+		}
+	}
+}
+
+void LockstepInterpreter::HandleTimers(uint32_t numCycles)
+{
+	cycles += numCycles;
+
+	timerAccumulator += (uint64_t)numCycles * TIMER_DECREMENT_FREQUENCY;
+	while (timerAccumulator >= clockFrequency)
+	{
+		timerAccumulator -= clockFrequency;
+
+		ForEachVector(0, numInstances, [&](uint32_t lane)
+		{
+			StoreLanes(&delayTimer[lane], SubtractSaturated(LoadLanes(&delayTimer[lane]), Broadcast(1)));
+			StoreLanes(&soundTimer[lane], SubtractSaturated(LoadLanes(&soundTimer[lane]), Broadcast(1)));
+		});
+	}
+}
+
+void LockstepInterpreter::WriteMemory(uint32_t instance, uint16_t address, uint8_t value)
+{
+	address &= MEMORY_MASK;
+	memory[(size_t)instance * MEMORY_STRIDE + address] = value;
+	divergedMemory[address] = true;
+}
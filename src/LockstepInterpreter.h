@@ -0,0 +1,215 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <vector>
+#include "Framebuffer.h"
+#include "MachineState.h"
+
+// Usings
+using Opcode = uint16_t;
+using namespace std;
+
+/**
+ * @brief Interprets many instances of the same ROM at once, executing every opcode across all instances with vector
+ * instructions, for workloads such as fuzzing or Monte Carlo runs which only differ in seeds or input.
+ *
+ * The state of all instances is kept as a structure of arrays: every register, timer, PC, I and stack slot is an array
+ * with one lane per instance, so VX of consecutive instances is contiguous and a single vector instruction updates
+ * VX of as many instances as fit (64 with AVX-512, 32 with AVX2, 16 with SSE2, one at a time without SIMD). The rows
+ * of every Framebuffer are arrays of lanes too, so sprites are shifted and XOR'ed onto as many instances at once as
+ * 64 bit lanes fit in a vector. Memory of every instance remains separate, since instances index it with their own I.
+ *
+ * Every step each instance fetches its next opcode, and instances are grouped by it: a group executes its opcode
+ * once, masking the lanes of instances outside it, so instances whose PC diverged only cost a group of their own for
+ * as long as they run different code. Code shared by all instances is fetched once, until any of them writes to it.
+ * Every instance executes exactly one opcode per step, so all of them share the emulated clock and its timer ticks.
+ *
+ * The outcome is identical to running an Emulator per instance, which Save() allows checking.
+ */
+class LockstepInterpreter
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param state The MachineState every instance starts from, typically a ROM just loaded by an Emulator.
+	 * @param numInstances Number of instances to run.
+	 * @param clockFrequency Rate of the emulated clock the timers are derived from, see Emulator::GetClockFrequency().
+	 */
+	LockstepInterpreter(const MachineState& state, uint32_t numInstances, uint32_t clockFrequency);
+
+	/**
+	 * @brief Replaces the state of a single instance, apart from the emulated clock which all instances share.
+	 * @param instance Index of the instance.
+	 * @param state The MachineState to load.
+	 */
+	void Load(uint32_t instance, const MachineState& state);
+
+	/**
+	 * @brief Copies the state of a single instance, such as to compare it with an Emulator.
+	 * @param instance Index of the instance.
+	 * @param state Set to the instance's MachineState.
+	 */
+	void Save(uint32_t instance, MachineState& state) const;
+
+	/**
+	 * @brief Executes opcodes across all instances.
+	 * @param numCycles Number of opcodes every instance executes.
+	 */
+	void RunCycles(uint32_t numCycles);
+
+	/**
+	 * @brief Seeds the random number generator of a single instance.
+	 * @param instance Index of the instance.
+	 * @param seed The new state of its xorshift generator, 0 being replaced by 1.
+	 */
+	void SetSeed(uint32_t instance, uint32_t seed) { randomState[instance] = seed != 0 ? seed : 1; }
+
+	/**
+	 * @brief Sets the keys being pressed by a single instance.
+	 * @param instance Index of the instance.
+	 * @param keys Bitset of keys being pressed, ranging from [0xF..0x0].
+	 */
+	void SetKeys(uint32_t instance, uint16_t keys) { this->keys[instance] = keys; }
+
+	/**
+	 * @brief Gets the Framebuffer of a single instance, gathered from the rows of all instances.
+	 * @param instance Index of the instance.
+	 * @return Returns a copy of the Framebuffer.
+	 */
+	Framebuffer GetFramebuffer(uint32_t instance) const;
+
+	/**
+	 * @brief Gets a single instance's memory.
+	 * @param instance Index of the instance.
+	 * @return Returns MachineState::MEMORY_SIZE bytes of memory.
+	 */
+	const uint8_t* GetMemory(uint32_t instance) const { return &memory[(size_t)instance * MEMORY_STRIDE]; }
+
+	/**
+	 * @brief Gets a variable register of every instance.
+	 * @param x Index of the register.
+	 * @return Returns the register's lanes, one per instance.
+	 */
+	const uint8_t* GetVars(uint8_t x) const { return &vars[x * numLanes]; }
+
+	/**
+	 * @brief Gets the number of instances.
+	 * @return Returns the number of instances.
+	 */
+	uint32_t GetNumInstances() const { return numInstances; }
+
+	/**
+	 * @brief Gets the number of opcodes every instance executed or skipped since booting.
+	 * @return Returns the number of opcodes.
+	 */
+	uint64_t GetCycles() const { return cycles; }
+
+	/**
+	 * @brief Gets the number of steps executed, each executing one opcode on every instance.
+	 * @return Returns the number of steps.
+	 */
+	uint64_t GetNumSteps() const { return numSteps; }
+
+	/**
+	 * @brief Gets the number of groups executed, which is the number of steps if the instances never diverged.
+	 * @return Returns the number of groups.
+	 */
+	uint64_t GetNumGroups() const { return numGroups; }
+
+	/**
+	 * @brief Gets the instruction set lanes are processed with, as chosen at compile time.
+	 * @return Returns "AVX-512", "AVX2", "SSE2" or "scalar".
+	 */
+	static const char* GetInstructionSet();
+
+	static const uint32_t MEMORY_STRIDE = MachineState::MEMORY_SIZE + 64;	///< Distance between the memory of instances, padded so equal addresses don't share cache sets.
+
+private:
+	/**
+	 * @brief Instances which fetched the same Opcode in the current step.
+	 */
+	struct Group
+	{
+		Opcode opcode = 0;					///< The Opcode all instances in the group fetched.
+		uint32_t first = 0;					///< First instance in the group.
+		uint32_t last = 0;					///< Last instance in the group.
+	};
+
+	/**
+	 * @brief Executes a single step, one opcode on every instance.
+	 * @return Returns false if every instance is idling until the end of RunCycles(), such as jumping to itself.
+	 */
+	bool Step();
+
+	/**
+	 * @brief Executes an Opcode on a group of instances.
+	 * @param opcode The Opcode to execute.
+	 * @param mask One byte per lane, 0xFF for the instances in the group and 0 for all others.
+	 * @param begin First instance which may be in the group.
+	 * @param end One past the last instance which may be in the group.
+	 */
+	void Execute(Opcode opcode, const uint8_t* mask, uint32_t begin, uint32_t end);
+
+	/**
+	 * @brief Advances the emulated clock all instances share, decrementing their timers as emulated time passes.
+	 * @param numCycles Number of opcodes executed or skipped.
+	 */
+	void HandleTimers(uint32_t numCycles);
+
+	/**
+	 * @brief Writes to a single instance's memory, no longer fetching code at that address from sharedMemory.
+	 * @param instance Index of the instance.
+	 * @param address Address to write to, wrapping around the end of memory.
+	 * @param value The value to write.
+	 */
+	void WriteMemory(uint32_t instance, uint16_t address, uint8_t value);
+
+	/**
+	 * @brief Gets a variable register of every instance.
+	 * @param x Index of the register.
+	 * @return Returns the register's lanes, one per instance.
+	 */
+	uint8_t* Vars(uint8_t x) { return &vars[x * numLanes]; }
+
+	static const uint32_t MEMORY_MASK = MachineState::MEMORY_SIZE - 1;	///< Mask wrapping addresses around the end of memory.
+	static const uint32_t FONT_START = 0x50;				///< Start point in memory where font data is copied to.
+	static const uint32_t TIMER_DECREMENT_FREQUENCY = 60;	///< Frequency at which the timers should be decremented.
+	static const uint32_t LANE_ALIGNMENT = 64;				///< Lanes per array are a multiple of this, the widest vector in bytes.
+	static const uint32_t NO_GROUP = UINT32_MAX;			///< Group of padding lanes, which no Opcode is executed on.
+	static const uint8_t NO_TAG = 0xFF;						///< Tag of padding lanes and of groups beyond the first NO_TAG.
+
+	uint32_t numInstances = 0;								///< Number of instances.
+	uint32_t numLanes = 0;									///< Number of lanes per array, numInstances rounded up to whole vectors.
+	uint32_t clockFrequency = 0;							///< Rate of the emulated clock the timers are derived from.
+	uint64_t cycles = 0;									///< Number of opcodes every instance executed or skipped since booting.
+	uint64_t timerAccumulator = 0;							///< Emulated time since the last timer decrement, in opcodes times TIMER_DECREMENT_FREQUENCY.
+	uint64_t numSteps = 0;									///< Number of steps executed.
+	uint64_t numGroups = 0;									///< Number of groups executed.
+
+	vector<uint8_t> memory;									///< Memory of every instance, MEMORY_STRIDE bytes apart.
+	vector<uint8_t> sharedMemory;							///< Memory all instances started from, which code is fetched from while identical.
+	vector<uint8_t> divergedMemory;							///< Whether an address of sharedMemory no longer matches every instance.
+	vector<uint64_t> framebufferRows;						///< Framebuffer of every instance, Framebuffer::HEIGHT arrays of numLanes rows.
+
+	vector<uint8_t> vars;									///< Variable registers, NUM_VARS arrays of numLanes lanes.
+	vector<uint8_t> delayTimer;								///< Delay timer of every instance.
+	vector<uint8_t> soundTimer;								///< Sound timer of every instance.
+	vector<uint8_t> stackPointer;							///< Number of calls on the stack of every instance.
+	vector<uint16_t> stack;									///< Call stacks, STACK_SIZE arrays of numLanes lanes.
+	vector<uint16_t> PC;									///< Program counter of every instance.
+	vector<uint16_t> I;										///< Index register of every instance.
+	vector<uint16_t> keys;									///< Bitset of keys being pressed by every instance.
+	vector<uint32_t> randomState;							///< State of the xorshift generator of every instance.
+
+	vector<uint8_t> activeMask;								///< 0xFF for every lane holding an instance, 0 for padding.
+	vector<uint8_t> groupMask;								///< 0xFF for every lane in the group being executed.
+	vector<uint8_t> skipMask;								///< 0xFF for every lane whose skip opcode skips.
+	vector<Group> groups;									///< Groups of the current step, if the instances diverged.
+	vector<uint32_t> laneGroups;							///< Index in groups of every lane, NO_GROUP for padding.
+	vector<uint8_t> laneTags;								///< Index in groups of every lane as a byte, to compare a vector of lanes at once.
+	vector<uint32_t> opcodeGroups;							///< Group of every Opcode in the current step, valid if its stamp matches.
+	vector<uint32_t> opcodeStamps;							///< Step in which opcodeGroups was last set, per Opcode.
+	uint32_t stamp = 0;										///< Current stamp, incremented whenever instances diverge.
+};
@@ -0,0 +1,39 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <type_traits>
+#include "Framebuffer.h"
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Everything a running ROM can observe, in a single contiguous block without pointers.
+ *
+ * Copying a MachineState is all it takes to snapshot or restore an Emulator, so it must stay trivially copyable: fixed
+ * size arrays only, no containers. Anything derived from it, such as decoded or translated code, lives in the Emulator.
+ */
+struct alignas(64) MachineState
+{
+	static const uint32_t MEMORY_SIZE = 4096;		///< Size of CHIP-8's internal memory in bytes.
+	static const uint32_t NUM_VARS = 16;			///< Number of variable registers, V0 to VF.
+	static const uint32_t STACK_SIZE = 16;			///< Number of nested calls the call stack holds.
+
+	uint8_t memory[MEMORY_SIZE] = {};				///< CHIP-8's core internal memory.
+	Framebuffer framebuffer;						///< CHIP-8's display, drawn to by the 00E0 and DXYN opcodes.
+	uint64_t cycles = 0;							///< Number of opcodes executed or skipped since booting, which input is timed by.
+	uint64_t timerAccumulator = 0;					///< Emulated time since the last timer decrement, in opcodes times TIMER_DECREMENT_FREQUENCY.
+	uint16_t stack[STACK_SIZE] = {};				///< CHIP8's call stack, used for nested calls.
+	uint8_t vars[NUM_VARS] = {};					///< CHIP-8's variable registers.
+	uint16_t PC = 0;								///< CHIP8's program counter, pointing to a specific instruction in memory.
+	uint16_t I = 0;									///< CHIP8's index register, pointing to a specific memory location.
+	uint16_t keys = 0;								///< Bitset of keys being pressed, ranging from [0xF..0x0].
+	uint8_t stackPointer = 0;						///< Number of calls on the stack, wrapping around at STACK_SIZE.
+	uint8_t delayTimer = 0;							///< CHIP8's delay timer, used internally for timing events.
+	uint8_t soundTimer = 0;							///< CHIP8's sound timer, which plays a sound when nonzero.
+	uint32_t randomState = 1;						///< State of the xorshift generator behind CXNN, never zero.
+};
+
+static_assert(is_trivially_copyable_v<MachineState>, "MachineState is snapshot and restored with memcpy");
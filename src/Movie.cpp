@@ -0,0 +1,150 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "Movie.h"
+#include "Emulator.h"
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+bool Movie::StartRecording(const string path, const Emulator& emulator)
+{
+	file.open(path, ios::binary | ios::trunc);
+	if (!file)
+	{
+		cerr << "Could not create movie '" << path << "'" << endl;
+		return false;
+	}
+
+	header = Header();
+	header.romHash = emulator.GetRomHash();
+	header.seed = emulator.GetState().randomState;
+	header.clockFrequency = emulator.GetClockFrequency();
+	events.clear();
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.flush();
+
+	return true;
+}
+
+void Movie::RecordKeys(uint64_t cycle, uint16_t keys)
+{
+	WriteEvent(MovieEvent{ cycle, keys });
+
+	// Keep everything up to the latest input, in case the process doesn't get to stop recording
+	file.flush();
+}
+
+void Movie::StopRecording(uint64_t cycle)
+{
+	if (!file.is_open())
+		return;
+
+	WriteEvent(MovieEvent{ cycle, events.empty() ? (uint16_t)0 : events.back().keys });
+	file.close();
+}
+
+void Movie::WriteEvent(const MovieEvent& event)
+{
+	if (!file.is_open())
+		return;
+
+	uint64_t delta = event.cycle - (events.empty() ? 0 : events.back().cycle);
+	while (delta >= 0x80)
+	{
+		file.put((char)(delta | 0x80));
+		delta >>= 7;
+	}
+
+	file.put((char)delta);
+	file.put((char)(event.keys & 0xFF));
+	file.put((char)(event.keys >> 8));
+
+	events.push_back(event);
+}
+
+bool Movie::Load(const string path)
+{
+	ifstream input(path, ios::binary);
+	if (!input)
+	{
+		cerr << "Could not open movie '" << path << "'" << endl;
+		return false;
+	}
+
+	const vector<uint8_t> data((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+	if (data.size() < sizeof(Header))
+	{
+		cerr << "'" << path << "' is not a movie" << endl;
+		return false;
+	}
+
+	memcpy(&header, data.data(), sizeof(Header));
+	if (header.magic != MAGIC || header.version != VERSION)
+	{
+		cerr << "'" << path << "' is not a movie, or of an unsupported version" << endl;
+		return false;
+	}
+
+	// Decode events, ignoring an incomplete one at the end of a Movie which was still being recorded
+	events.clear();
+	uint64_t cycle = 0;
+	size_t offset = sizeof(Header);
+
+	while (offset < data.size())
+	{
+		uint64_t delta = 0;
+		int shift = 0;
+		while (offset < data.size() && (data[offset] & 0x80) && shift < 63)
+		{
+			delta |= (uint64_t)(data[offset++] & 0x7F) << shift;
+			shift += 7;
+		}
+
+		if (offset + 3 > data.size())
+			break;
+
+		delta |= (uint64_t)data[offset++] << shift;
+		cycle += delta;
+
+		MovieEvent event;
+		event.cycle = cycle;
+		event.keys = data[offset] | (data[offset + 1] << 8);
+		offset += 2;
+		events.push_back(event);
+	}
+
+	return true;
+}
+
+uint64_t Movie::Replay(Emulator& emulator) const
+{
+	if (emulator.GetState().cycles != 0)
+	{
+		cerr << "Movies can only be replayed from boot" << endl;
+		return 0;
+	}
+
+	if (emulator.GetRomHash() != header.romHash)
+	{
+		cerr << "Movie was recorded with a different ROM" << endl;
+		return 0;
+	}
+
+	emulator.SetSeed(header.seed);
+	emulator.SetInstructionsPerSecond(header.clockFrequency);
+
+	for (const MovieEvent& event : events)
+	{
+		// Input only changes in between opcodes, which RunCycles() stops at exactly
+		while (emulator.GetState().cycles < event.cycle)
+		{
+			const uint64_t numCycles = event.cycle - emulator.GetState().cycles;
+			emulator.RunCycles(numCycles < MAX_REPLAY_CYCLES ? (uint32_t)numCycles : MAX_REPLAY_CYCLES);
+		}
+
+		emulator.SetKeys(event.keys);
+	}
+
+	return emulator.GetState().cycles;
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+// Forward declarations
+class Emulator;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief A change of the keys being pressed, at a specific point in emulated time.
+ */
+struct MovieEvent
+{
+	uint64_t cycle = 0;				///< Number of opcodes executed since booting when the keys changed.
+	uint16_t keys = 0;				///< Bitset of keys being pressed from then on, ranging from [0xF..0x0].
+};
+
+/**
+ * @brief Recording of all input given to a ROM from boot onwards, which replays to the exact same MachineState.
+ *
+ * Everything else a ROM observes follows from the ROM itself, the random seed and the rate of the clock the timers are
+ * derived from, which the Movie's header holds. Input is stored as MovieEvents: the number of opcodes since the
+ * previous event, 7 bits per byte, followed by the keys as two bytes. The final event marks where recording stopped.
+ *
+ * Events are written as they're recorded, so a Movie of a crashed process replays up to its last change of input.
+ */
+class Movie
+{
+public:
+	/**
+	 * @brief Starts recording the input of an Emulator which has just booted, writing the Movie to a file.
+	 * @param path Path of the file to write.
+	 * @param emulator The Emulator to record, which hasn't executed any opcodes yet.
+	 * @return Returns false if the file couldn't be created.
+	 */
+	bool StartRecording(const string path, const Emulator& emulator);
+
+	/**
+	 * @brief Records a change of the keys being pressed.
+	 * @param cycle Number of opcodes executed since booting.
+	 * @param keys Bitset of keys being pressed from now on.
+	 */
+	void RecordKeys(uint64_t cycle, uint16_t keys);
+
+	/**
+	 * @brief Records the end of the Movie, and closes the file.
+	 * @param cycle Number of opcodes executed since booting.
+	 */
+	void StopRecording(uint64_t cycle);
+
+	/**
+	 * @brief Loads a Movie from a file.
+	 * @param path Path of the file to read.
+	 * @return Returns false if the file couldn't be read or isn't a Movie.
+	 */
+	bool Load(const string path);
+
+	/**
+	 * @brief Replays the loaded Movie as fast as possible, on an Emulator which has just booted the same ROM.
+	 * @param emulator The Emulator to replay on, which hasn't executed any opcodes yet.
+	 * @return Returns the number of opcodes executed, or 0 if the Movie can't be replayed on this Emulator.
+	 */
+	uint64_t Replay(Emulator& emulator) const;
+
+	/**
+	 * @brief Gets the number of opcodes from boot until recording stopped.
+	 * @return Returns the cycle of the final event, 0 if there are none.
+	 */
+	uint64_t GetNumCycles() const { return events.empty() ? 0 : events.back().cycle; }
+
+	/**
+	 * @brief Gets the rate of the emulated clock the timers were derived from while recording.
+	 * @return Returns the clock frequency in opcodes per second.
+	 */
+	uint32_t GetClockFrequency() const { return header.clockFrequency; }
+
+private:
+	/**
+	 * @brief Writes a single event to the file.
+	 * @param event The MovieEvent to write.
+	 */
+	void WriteEvent(const MovieEvent& event);
+
+	/**
+	 * @brief Start of the file.
+	 */
+	struct Header
+	{
+		uint32_t magic = MAGIC;			///< Always MAGIC.
+		uint32_t version = VERSION;		///< VERSION the file was written with.
+		uint64_t romHash = 0;			///< HashRom() of the recorded ROM.
+		uint32_t seed = 0;				///< State of the random number generator at boot.
+		uint32_t clockFrequency = 0;	///< Rate of the emulated clock the timers were derived from.
+	};
+
+	static const uint32_t MAGIC = 0x4D385043;		///< "CP8M" in little endian.
+	static const uint32_t VERSION = 1;				///< Increment whenever the file format changes.
+	static const uint32_t MAX_REPLAY_CYCLES = 1 << 20;	///< Maximum number of opcodes replayed by a single Emulator::RunCycles().
+
+	Header header;						///< Header of the loaded or recorded Movie.
+	vector<MovieEvent> events;			///< Events of the loaded or recorded Movie, oldest first.
+	ofstream file;						///< File being recorded to.
+};
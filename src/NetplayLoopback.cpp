@@ -0,0 +1,95 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "NetplayLoopback.h"
+#include <iostream>
+#include <cstring>
+#include "Emulator.h"
+#include "SteadyClock.h"
+#include "NetplaySession.h"
+#include "ScriptedKeys.h"
+
+/**
+ * @brief Clock which only moves when told to, so sessions over loopback play faster than real time.
+ */
+class ManualClock : public Clock
+{
+public:
+	uint64_t GetTicksNS() override { return ticks; }
+
+	/**
+	 * @brief Moves the clock forward.
+	 * @param duration Time to move forward by, in nanoseconds.
+	 */
+	void Advance(uint64_t duration) { ticks += duration; }
+
+private:
+	uint64_t ticks = 0;					///< Current time, in nanoseconds.
+};
+
+int RunNetplayLoopback(const std::string& romPath, ExecutionMode executionMode, uint32_t instructionsPerSecond, uint32_t numFrames, uint32_t latencyMS, uint32_t lossPercent)
+{
+	static const uint64_t FRAME_NS = 1000000000 / 60;
+	static const uint64_t TICK_NS = 1000000;
+
+	Emulator host(romPath, nullptr, nullptr, nullptr, nullptr);
+	Emulator guest(romPath, nullptr, nullptr, nullptr, nullptr);
+	if (!host.Init() || !guest.Init() || !host.SetExecutionMode(executionMode) || !guest.SetExecutionMode(executionMode))
+		return -1;
+
+	// Seeded the same every run, so the outcome can be compared between links
+	host.SetSeed(1);
+	host.SetInstructionsPerSecond(instructionsPerSecond);
+
+	ManualClock clock;
+	NetplaySession sessions[2] = { NetplaySession(host, clock), NetplaySession(guest, clock) };
+	for (NetplaySession& session : sessions)
+		session.SetSimulatedLink(latencyMS, lossPercent);
+
+	if (!sessions[0].Host(0) || !sessions[1].Join("127.0.0.1", sessions[0].GetPort()))
+		return -1;
+
+	SteadyClock steadyClock;
+	const uint64_t startTime = steadyClock.GetTicksNS();
+	const uint64_t maxTime = numFrames * FRAME_NS * 4 + 10000000000ull;
+	uint64_t nextFrameTimes[2] = {};
+
+	while (sessions[0].GetConfirmedFrame() < numFrames || sessions[1].GetConfirmedFrame() < numFrames)
+	{
+		clock.Advance(TICK_NS);
+		if (clock.GetTicksNS() > maxTime)
+		{
+			std::cerr << "Players got stuck at frames " << sessions[0].GetFrame() << " and " << sessions[1].GetFrame() << std::endl;
+			return -1;
+		}
+
+		for (int player = 0; player < 2; player++)
+		{
+			NetplaySession& session = sessions[player];
+			session.Poll();
+
+			if (session.GetFrame() >= numFrames || clock.GetTicksNS() < nextFrameTimes[player])
+				continue;
+
+			if (session.AdvanceFrame(GetScriptedKeys(player, session.GetFrame())))
+				nextFrameTimes[player] += FRAME_NS;
+			else
+				nextFrameTimes[player] = clock.GetTicksNS();
+		}
+	}
+
+	const uint64_t elapsed = steadyClock.GetTicksNS() - startTime;
+	const bool inSync = memcmp(&host.GetState(), &guest.GetState(), sizeof(MachineState)) == 0;
+
+	std::cout << "Played " << numFrames << " frames over loopback with " << latencyMS << " ms latency and " << lossPercent << "% loss in " << elapsed / 1e6 << " ms" << std::endl;
+	for (int player = 0; player < 2; player++)
+	{
+		const NetplaySession& session = sessions[player];
+		std::cout << "Player " << player + 1 << " rolled back " << session.GetNumRollbacks() << " times, simulating " << session.GetNumResimulatedFrames()
+			<< " frames again, and sent " << session.GetNumBytesSent() / (double)numFrames << " bytes per frame" << std::endl;
+	}
+
+	std::cout << "Players are " << (inSync ? "in sync" : "OUT OF SYNC") << std::endl;
+	std::cout << "Framebuffer hash: " << std::hex << host.GetFramebuffer().GetHash() << std::dec << std::endl;
+
+	return inSync ? 0 : -1;
+}
@@ -0,0 +1,22 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+// Forward declarations
+enum class ExecutionMode;
+
+/**
+ * @brief Plays a ROM with two NetplaySessions over loopback, each running its own Emulator, until both confirmed all
+ * input, then checks whether they ended up in the exact same MachineState.
+ * @param romPath Path to the ROM to play.
+ * @param executionMode How both Emulators execute opcodes.
+ * @param instructionsPerSecond Rate of the host's emulated clock, which the player joining adopts.
+ * @param numFrames Number of frames to play.
+ * @param latencyMS Latency added to every packet, in milliseconds.
+ * @param lossPercent Percentage of packets dropped.
+ * @return Returns 0 if both players ended up in sync.
+ */
+int RunNetplayLoopback(const std::string& romPath, ExecutionMode executionMode, uint32_t instructionsPerSecond, uint32_t numFrames, uint32_t latencyMS, uint32_t lossPercent);
@@ -0,0 +1,348 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "NetplaySession.h"
+#include "Emulator.h"
+#include "Clock.h"
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	/**
+	 * @brief Appends a value to a packet in little endian, regardless of the host's byte order.
+	 * @param output Where to write the value, moved past it.
+	 * @param value The value to write.
+	 * @param size Number of bytes to write.
+	 */
+	inline void WriteBytes(uint8_t*& output, uint64_t value, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+			*output++ = (uint8_t)(value >> (i * 8));
+	}
+
+	/**
+	 * @brief Reads a value written by WriteBytes().
+	 * @param input Where to read the value, moved past it.
+	 * @param size Number of bytes to read.
+	 * @return Returns the value.
+	 */
+	inline uint64_t ReadBytes(const uint8_t*& input, size_t size)
+	{
+		uint64_t value = 0;
+		for (size_t i = 0; i < size; i++)
+			value |= (uint64_t)*input++ << (i * 8);
+
+		return value;
+	}
+}
+
+NetplaySession::NetplaySession(Emulator& emulator, Clock& clock) :
+	emulator(emulator),
+	clock(clock),
+	seed(emulator.GetState().randomState),
+	snapshots(MAX_ROLLBACK_FRAMES)
+{
+}
+
+bool NetplaySession::Host(uint16_t port)
+{
+	isHost = true;
+	if (!socket.Open(port))
+		return false;
+
+	cout << "Hosting on port " << socket.GetPort() << ", waiting for a player to join" << endl;
+	return true;
+}
+
+bool NetplaySession::Join(const string host, uint16_t port)
+{
+	isHost = false;
+	if (!socket.Open(0) || !socket.SetPeer(host, port))
+		return false;
+
+	cout << "Joining " << host << ":" << port << endl;
+	SendHello();
+	return true;
+}
+
+void NetplaySession::SetSimulatedLink(uint32_t latencyMS, uint32_t lossPercent)
+{
+	simulatedLatency = latencyMS * 1000000ull;
+	simulatedLoss = lossPercent < 100 ? lossPercent : 100;
+}
+
+bool NetplaySession::Run(uint16_t localKeys)
+{
+	bool changed = Poll();
+
+	const uint64_t now = clock.GetTicksNS();
+	while (now >= nextFrameTime)
+	{
+		// Waiting for the remote player, resume pacing from whenever it's possible again rather than catching up
+		if (!AdvanceFrame(localKeys))
+		{
+			nextFrameTime = now;
+			break;
+		}
+
+		nextFrameTime += FRAME_NS;
+		changed = true;
+
+		// Both see each other behind by the latency, so only the difference between those is what we're ahead by
+		if (frame - lastTimeSyncFrame >= TIME_SYNC_INTERVAL && (GetFrameAdvantage() - remoteAdvantage) / 2 >= 1)
+		{
+			nextFrameTime += FRAME_NS;
+			lastTimeSyncFrame = frame;
+		}
+	}
+
+	return changed;
+}
+
+bool NetplaySession::Poll()
+{
+	const uint64_t now = clock.GetTicksNS();
+
+	while (!delayedPackets.empty() && delayedPackets.front().sendTime <= now)
+	{
+		socket.Send(delayedPackets.front().data.data(), delayedPackets.front().data.size());
+		delayedPackets.pop_front();
+	}
+
+	uint8_t packet[MAX_PACKET_SIZE];
+	while (size_t size = socket.Receive(packet, sizeof(packet)))
+	{
+		lastReceiveTime = now;
+		HandlePacket(packet, size);
+	}
+
+	if (connected && now - lastReceiveTime > TIMEOUT_NS)
+	{
+		cerr << "Lost connection to the remote player" << endl;
+		connected = false;
+	}
+
+	// Keep the remote player informed while no frames are simulated, so neither waits on the other forever
+	if (now - lastSendTime >= (connected ? KEEPALIVE_INTERVAL_NS : HELLO_INTERVAL_NS))
+	{
+		if (!remoteConnected && socket.HasPeer())
+			SendHello();
+
+		if (connected)
+			SendInput();
+	}
+
+	return Rollback();
+}
+
+bool NetplaySession::AdvanceFrame(uint16_t localKeys)
+{
+	// The snapshot of the oldest unconfirmed frame, and the local input the remote player lacks, mustn't be overwritten
+	if (!connected || frame >= confirmedRemoteFrames + MAX_ROLLBACK_FRAMES || frame >= remoteAckedFrames + INPUT_WINDOW)
+		return false;
+
+	localInputs[frame % INPUT_WINDOW] = localKeys;
+	SimulateFrame(frame++);
+	SendInput();
+
+	return true;
+}
+
+void NetplaySession::Send(const uint8_t* data, size_t size)
+{
+	lastSendTime = clock.GetTicksNS();
+	numBytesSent += size;
+
+	if (simulatedLoss > 0)
+	{
+		lossRandomState ^= lossRandomState << 13;
+		lossRandomState ^= lossRandomState >> 17;
+		lossRandomState ^= lossRandomState << 5;
+		if (lossRandomState % 100 < simulatedLoss)
+			return;
+	}
+
+	if (simulatedLatency > 0)
+		delayedPackets.push_back(DelayedPacket{ lastSendTime + simulatedLatency, vector<uint8_t>(data, data + size) });
+	else
+		socket.Send(data, size);
+}
+
+void NetplaySession::SendHello()
+{
+	uint8_t packet[MAX_PACKET_SIZE];
+	uint8_t* output = packet;
+	WriteBytes(output, MAGIC, 4);
+	WriteBytes(output, (uint8_t)PacketType::Hello, 1);
+	WriteBytes(output, emulator.GetRomHash(), 8);
+	WriteBytes(output, seed, 4);
+	WriteBytes(output, emulator.GetClockFrequency(), 4);
+
+	Send(packet, output - packet);
+}
+
+void NetplaySession::SendInput()
+{
+	uint8_t packet[MAX_PACKET_SIZE];
+	uint8_t* output = packet;
+	WriteBytes(output, MAGIC, 4);
+	WriteBytes(output, (uint8_t)PacketType::Input, 1);
+	WriteBytes(output, remoteAckedFrames, 4);
+	WriteBytes(output, confirmedRemoteFrames, 4);
+	WriteBytes(output, (uint8_t)(int8_t)max(-128, min(127, GetFrameAdvantage())), 1);
+
+	uint8_t* numRuns = output++;
+	*numRuns = 0;
+
+	// Keys are held for many frames at a time, so send runs of them
+	for (uint32_t i = remoteAckedFrames; i < frame; )
+	{
+		const uint16_t keys = localInputs[i % INPUT_WINDOW];
+		uint32_t runLength = 1;
+		while (i + runLength < frame && localInputs[(i + runLength) % INPUT_WINDOW] == keys)
+			runLength++;
+
+		WriteBytes(output, runLength, 1);
+		WriteBytes(output, keys, 2);
+		(*numRuns)++;
+		i += runLength;
+	}
+
+	Send(packet, output - packet);
+}
+
+void NetplaySession::HandlePacket(const uint8_t* data, size_t size)
+{
+	const uint8_t* input = data;
+	if (size < 5 || ReadBytes(input, 4) != MAGIC)
+		return;
+
+	const PacketType type = (PacketType)ReadBytes(input, 1);
+	if (type == PacketType::Hello && size == 21)
+	{
+		const uint64_t romHash = ReadBytes(input, 8);
+		const uint32_t hostSeed = (uint32_t)ReadBytes(input, 4);
+		const uint32_t clockFrequency = (uint32_t)ReadBytes(input, 4);
+
+		if (romHash != emulator.GetRomHash())
+		{
+			cerr << "The remote player is running a different ROM" << endl;
+			return;
+		}
+
+		// Whoever joins boots exactly like the host, before simulating a single frame
+		if (!isHost && !connected)
+		{
+			emulator.SetSeed(hostSeed);
+			emulator.SetInstructionsPerSecond(clockFrequency);
+		}
+
+		// The host answers every Hello, as its answer may have been lost
+		if (isHost)
+			SendHello();
+		else
+			remoteConnected = true;
+
+		if (!connected)
+			cout << "Connected, playing as player " << (isHost ? 1 : 2) << endl;
+
+		connected = true;
+	}
+	else if (type == PacketType::Input && size >= 15)
+	{
+		const uint32_t startFrame = (uint32_t)ReadBytes(input, 4);
+		const uint32_t ackedFrames = (uint32_t)ReadBytes(input, 4);
+		const int32_t advantage = (int8_t)ReadBytes(input, 1);
+		const uint32_t numRuns = (uint32_t)ReadBytes(input, 1);
+		if (size != 15 + numRuns * 3 || !connected)
+			return;
+
+		uint32_t numFrames = 0;
+		uint16_t keys[INPUT_WINDOW];
+		for (uint32_t i = 0; i < numRuns; i++)
+		{
+			const uint32_t runLength = (uint32_t)ReadBytes(input, 1);
+			const uint16_t runKeys = (uint16_t)ReadBytes(input, 2);
+			if (numFrames + runLength > INPUT_WINDOW)
+				return;
+
+			for (uint32_t j = 0; j < runLength; j++)
+				keys[numFrames++] = runKeys;
+		}
+
+		remoteConnected = true;
+
+		// Packets may arrive out of order, only the newest tell where the remote player is
+		if (startFrame + numFrames >= remoteFrame)
+		{
+			remoteFrame = startFrame + numFrames;
+			remoteAdvantage = advantage;
+		}
+
+		if (ackedFrames > remoteAckedFrames && ackedFrames <= frame)
+			remoteAckedFrames = ackedFrames;
+
+		// Only take input following the confirmed input, anything past a gap is sent again anyway
+		for (uint32_t i = 0; i < numFrames; i++)
+		{
+			const uint32_t inputFrame = startFrame + i;
+			if (inputFrame < confirmedRemoteFrames)
+				continue;
+
+			if (inputFrame > confirmedRemoteFrames || inputFrame >= frame + INPUT_WINDOW - MAX_ROLLBACK_FRAMES)
+				break;
+
+			remoteInputs[inputFrame % INPUT_WINDOW] = keys[i];
+			confirmedRemoteFrames++;
+
+			if (inputFrame < frame && predictedInputs[inputFrame % INPUT_WINDOW] != keys[i] && inputFrame < mispredictedFrame)
+				mispredictedFrame = inputFrame;
+		}
+	}
+}
+
+bool NetplaySession::Rollback()
+{
+	if (mispredictedFrame == NO_FRAME)
+		return false;
+
+	emulator.Restore(snapshots[mispredictedFrame % MAX_ROLLBACK_FRAMES]);
+
+	// These frames already beeped when they were first simulated
+	emulator.SetSpeculating(true);
+	for (uint32_t i = mispredictedFrame; i < frame; i++)
+		SimulateFrame(i);
+	emulator.SetSpeculating(false);
+
+	numRollbacks++;
+	numResimulatedFrames += frame - mispredictedFrame;
+	mispredictedFrame = NO_FRAME;
+
+	return true;
+}
+
+void NetplaySession::SimulateFrame(uint32_t simulatedFrame)
+{
+	emulator.Snapshot(snapshots[simulatedFrame % MAX_ROLLBACK_FRAMES]);
+
+	const uint16_t remoteKeys = GetRemoteKeys(simulatedFrame);
+	predictedInputs[simulatedFrame % INPUT_WINDOW] = remoteKeys;
+
+	// Both players share the keypad, usually each using their own keys
+	emulator.SetKeys(localInputs[simulatedFrame % INPUT_WINDOW] | remoteKeys);
+
+	// Frames start at whole opcodes, spread evenly so no fraction of the clock rate is lost
+	const uint64_t clockFrequency = emulator.GetClockFrequency();
+	const uint64_t startCycle = simulatedFrame * clockFrequency / FRAMES_PER_SECOND;
+	const uint64_t endCycle = (simulatedFrame + 1ull) * clockFrequency / FRAMES_PER_SECOND;
+	emulator.RunCycles((uint32_t)(endCycle - startCycle));
+}
+
+uint16_t NetplaySession::GetRemoteKeys(uint32_t inputFrame) const
+{
+	if (inputFrame < confirmedRemoteFrames)
+		return remoteInputs[inputFrame % INPUT_WINDOW];
+
+	// The remote player most likely still presses what they last pressed
+	return confirmedRemoteFrames > 0 ? remoteInputs[(confirmedRemoteFrames - 1) % INPUT_WINDOW] : 0;
+}
@@ -0,0 +1,244 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include "MachineState.h"
+#include "UdpSocket.h"
+
+// Forward declarations
+class Emulator;
+class Clock;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Two players sharing a ROM over UDP, each peer running its own Emulator, rolling back to hide latency.
+ *
+ * Peers only exchange the keys each of them pressed per frame, the Emulator being fed the keys of both. Local input
+ * is used right away, while the remote player is predicted to keep pressing the keys they last pressed. When their
+ * actual input turns out to differ, the Emulator is restored to the snapshot of that frame and the frames since are
+ * simulated again, which is cheap as a frame is only a dozen opcodes. Every packet repeats all input the remote
+ * player hasn't acknowledged yet, so lost packets need no retransmission. As keys are held for many frames, that input
+ * is sent as runs of 3 bytes each, so packets are only a couple of dozen bytes even when rolling back far.
+ *
+ * The host's random seed and clock rate are adopted by the peer that joins, as both Emulators must boot identically.
+ * Outgoing packets can be delayed and dropped on purpose, to test the session over loopback.
+ */
+class NetplaySession
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param emulator The Emulator to drive, which has just booted the same ROM as the remote player's.
+	 * @param clock The Clock frames are paced by.
+	 */
+	NetplaySession(Emulator& emulator, Clock& clock);
+
+	/**
+	 * @brief Waits for a remote player to join, who becomes the peer.
+	 * @param port Port to accept the remote player on, or 0 to let the OS pick one.
+	 * @return Returns false if the port couldn't be opened.
+	 */
+	bool Host(uint16_t port);
+
+	/**
+	 * @brief Joins a remote player who is hosting a session.
+	 * @param host Name or address of the host.
+	 * @param port Port the host accepts players on.
+	 * @return Returns false if the host couldn't be resolved.
+	 */
+	bool Join(const string host, uint16_t port);
+
+	/**
+	 * @brief Delays and drops outgoing packets, to simulate a worse link than the actual one.
+	 * @param latencyMS Delay added to every packet, in milliseconds.
+	 * @param lossPercent Percentage of packets dropped, ranging from [0..100].
+	 */
+	void SetSimulatedLink(uint32_t latencyMS, uint32_t lossPercent);
+
+	/**
+	 * @brief Exchanges input with the remote player, rolling back if needed, and simulates all frames that are due.
+	 * The local player is ahead of the remote one by as many frames as it takes input to arrive, and slows down when
+	 * it's further ahead than the remote player is, so neither has to roll back more than the other.
+	 * @param localKeys Bitset of keys the local player currently presses.
+	 * @return Returns true if the Framebuffer should be presented again.
+	 */
+	bool Run(uint16_t localKeys);
+
+	/**
+	 * @brief Exchanges input with the remote player without simulating new frames, rolling back if needed.
+	 * @return Returns true if frames were rolled back and simulated again.
+	 */
+	bool Poll();
+
+	/**
+	 * @brief Simulates a single frame, using the remote player's input if it already arrived and predicting it
+	 * otherwise, then sends the local input.
+	 * @param localKeys Bitset of keys the local player presses during this frame.
+	 * @return Returns false if not connected yet, or too far ahead of the remote player to roll back if needed.
+	 */
+	bool AdvanceFrame(uint16_t localKeys);
+
+	/**
+	 * @brief Whether both peers agreed to play and are still exchanging input.
+	 * @return Returns true if frames can be simulated.
+	 */
+	bool IsConnected() const { return connected; }
+
+	/**
+	 * @brief Gets the port the session is bound to, for the remote player to join on.
+	 * @return Returns the port.
+	 */
+	uint16_t GetPort() const { return socket.GetPort(); }
+
+	/**
+	 * @brief Gets the number of frames simulated since boot.
+	 * @return Returns the number of frames.
+	 */
+	uint32_t GetFrame() const { return frame; }
+
+	/**
+	 * @brief Gets the number of frames since boot for which the input of both players is known, which will never be
+	 * rolled back.
+	 * @return Returns the number of frames.
+	 */
+	uint32_t GetConfirmedFrame() const { return confirmedRemoteFrames < frame ? confirmedRemoteFrames : frame; }
+
+	/**
+	 * @brief Gets the number of times the remote player's input was mispredicted.
+	 * @return Returns the number of rollbacks.
+	 */
+	uint32_t GetNumRollbacks() const { return numRollbacks; }
+
+	/**
+	 * @brief Gets the number of frames simulated again after rolling back.
+	 * @return Returns the number of frames.
+	 */
+	uint64_t GetNumResimulatedFrames() const { return numResimulatedFrames; }
+
+	/**
+	 * @brief Gets the number of bytes sent to the remote player, including dropped packets.
+	 * @return Returns the number of bytes.
+	 */
+	uint64_t GetNumBytesSent() const { return numBytesSent; }
+
+	static const uint32_t MAX_ROLLBACK_FRAMES = 16;		///< Number of frames that can be rolled back, as many snapshots being kept.
+	static const uint32_t INPUT_WINDOW = 64;			///< Number of frames of input kept per player, and sent per packet at most.
+
+private:
+	/**
+	 * @brief Types of packets, following the magic.
+	 */
+	enum class PacketType : uint8_t
+	{
+		Hello,		///< Asks to play, carrying the ROM's hash, random seed and clock rate.
+		Input,		///< Carries the sender's unacknowledged input and acknowledges the receiver's.
+	};
+
+	/**
+	 * @brief A packet held back by the simulated link.
+	 */
+	struct DelayedPacket
+	{
+		uint64_t sendTime;					///< Host time at which to actually send, in nanoseconds.
+		vector<uint8_t> data;				///< The packet.
+	};
+
+	/**
+	 * @brief Sends a packet through the simulated link.
+	 * @param data The packet.
+	 * @param size Size of the packet in bytes.
+	 */
+	void Send(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Sends a Hello packet.
+	 */
+	void SendHello();
+
+	/**
+	 * @brief Sends all local input the remote player hasn't acknowledged.
+	 */
+	void SendInput();
+
+	/**
+	 * @brief Handles a received packet, noting the first frame whose remote input was mispredicted.
+	 * @param data The packet.
+	 * @param size Size of the packet in bytes.
+	 */
+	void HandlePacket(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Restores the snapshot of the first mispredicted frame and simulates all frames since again.
+	 * @return Returns true if there was anything to roll back.
+	 */
+	bool Rollback();
+
+	/**
+	 * @brief Snapshots the Emulator and simulates a frame with the input of both players.
+	 * @param simulatedFrame The frame to simulate, which the Emulator is at the start of.
+	 */
+	void SimulateFrame(uint32_t simulatedFrame);
+
+	/**
+	 * @brief Gets the remote player's input for a frame, predicting it if it hasn't arrived yet.
+	 * @param inputFrame The frame to get the input of.
+	 * @return Returns the bitset of keys.
+	 */
+	uint16_t GetRemoteKeys(uint32_t inputFrame) const;
+
+	/**
+	 * @brief Gets the number of frames the local player is ahead of the remote one, as seen from here.
+	 * @return Returns the number of frames, negative when behind.
+	 */
+	int32_t GetFrameAdvantage() const { return (int32_t)(frame - remoteFrame); }
+
+	static const uint32_t MAGIC = 0x4E385043;					///< "CP8N" in little endian.
+	static const uint32_t FRAMES_PER_SECOND = 60;				///< Rate at which frames are simulated and input is sampled.
+	static const uint64_t FRAME_NS = 1000000000 / FRAMES_PER_SECOND;	///< Host time between two frames, in nanoseconds.
+	static const uint64_t HELLO_INTERVAL_NS = 100000000;		///< Host time between two Hello packets while connecting, in nanoseconds.
+	static const uint64_t KEEPALIVE_INTERVAL_NS = 2 * FRAME_NS;	///< Host time without simulated frames after which input is sent anyway, in nanoseconds.
+	static const uint64_t TIMEOUT_NS = 5000000000;				///< Host time without packets after which the remote player is gone, in nanoseconds.
+	static const uint32_t TIME_SYNC_INTERVAL = 30;				///< Minimum number of frames between two frames waited for the remote player.
+	static const uint32_t NO_FRAME = ~0u;						///< Marks that there's no mispredicted frame.
+	static const size_t MAX_PACKET_SIZE = 15 + INPUT_WINDOW * 3;	///< Size of the largest packet in bytes, an Input packet with a run per frame.
+
+	Emulator& emulator;						///< The Emulator being driven.
+	Clock& clock;							///< The Clock frames are paced by.
+	UdpSocket socket;						///< Socket connected to the remote player.
+	const uint32_t seed;					///< Random seed the Emulator booted with, adopted by the player who joins.
+	bool isHost = false;					///< Whether the local player hosts the session, deciding how the Emulators boot.
+	bool connected = false;					///< Whether both peers agreed to play.
+	bool remoteConnected = false;			///< Whether the remote player is known to have received our Hello.
+
+	uint32_t frame = 0;						///< Number of frames simulated.
+	uint32_t confirmedRemoteFrames = 0;		///< Number of frames, from boot, of which the remote input arrived.
+	uint32_t remoteAckedFrames = 0;			///< Number of frames, from boot, of which the remote player has the local input.
+	uint32_t remoteFrame = 0;				///< Number of frames the remote player had simulated when sending its latest packet.
+	int32_t remoteAdvantage = 0;			///< Frames the remote player was ahead of the local one, as seen from there.
+	uint32_t mispredictedFrame = NO_FRAME;	///< First simulated frame whose remote input turned out different than predicted.
+	uint32_t lastTimeSyncFrame = 0;			///< Frame at which the local player last waited for the remote one.
+
+	uint16_t localInputs[INPUT_WINDOW] = {};		///< Local input per frame, indexed by frame modulo INPUT_WINDOW.
+	uint16_t remoteInputs[INPUT_WINDOW] = {};		///< Confirmed remote input per frame, indexed likewise.
+	uint16_t predictedInputs[INPUT_WINDOW] = {};	///< Remote input each frame was simulated with, indexed likewise.
+	vector<MachineState> snapshots;			///< MachineState at the start of each frame, indexed by frame modulo MAX_ROLLBACK_FRAMES.
+
+	uint64_t nextFrameTime = 0;				///< Host time at which the next frame is due, in nanoseconds.
+	uint64_t lastSendTime = 0;				///< Host time of the most recent packet sent, in nanoseconds.
+	uint64_t lastReceiveTime = 0;			///< Host time of the most recent packet received, in nanoseconds.
+
+	uint64_t simulatedLatency = 0;			///< Delay added to outgoing packets, in nanoseconds.
+	uint32_t simulatedLoss = 0;				///< Percentage of outgoing packets dropped.
+	uint32_t lossRandomState = 1;			///< State of the xorshift deciding which packets are dropped.
+	deque<DelayedPacket> delayedPackets;	///< Outgoing packets held back by the simulated link, oldest first.
+
+	uint32_t numRollbacks = 0;				///< Number of times the remote input was mispredicted.
+	uint64_t numResimulatedFrames = 0;		///< Number of frames simulated again after rolling back.
+	uint64_t numBytesSent = 0;				///< Number of bytes sent, including dropped packets.
+};
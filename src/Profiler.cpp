@@ -0,0 +1,236 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "Profiler.h"
+#include "Emulator.h"
+#include "SteadyClock.h"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define CHIP8_PROFILER_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHIP8_PROFILER_TSC
+#endif
+
+const char* const Profiler::CATEGORIES[] = { "Display", "ALU", "Flow", "Memory", "Timer", "Input", "Unknown" };
+
+Profiler::Profiler()
+{
+	Reset();
+}
+
+void Profiler::Reset()
+{
+	memset(opcodeCounts, 0, sizeof(opcodeCounts));
+	memset(opcodeTicks, 0, sizeof(opcodeTicks));
+	memset(pcHits, 0, sizeof(pcHits));
+	memset(pcTicks, 0, sizeof(pcTicks));
+	memset(pcKinds, 0, sizeof(pcKinds));
+	memset(reads, 0, sizeof(reads));
+	memset(writes, 0, sizeof(writes));
+	numSkipped = 0;
+	numDraws = 0;
+	numCollisions = 0;
+
+	SteadyClock clock;
+	startTicks = GetTicks();
+	startTime = clock.GetTicksNS();
+}
+
+void Profiler::RecordRead(uint16_t address, uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++)
+		reads[(address + i) & (MEMORY_SIZE - 1)]++;
+}
+
+void Profiler::RecordWrite(uint16_t address, uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++)
+		writes[(address + i) & (MEMORY_SIZE - 1)]++;
+}
+
+uint64_t Profiler::GetTicks()
+{
+#ifdef CHIP8_PROFILER_TSC
+	// A few cycles, where asking the OS costs more than most opcodes take
+	return __rdtsc();
+#else
+	SteadyClock clock;
+	return clock.GetTicksNS();
+#endif
+}
+
+uint64_t Profiler::ToNanoseconds(uint64_t ticks) const
+{
+#ifdef CHIP8_PROFILER_TSC
+	SteadyClock clock;
+	const uint64_t elapsedTicks = GetTicks() - startTicks;
+	const uint64_t elapsedTime = clock.GetTicksNS() - startTime;
+	return elapsedTicks > 0 ? (uint64_t)((double)ticks * elapsedTime / elapsedTicks) : 0;
+#else
+	return ticks;
+#endif
+}
+
+const char* Profiler::GetCategory(uint8_t kind)
+{
+	const string name = Emulator::GetOpcodeName(kind);
+	switch (name[0])
+	{
+		case '0': return name == "00E0" ? CATEGORIES[0] : CATEGORIES[2];
+		case 'D': return CATEGORIES[0];
+		case '6': case '7': case '8': case 'C': return CATEGORIES[1];
+		case '1': case '2': case '3': case '4': case '5': case '9': case 'B': return CATEGORIES[2];
+		case 'A': return CATEGORIES[3];
+		case 'E': return CATEGORIES[5];
+		case 'F':
+		{
+			if (name == "FX07" || name == "FX15" || name == "FX18")
+				return CATEGORIES[4];
+
+			return name == "FX0A" ? CATEGORIES[5] : CATEGORIES[3];
+		}
+	}
+
+	return CATEGORIES[6];
+}
+
+double Profiler::GetCategoryShare(const string& category) const
+{
+	uint64_t total = 0;
+	uint64_t inCategory = 0;
+	for (uint32_t kind = 0; kind < Emulator::NUM_OPCODE_KINDS; kind++)
+	{
+		total += opcodeTicks[kind];
+		inCategory += category == GetCategory((uint8_t)kind) ? opcodeTicks[kind] : 0;
+	}
+
+	return total > 0 ? (double)inCategory / total : 0.0;
+}
+
+uint64_t Profiler::GetNumExecuted() const
+{
+	uint64_t numExecuted = 0;
+	for (uint32_t kind = 0; kind < Emulator::NUM_OPCODE_KINDS; kind++)
+		numExecuted += opcodeCounts[kind];
+
+	return numExecuted;
+}
+
+void Profiler::WriteJson(ostream& output) const
+{
+	output << "{" << endl;
+	output << "\t\"executed\": " << GetNumExecuted() << "," << endl;
+	output << "\t\"skipped\": " << numSkipped << "," << endl;
+	output << "\t\"draws\": " << numDraws << "," << endl;
+	output << "\t\"collisions\": " << numCollisions << "," << endl;
+
+	output << "\t\"categories\": {";
+	for (uint32_t i = 0; i < NUM_CATEGORIES; i++)
+		output << (i > 0 ? ", " : " ") << "\"" << CATEGORIES[i] << "\": " << GetCategoryShare(CATEGORIES[i]);
+	output << " }," << endl;
+
+	output << "\t\"opcodes\": [" << endl;
+	for (uint32_t kind = 0; kind < Emulator::NUM_OPCODE_KINDS; kind++)
+	{
+		output << "\t\t{ \"kind\": \"" << Emulator::GetOpcodeName((uint8_t)kind) << "\", \"category\": \"" << GetCategory((uint8_t)kind)
+			<< "\", \"count\": " << opcodeCounts[kind] << ", \"ns\": " << ToNanoseconds(opcodeTicks[kind]) << " }"
+			<< (kind + 1 < Emulator::NUM_OPCODE_KINDS ? "," : "") << endl;
+	}
+	output << "\t]," << endl;
+
+	// Indexed by address, so heatmaps can be plotted straight from them
+	const pair<const char*, const uint64_t*> HISTOGRAMS[] = { { "pc", pcHits }, { "reads", reads }, { "writes", writes } };
+	for (size_t i = 0; i < size(HISTOGRAMS); i++)
+	{
+		output << "\t\"" << HISTOGRAMS[i].first << "\": [";
+		for (uint32_t address = 0; address < MEMORY_SIZE; address++)
+			output << (address > 0 ? "," : "") << HISTOGRAMS[i].second[address];
+		output << "]" << (i + 1 < size(HISTOGRAMS) ? "," : "") << endl;
+	}
+
+	output << "}" << endl;
+}
+
+void Profiler::WriteCsv(ostream& output) const
+{
+	output << "table,key,count,ns" << endl;
+	output << "total,executed," << GetNumExecuted() << "," << endl;
+	output << "total,skipped," << numSkipped << "," << endl;
+	output << "draw,draws," << numDraws << "," << endl;
+	output << "draw,collisions," << numCollisions << "," << endl;
+
+	for (uint32_t kind = 0; kind < Emulator::NUM_OPCODE_KINDS; kind++)
+		output << "opcode," << Emulator::GetOpcodeName((uint8_t)kind) << "," << opcodeCounts[kind] << "," << ToNanoseconds(opcodeTicks[kind]) << endl;
+
+	// Only addresses which were touched at all, leaving out the thousands of zeroes
+	output << hex << setfill('0');
+	for (uint32_t address = 0; address < MEMORY_SIZE; address++)
+	{
+		if (pcHits[address] > 0)
+			output << "pc,0x" << setw(3) << address << dec << "," << pcHits[address] << "," << ToNanoseconds(pcTicks[address]) << hex << endl;
+
+		if (reads[address] > 0)
+			output << "read,0x" << setw(3) << address << dec << "," << reads[address] << "," << hex << endl;
+
+		if (writes[address] > 0)
+			output << "write,0x" << setw(3) << address << dec << "," << writes[address] << "," << hex << endl;
+	}
+	output << dec << setfill(' ');
+}
+
+void Profiler::WriteFolded(ostream& output) const
+{
+	output << hex << setfill('0');
+	for (uint32_t address = 0; address < MEMORY_SIZE; address++)
+	{
+		if (pcHits[address] == 0)
+			continue;
+
+		const uint8_t kind = pcKinds[address];
+		output << GetCategory(kind) << ";" << Emulator::GetOpcodeName(kind) << ";0x" << setw(3) << address << " " << dec
+			<< ToNanoseconds(pcTicks[address]) << hex << endl;
+	}
+	output << dec << setfill(' ');
+}
+
+void Profiler::WriteSummary(ostream& output) const
+{
+	output << "Profiled " << GetNumExecuted() << " opcodes, drawing " << numDraws << " sprites of which " << numCollisions << " collided" << endl;
+	for (const char* category : CATEGORIES)
+		output << "  " << category << ": " << GetCategoryShare(category) * 100.0 << "% of host time" << endl;
+}
+
+bool Profiler::Save(const string& path) const
+{
+	const auto hasExtension = [&path](const string& extension)
+	{
+		return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+	};
+
+	if (!hasExtension(".json") && !hasExtension(".csv") && !hasExtension(".folded"))
+	{
+		cerr << "Unknown profile format '" << path << "', expected .json, .csv or .folded" << endl;
+		return false;
+	}
+
+	ofstream file(path);
+	if (!file)
+	{
+		cerr << "Could not open '" << path << "'" << endl;
+		return false;
+	}
+
+	if (hasExtension(".json"))
+		WriteJson(file);
+	else if (hasExtension(".csv"))
+		WriteCsv(file);
+	else
+		WriteFolded(file);
+
+	return (bool)file;
+}
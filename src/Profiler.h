@@ -0,0 +1,173 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <ostream>
+#include "MachineState.h"
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Where an Emulator spends its time, per kind of Opcode and per address, to tell whether a ROM is bound by
+ * drawing, arithmetic or anything else before picking an ExecutionMode for it.
+ *
+ * An Emulator given a Profiler executes one Opcode per step, timing each with the cheapest timer the host has and
+ * counting which addresses it fetched from, read from and wrote to, and how many sprites it drew and collided. Without a
+ * Profiler none of this happens, the Emulator taking its usual path. Results can be written as JSON, as CSV in long
+ * format, or folded by category, kind and address as flamegraph tools take them.
+ */
+class Profiler
+{
+public:
+	/**
+	 * @brief Constructor, starting with every counter at zero.
+	 */
+	Profiler();
+
+	/**
+	 * @brief Sets every counter back to zero.
+	 */
+	void Reset();
+
+	/**
+	 * @brief Counts an executed Opcode.
+	 * @param address Address the Opcode was fetched from.
+	 * @param kind Kind of Opcode, in [0..Emulator::NUM_OPCODE_KINDS).
+	 * @param ticks Host time it took, in GetTicks() units.
+	 */
+	void RecordOpcode(uint16_t address, uint8_t kind, uint64_t ticks)
+	{
+		opcodeCounts[kind]++;
+		opcodeTicks[kind] += ticks;
+		pcHits[address]++;
+		pcTicks[address] += ticks;
+		pcKinds[address] = kind;
+	}
+
+	/**
+	 * @brief Counts opcodes fast-forwarded through idle loops rather than executed.
+	 * @param numCycles Number of opcodes skipped.
+	 */
+	void RecordSkipped(uint32_t numCycles) { numSkipped += numCycles; }
+
+	/**
+	 * @brief Counts reads from a range of memory, wrapping around its end.
+	 * @param address First address read.
+	 * @param size Number of bytes read.
+	 */
+	void RecordRead(uint16_t address, uint32_t size);
+
+	/**
+	 * @brief Counts writes to a range of memory, wrapping around its end.
+	 * @param address First address written.
+	 * @param size Number of bytes written.
+	 */
+	void RecordWrite(uint16_t address, uint32_t size);
+
+	/**
+	 * @brief Counts a sprite drawn by DXYN.
+	 * @param collided Whether any pixel was switched off.
+	 */
+	void RecordDraw(bool collided) { numDraws++; numCollisions += collided ? 1 : 0; }
+
+	/**
+	 * @brief Gets the current host time, in the units RecordOpcode() takes: the timestamp counter where available.
+	 * @return Returns the current number of ticks.
+	 */
+	static uint64_t GetTicks();
+
+	/**
+	 * @brief Writes all counters as a single JSON object.
+	 * @param output Stream to write to.
+	 */
+	void WriteJson(ostream& output) const;
+
+	/**
+	 * @brief Writes all counters as CSV in long format, one row per counter: table, key, count and nanoseconds.
+	 * @param output Stream to write to.
+	 */
+	void WriteCsv(ostream& output) const;
+
+	/**
+	 * @brief Writes the host time per category, kind and address in the folded format flamegraph tools take, one line
+	 * per address with the nanoseconds spent there.
+	 * @param output Stream to write to.
+	 */
+	void WriteFolded(ostream& output) const;
+
+	/**
+	 * @brief Writes a short summary for people: the number of opcodes and sprites, and the share of host time every
+	 * category of Opcode took.
+	 * @param output Stream to write to.
+	 */
+	void WriteSummary(ostream& output) const;
+
+	/**
+	 * @brief Writes all counters to a file, choosing the format by its extension.
+	 * @param path Path ending in .json, .csv or .folded.
+	 * @return Returns false if the extension isn't known or the file couldn't be written.
+	 */
+	bool Save(const string& path) const;
+
+	/**
+	 * @brief Gets what kind of work a kind of Opcode does, such as "Display" for 00E0 and DXYN or "ALU" for 8XY4.
+	 * @param kind Kind of Opcode, in [0..Emulator::NUM_OPCODE_KINDS).
+	 * @return Returns "Display", "ALU", "Flow", "Memory", "Timer", "Input" or "Unknown".
+	 */
+	static const char* GetCategory(uint8_t kind);
+
+	/**
+	 * @brief Gets the share of host time spent on a category, such as to tell draw-bound ROMs from ALU-bound ones.
+	 * @param category One of the categories returned by GetCategory().
+	 * @return Returns the share in [0..1], 0 if nothing was executed yet.
+	 */
+	double GetCategoryShare(const string& category) const;
+
+	/**
+	 * @brief Gets the total number of opcodes executed, not counting skipped ones.
+	 * @return Returns the number of opcodes.
+	 */
+	uint64_t GetNumExecuted() const;
+
+	/**
+	 * @brief Gets the number of sprites drawn.
+	 * @return Returns the number of DXYN opcodes executed.
+	 */
+	uint64_t GetNumDraws() const { return numDraws; }
+
+	/**
+	 * @brief Gets the number of sprites which collided.
+	 * @return Returns the number of DXYN opcodes which switched a pixel off.
+	 */
+	uint64_t GetNumCollisions() const { return numCollisions; }
+
+	static const uint32_t NUM_CATEGORIES = 7;					///< Number of categories GetCategory() returns.
+	static const char* const CATEGORIES[NUM_CATEGORIES];		///< Every category GetCategory() returns.
+
+private:
+	/**
+	 * @brief Converts ticks to nanoseconds, by comparing the ticks and steady time passed since the last Reset().
+	 * @param ticks Number of ticks.
+	 * @return Returns the number of nanoseconds.
+	 */
+	uint64_t ToNanoseconds(uint64_t ticks) const;
+
+	static const uint32_t MAX_OPCODE_KINDS = 64;			///< Room for every kind of Opcode, of which Emulator has fewer.
+	static const uint32_t MEMORY_SIZE = MachineState::MEMORY_SIZE;	///< Number of addresses counted.
+
+	uint64_t opcodeCounts[MAX_OPCODE_KINDS] = {};			///< Number of times every kind of Opcode executed.
+	uint64_t opcodeTicks[MAX_OPCODE_KINDS] = {};			///< Host time every kind of Opcode took, in ticks.
+	uint64_t pcHits[MEMORY_SIZE] = {};						///< Number of opcodes fetched from every address.
+	uint64_t pcTicks[MEMORY_SIZE] = {};						///< Host time the opcodes fetched from every address took, in ticks.
+	uint8_t pcKinds[MEMORY_SIZE] = {};						///< Kind of the Opcode most recently fetched from every address.
+	uint64_t reads[MEMORY_SIZE] = {};						///< Number of reads from every address, including fetches.
+	uint64_t writes[MEMORY_SIZE] = {};						///< Number of writes to every address.
+	uint64_t numSkipped = 0;								///< Number of opcodes skipped through idle loops.
+	uint64_t numDraws = 0;									///< Number of sprites drawn.
+	uint64_t numCollisions = 0;								///< Number of sprites which collided.
+	uint64_t startTicks = 0;								///< GetTicks() at the last Reset().
+	uint64_t startTime = 0;									///< Steady time at the last Reset(), in nanoseconds.
+};
@@ -5,12 +5,7 @@
 #include "SDL3/SDL_events.h"
 #include "SDL3/SDL_gpu.h"
 #include <vector>
-
-typedef struct PositionColorVertex
-{
-	float x, y, z;
-	Uint8 r, g, b, a;
-} PositionColorVertex;
+#include <cmath>
 
 typedef struct PositionTextureVertex
 {
@@ -26,7 +21,6 @@ typedef struct ShaderUniform
 
 Renderer::Renderer(Window* window) : window(window)
 {
-	screenBuffer = vector<vector<bool>>(window->GetCanvasWidth(), vector<bool>(window->GetCanvasHeight(), false));
 }
 
 bool Renderer::Init()
@@ -40,20 +34,17 @@ bool Renderer::Init()
 	if (!SetupPostPipeline())
 		return false;
 
-	// Create texture
+	if (!SetupBloomPipelines())
+		return false;
+
+	if (!SetupCrtPipeline())
+		return false;
+
+	// Create textures
 	SDL_Point windowSize{};
 	SDL_GetWindowSize(window->GetSDLWindow(), &windowSize.x, &windowSize.y);
-
-	SDL_GPUTextureCreateInfo sceneTextureCreateInfo{};
-	sceneTextureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D,
-	sceneTextureCreateInfo.width = windowSize.x;
-	sceneTextureCreateInfo.height = windowSize.y;
-	sceneTextureCreateInfo.layer_count_or_depth = 1;
-	sceneTextureCreateInfo.num_levels = 1;
-	sceneTextureCreateInfo.sample_count = SDL_GPU_SAMPLECOUNT_1;
-	sceneTextureCreateInfo.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
-	sceneTextureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
-	sceneTexture = SDL_CreateGPUTexture(gpuDevice, &sceneTextureCreateInfo);
+	if (!CreateRenderTargets(windowSize.x, windowSize.y))
+		return false;
 
 	// Create sampler
 	SDL_GPUSamplerCreateInfo samplerCreateInfo{};
@@ -65,11 +56,33 @@ bool Renderer::Init()
 	samplerCreateInfo.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
 	sampler = SDL_CreateGPUSampler(gpuDevice, &samplerCreateInfo);
 
-	// Create vertex/index buffers
-	SDL_GPUBufferCreateInfo sceneVertexBufferCreateInfo{};
-	sceneVertexBufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
-	sceneVertexBufferCreateInfo.size = sizeof(PositionColorVertex) * NUM_VERTICES;
-	sceneVertexBuffer = SDL_CreateGPUBuffer(gpuDevice, &sceneVertexBufferCreateInfo);
+	// Create nearest sampler, for lookups baked per pixel which mustn't blend, like the edges of the display
+	samplerCreateInfo.min_filter = SDL_GPU_FILTER_NEAREST;
+	samplerCreateInfo.mag_filter = SDL_GPU_FILTER_NEAREST;
+	samplerCreateInfo.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST;
+	nearestSampler = SDL_CreateGPUSampler(gpuDevice, &samplerCreateInfo);
+
+	// Create levels texture
+	SDL_GPUTextureCreateInfo levelsTextureCreateInfo{};
+	levelsTextureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D;
+	levelsTextureCreateInfo.width = LEVELS_SIZE;
+	levelsTextureCreateInfo.height = 1;
+	levelsTextureCreateInfo.layer_count_or_depth = 1;
+	levelsTextureCreateInfo.num_levels = 1;
+	levelsTextureCreateInfo.sample_count = SDL_GPU_SAMPLECOUNT_1;
+	levelsTextureCreateInfo.format = SDL_GPU_TEXTUREFORMAT_R16_UNORM;
+	levelsTextureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER;
+	levelsTexture = SDL_CreateGPUTexture(gpuDevice, &levelsTextureCreateInfo);
+
+	// Create framebuffer/vertex/index buffers
+	SDL_GPUBufferCreateInfo framebufferBufferCreateInfo{};
+	framebufferBufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
+	framebufferBufferCreateInfo.size = FRAMEBUFFER_SIZE;
+	framebufferBuffer = SDL_CreateGPUBuffer(gpuDevice, &framebufferBufferCreateInfo);
+
+	// Every frame uploads its rows through the next of a few transfer buffers, rather than creating one
+	if (!uploadRing.Init(gpuDevice, FRAMEBUFFER_SIZE))
+		return false;
 
 	SDL_GPUBufferCreateInfo postVertexBufferCreateInfo{};
 	postVertexBufferCreateInfo.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
@@ -84,7 +97,7 @@ bool Renderer::Init()
 	// Transfer static information
 	SDL_GPUTransferBufferCreateInfo transferBufferCreateInfo{};
 	transferBufferCreateInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-	transferBufferCreateInfo.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6);
+	transferBufferCreateInfo.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6) + (sizeof(Uint16) * LEVELS_SIZE);
 	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(gpuDevice, &transferBufferCreateInfo);
 
 	// Post pipeline quad vertices
@@ -103,6 +116,14 @@ bool Renderer::Init()
 	indexData[4] = 2;
 	indexData[5] = 3;
 
+	// Post pipeline levels curve, the same for every pixel and frame
+	Uint16* levelsData = &indexData[6];
+	for (int i = 0; i < LEVELS_SIZE; i++)
+	{
+		const float value = 1.0f - powf(1.0f - i / (float)(LEVELS_SIZE - 1), LEVELS_CURVE_STRENGTH);
+		levelsData[i] = (Uint16)(value * 65535.0f + 0.5f);
+	}
+
 	SDL_UnmapGPUTransferBuffer(gpuDevice, transferBuffer);
 
 	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(gpuDevice);
@@ -130,6 +151,18 @@ bool Renderer::Init()
 
 	SDL_UploadToGPUBuffer(copyPass, &indexTransferBufferLocation, &indexBufferRegion, false);
 
+	SDL_GPUTextureTransferInfo levelsTransferInfo{};
+	levelsTransferInfo.transfer_buffer = transferBuffer;
+	levelsTransferInfo.offset = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6);
+
+	SDL_GPUTextureRegion levelsTextureRegion{};
+	levelsTextureRegion.texture = levelsTexture;
+	levelsTextureRegion.w = LEVELS_SIZE;
+	levelsTextureRegion.h = 1;
+	levelsTextureRegion.d = 1;
+
+	SDL_UploadToGPUTexture(copyPass, &levelsTransferInfo, &levelsTextureRegion, false);
+
 	SDL_EndGPUCopyPass(copyPass);
 	SDL_SubmitGPUCommandBuffer(commandBuffer);
 	SDL_ReleaseGPUTransferBuffer(gpuDevice, transferBuffer);
@@ -149,6 +182,11 @@ void Renderer::Shutdown()
 
 	SDL_RemoveEventWatch(OnWindowEvent, this);
 
+	SDL_Log("Uploaded %llu frames through %llu transfer buffers, stalling %llu times", (unsigned long long)uploadRing.GetNumFrames(),
+		(unsigned long long)uploadRing.GetNumAllocations(), (unsigned long long)uploadRing.GetNumStalls());
+	uploadRing.Shutdown();
+	ReleaseRenderTargets();
+
 	SDL_ReleaseWindowFromGPUDevice(gpuDevice, window->GetSDLWindow());
 	SDL_DestroyGPUDevice(gpuDevice);
 }
@@ -175,8 +213,35 @@ void Renderer::Render()
 			return;
 		}
 
+		// Resizing only redraws, the textures sized after the window are recreated here
+		SDL_Point windowSize;
+		SDL_GetWindowSize(window->GetSDLWindow(), &windowSize.x, &windowSize.y);
+		windowSize = { SDL_max(windowSize.x, 1), SDL_max(windowSize.y, 1) };
+		if ((windowSize.x != targetSize.x || windowSize.y != targetSize.y) && !CreateRenderTargets(windowSize.x, windowSize.y))
+			swapchainTexture = nullptr;
+
 		if (swapchainTexture != nullptr)
 		{
+			////////////////////////////// UPLOAD COPY PASS //////////////////////////////
+
+			// Recorded into this frame's command buffer ahead of the render passes, so the scene reads this frame's rows
+			uint64_t* transferData = (uint64_t*)uploadRing.Map();
+			if (transferData != nullptr)
+			{
+				for (int y = 0; y < Framebuffer::HEIGHT; y++)
+					transferData[y] = framebuffer.GetRow(y);
+
+				SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+
+				SDL_GPUBufferRegion destination{};
+				destination.buffer = framebufferBuffer;
+				destination.offset = 0;
+				destination.size = FRAMEBUFFER_SIZE;
+
+				uploadRing.Upload(copyPass, 0, destination);
+				SDL_EndGPUCopyPass(copyPass);
+			}
+
 			////////////////////////////// SCENE RENDER PASS //////////////////////////////
 			
 			SDL_GPUColorTargetInfo sceneTargetInfo = { 0 };
@@ -189,67 +254,56 @@ void Renderer::Render()
 			SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &sceneTargetInfo, 1, nullptr);
 			SDL_BindGPUGraphicsPipeline(renderPass, scenePipeline);
 			
-			// Bind vertex buffer
-			SDL_GPUBufferBinding bufferBinding{};
-			bufferBinding.buffer = sceneVertexBuffer;
-			bufferBinding.offset = 0;
-
-			SDL_BindGPUVertexBuffers(renderPass, 0, &bufferBinding, 1);
+			// Bind the packed rows, which the fragment shader reads its pixels from
+			SDL_BindGPUFragmentStorageBuffers(renderPass, 0, &framebufferBuffer, 1);
 
-			// Create transfer buffer
-			SDL_GPUTransferBufferCreateInfo transferBufferCreateInfo{};
-			transferBufferCreateInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-			transferBufferCreateInfo.size = sizeof(PositionColorVertex) * NUM_VERTICES;
-
-			SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(gpuDevice, &transferBufferCreateInfo);
-			PositionColorVertex* transferData = (PositionColorVertex*)SDL_MapGPUTransferBuffer(gpuDevice, transferBuffer, false);
+			// Draw a single fullscreen triangle, generated by the vertex shader
+			SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+			SDL_EndGPURenderPass(renderPass);
 
-			// Create vertices
-			const SDL_FPoint QUAD_SIZE = { 2.0f / window->GetCanvasWidth(), 2.0f / window->GetCanvasHeight() }; // We're in [-1..1] range
-			const SDL_FPoint UPPER_LEFT = { -1.0f, 1.0f };
+			////////////////////////////// BLOOM RENDER PASSES //////////////////////////////
 
-			for (int i = 0; i < NUM_VERTICES; i += 6)
+			// Downsample the scene a level at a time, each level averaging 4x4 texels of the one before
+			SDL_GPUTexture* source = sceneTexture;
+			SDL_Point sourceSize = targetSize;
+			for (int level = 0; level < BLOOM_LEVELS; level++)
 			{
-				const int quadIndex = i / 6;
-				const int x = quadIndex % window->GetCanvasWidth();
-				const int y = quadIndex / window->GetCanvasWidth();
-				const SDL_FPoint QUAD_UPPER_LEFT = { UPPER_LEFT.x + QUAD_SIZE.x * x, UPPER_LEFT.y - QUAD_SIZE.y * y };
-
-				const Uint8 v = screenBuffer[x][y] ?  255 : 0;
+				const SDL_FPoint texelSize = { 1.0f / sourceSize.x, 1.0f / sourceSize.y };
+				RenderFullscreenPass(commandBuffer, downsamplePipeline, source, bloomTextures[level], &texelSize, sizeof(texelSize));
+				source = bloomTextures[level];
+				sourceSize = bloomSizes[level];
+			}
 
-				// TODO switch to float4 and use A as an on/off?
-				transferData[i] = {		QUAD_UPPER_LEFT.x,					QUAD_UPPER_LEFT.y,					0.0f,		v, v, v, 255 }; // upper left
-				transferData[i + 1] = { QUAD_UPPER_LEFT.x + QUAD_SIZE.x,	QUAD_UPPER_LEFT.y,					0.0f,		v, v, v, 255 }; // upper right
-				transferData[i + 2] = { QUAD_UPPER_LEFT.x,					QUAD_UPPER_LEFT.y - QUAD_SIZE.y,	0.0f,		v, v, v, 255 }; // lower left
+			// Blur the smallest level horizontally, then vertically back into itself, which the post pass upsamples
+			const SDL_FPoint horizontal = { 1.0f / sourceSize.x, 0.0f };
+			const SDL_FPoint vertical = { 0.0f, 1.0f / sourceSize.y };
+			RenderFullscreenPass(commandBuffer, blurPipeline, source, bloomBlurTexture, &horizontal, sizeof(horizontal));
+			RenderFullscreenPass(commandBuffer, blurPipeline, bloomBlurTexture, source, &vertical, sizeof(vertical));
 
-				transferData[i + 3] = { QUAD_UPPER_LEFT.x + QUAD_SIZE.x,	QUAD_UPPER_LEFT.y,					0.0f,		v, v, v, 255 }; // upper right
-				transferData[i + 4] = { QUAD_UPPER_LEFT.x,					QUAD_UPPER_LEFT.y - QUAD_SIZE.y,	0.0f,		v, v, v, 255 }; // lower left
-				transferData[i + 5] = { QUAD_UPPER_LEFT.x + QUAD_SIZE.x,	QUAD_UPPER_LEFT.y - QUAD_SIZE.y,	0.0f,		v, v, v, 255 }; // lower right
-			}
+			// Set fragment shader uniform, which applies to the draws after it
+			ShaderUniform uni{ windowSize.x, windowSize.y };
+			SDL_PushGPUFragmentUniformData(commandBuffer, 0, &uni, sizeof(ShaderUniform));
 
-			SDL_UnmapGPUTransferBuffer(gpuDevice, transferBuffer);
+			////////////////////////////// CRT BAKE RENDER PASS //////////////////////////////
 
-			// Upload to vertex buffer
-			SDL_GPUCommandBuffer* uploadCommandBuffer = SDL_AcquireGPUCommandBuffer(gpuDevice);
-			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCommandBuffer);
-			
-			SDL_GPUTransferBufferLocation source{};
-			source.transfer_buffer = transferBuffer;
-			source.offset = 0;
-
-			SDL_GPUBufferRegion destination{};
-			destination.buffer = sceneVertexBuffer;
-			destination.offset = 0;
-			destination.size = sizeof(PositionColorVertex) * NUM_VERTICES;
-
-			SDL_UploadToGPUBuffer(copyPass, &source, &destination, false);
-			SDL_EndGPUCopyPass(copyPass);
-			SDL_SubmitGPUCommandBuffer(uploadCommandBuffer);
-			SDL_ReleaseGPUTransferBuffer(gpuDevice, transferBuffer);
-
-			// Draw
-			SDL_DrawGPUPrimitives(renderPass, NUM_VERTICES, 1, 0, 0);
-			SDL_EndGPURenderPass(renderPass);
+			// Only depends on the window size, so only rendered once the textures are recreated
+			if (bakeCrt)
+			{
+				SDL_GPUColorTargetInfo crtTargetInfos[2]{};
+				crtTargetInfos[0].texture = screenTexture;
+				crtTargetInfos[0].load_op = SDL_GPU_LOADOP_DONT_CARE;
+				crtTargetInfos[0].store_op = SDL_GPU_STOREOP_STORE;
+				crtTargetInfos[1].texture = maskTexture;
+				crtTargetInfos[1].load_op = SDL_GPU_LOADOP_DONT_CARE;
+				crtTargetInfos[1].store_op = SDL_GPU_STOREOP_STORE;
+
+				renderPass = SDL_BeginGPURenderPass(commandBuffer, crtTargetInfos, 2, nullptr);
+				SDL_BindGPUGraphicsPipeline(renderPass, crtPipeline);
+				SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+				SDL_EndGPURenderPass(renderPass);
+
+				bakeCrt = false;
+			}
 
 			////////////////////////////// POST RENDER PASS //////////////////////////////
 
@@ -272,24 +326,25 @@ void Renderer::Render()
 			indexBufferBinding.offset = 0;
 			SDL_BindGPUIndexBuffer(renderPass, &indexBufferBinding, SDL_GPU_INDEXELEMENTSIZE_16BIT);
 
-			SDL_GPUTextureSamplerBinding textureSamplerBindings[1]{};
+			SDL_GPUTextureSamplerBinding textureSamplerBindings[5]{};
 			textureSamplerBindings[0].texture = sceneTexture;
 			textureSamplerBindings[0].sampler = sampler;
-			SDL_BindGPUFragmentSamplers(renderPass, 0, textureSamplerBindings, 1);
+			textureSamplerBindings[1].texture = bloomTextures[BLOOM_LEVELS - 1];
+			textureSamplerBindings[1].sampler = sampler;
+			textureSamplerBindings[2].texture = screenTexture;
+			textureSamplerBindings[2].sampler = nearestSampler;
+			textureSamplerBindings[3].texture = maskTexture;
+			textureSamplerBindings[3].sampler = nearestSampler;
+			textureSamplerBindings[4].texture = levelsTexture;
+			textureSamplerBindings[4].sampler = sampler;
+			SDL_BindGPUFragmentSamplers(renderPass, 0, textureSamplerBindings, 5);
 			SDL_DrawGPUIndexedPrimitives(renderPass, 6, 1, 0, 0, 0);
 			SDL_EndGPURenderPass(renderPass);
 
 			//////////////////////////////////////////////////////////////////////////////
-
-			// Set fragment shader uniform
-			SDL_Point windowSize;
-			SDL_GetWindowSize(window->GetSDLWindow(), &windowSize.x, &windowSize.y);
-			ShaderUniform uni{ windowSize.x, windowSize.y };
-			SDL_PushGPUFragmentUniformData(commandBuffer, 0, &uni, sizeof(ShaderUniform));
-
 		}
 
-		SDL_SubmitGPUCommandBuffer(commandBuffer);
+		uploadRing.Submit(commandBuffer);
 
 		redraw = false;
 	}
@@ -297,45 +352,15 @@ void Renderer::Render()
 	nextRenderTime = SDL_GetTicks() + (1000.f / FRAMES_PER_SECOND);
 }
 
-void Renderer::Clear()
+void Renderer::Present(const Framebuffer& framebuffer)
 {
-	// Clear screen
-	screenBuffer = vector<vector<bool>>(window->GetCanvasWidth(), vector<bool>(window->GetCanvasHeight(), false));
-}
-
-void Renderer::Display(uint8_t x, uint8_t y, uint8_t n, uint16_t I, vector<uint8_t>& memory, vector<uint8_t>& vars)
-{
-	x = x % window->GetCanvasWidth();
-	const uint8_t originalX = x;
-	y = y % window->GetCanvasHeight();
-
-	vars[0xF] = 0;
-
-	for (uint8_t row = 0; row < n && y < window->GetCanvasHeight(); row++, y++)
-	{
-		const uint8_t spriteData = memory[I + row];
-		x = originalX;
-
-		for (int col = 7; col >= 0 && x < window->GetCanvasWidth(); col--, x++)
-		{
-			bool currentPixel = screenBuffer[x][y];
-			bool newPixel = (spriteData & (1 << col)); // Grab the relevant bit from spriteData
-
-			if (newPixel && currentPixel)
-				vars[0xF] = 1;
-			
-			newPixel ^= currentPixel;
-
-			screenBuffer[x][y] = newPixel;
-		}
-	}
-
+	this->framebuffer = framebuffer;
 	redraw = true;
 }
 
 bool Renderer::OnWindowEvent(void* data, SDL_Event* event)
 {
-	// Enforce a redraw if the window size changes.
+	// Enforce a redraw if the window size changes, which recreates and rebakes the textures sized after the window.
 	if (event->type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED || event->type == SDL_EVENT_WINDOW_RESIZED)
 	{
 		Renderer* renderer = static_cast<Renderer*>(data);
@@ -368,55 +393,76 @@ bool Renderer::SetupDevice()
 
 bool Renderer::SetupScenePipeline()
 {
-	// Setup shaders
-	SDL_GPUShader* vertexShader = LoadShader(gpuDevice, "scene.vert", 0, 0, 0, 0);
-	if (vertexShader == nullptr)
+	scenePipeline = CreateFullscreenPipeline("chip8.frag", 0, 0, 1);
+	if (scenePipeline == nullptr)
 	{
-		SDL_Log("Failed to create scene vertex shader.");
+		SDL_Log("Failed to create scene pipeline.");
 		return false;
-	}	
+	}
 
-	SDL_GPUShader* fragmentShader = LoadShader(gpuDevice, "scene.frag", 0, 0, 0, 0);
-	if (fragmentShader == nullptr)
+	return true;
+}
+
+bool Renderer::SetupBloomPipelines()
+{
+	downsamplePipeline = CreateFullscreenPipeline("downsample.frag", 1, 1, 0);
+	if (downsamplePipeline == nullptr)
 	{
-		SDL_Log("Failed to create scene fragment shader.");
+		SDL_Log("Failed to create downsample pipeline.");
 		return false;
 	}
 
-	// Setup vertex info so it matches PositionColorVertex
-	SDL_GPUVertexBufferDescription vertexBufferDescriptions[1]{};
-	vertexBufferDescriptions[0].slot = 0;
-	vertexBufferDescriptions[0].input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
-	vertexBufferDescriptions[0].instance_step_rate = 0;
-	vertexBufferDescriptions[0].pitch = sizeof(PositionColorVertex);
+	blurPipeline = CreateFullscreenPipeline("blur.frag", 1, 1, 0);
+	if (blurPipeline == nullptr)
+	{
+		SDL_Log("Failed to create blur pipeline.");
+		return false;
+	}
 
-	SDL_GPUVertexAttribute vertexAttributes[2]{};
+	return true;
+}
 
-	// Vertex position
-	vertexAttributes[0].buffer_slot = 0;
-	vertexAttributes[0].format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3;
-	vertexAttributes[0].location = 0;
-	vertexAttributes[0].offset = 0;
+bool Renderer::SetupCrtPipeline()
+{
+	crtPipeline = CreateFullscreenPipeline("crt.frag", 0, 1, 0, { SCREEN_FORMAT, MASK_FORMAT });
+	if (crtPipeline == nullptr)
+	{
+		SDL_Log("Failed to create CRT pipeline.");
+		return false;
+	}
 
-	// Vertex color
-	vertexAttributes[1].buffer_slot = 0;
-	vertexAttributes[1].format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM;
-	vertexAttributes[1].location = 1;
-	vertexAttributes[1].offset = sizeof(float) * 3; // Offset by the float3 of position
+	return true;
+}
+
+SDL_GPUGraphicsPipeline* Renderer::CreateFullscreenPipeline(const char* fragmentShaderFilename, Uint32 samplerCount, Uint32 uniformBufferCount, Uint32 storageBufferCount, const vector<SDL_GPUTextureFormat>& targetFormats)
+{
+	// Setup shaders
+	SDL_GPUShader* vertexShader = LoadShader(gpuDevice, "chip8.vert", 0, 0, 0, 0);
+	if (vertexShader == nullptr)
+	{
+		SDL_Log("Failed to create fullscreen vertex shader.");
+		return nullptr;
+	}	
+
+	SDL_GPUShader* fragmentShader = LoadShader(gpuDevice, fragmentShaderFilename, samplerCount, uniformBufferCount, storageBufferCount, 0);
+	if (fragmentShader == nullptr)
+	{
+		SDL_Log("Failed to create %s shader.", fragmentShaderFilename);
+		SDL_ReleaseGPUShader(gpuDevice, vertexShader);
+		return nullptr;
+	}
 
+	// No vertex info, the fullscreen triangle is generated from the vertex index
 	SDL_GPUVertexInputState vertexInputState{};
-	vertexInputState.num_vertex_buffers = 1;
-	vertexInputState.vertex_buffer_descriptions = vertexBufferDescriptions;
-	vertexInputState.num_vertex_attributes = 2;
-	vertexInputState.vertex_attributes = vertexAttributes;
 
 	// Set up target info
-	SDL_GPUColorTargetDescription colorTargetDescriptions[1]{};
-	colorTargetDescriptions[0].format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+	vector<SDL_GPUColorTargetDescription> colorTargetDescriptions(targetFormats.size());
+	for (size_t i = 0; i < targetFormats.size(); i++)
+		colorTargetDescriptions[i].format = targetFormats[i];
 
 	SDL_GPUGraphicsPipelineTargetInfo targetInfo{};
-	targetInfo.num_color_targets = 1;
-	targetInfo.color_target_descriptions = colorTargetDescriptions;
+	targetInfo.num_color_targets = (Uint32)colorTargetDescriptions.size();
+	targetInfo.color_target_descriptions = colorTargetDescriptions.data();
 
 	SDL_GPURasterizerState rasterizerState{};
 	rasterizerState.cull_mode = SDL_GPU_CULLMODE_NONE;
@@ -433,19 +479,99 @@ bool Renderer::SetupScenePipeline()
 	pipelineCreateInfo.rasterizer_state = rasterizerState;
 
 	// Create graphics pipeline
-	scenePipeline = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineCreateInfo);
-	if (scenePipeline == nullptr)
-	{
-		SDL_Log("Failed to create scene pipeline.");
-		return false;
-	}
+	SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineCreateInfo);
 
 	SDL_ReleaseGPUShader(gpuDevice, vertexShader);
 	SDL_ReleaseGPUShader(gpuDevice, fragmentShader);
 
+	return pipeline;
+}
+
+bool Renderer::CreateRenderTargets(int width, int height)
+{
+	ReleaseRenderTargets();
+
+	targetSize = { width, height };
+	sceneTexture = CreateRenderTarget(targetSize);
+	screenTexture = CreateRenderTarget(targetSize, SCREEN_FORMAT);
+	maskTexture = CreateRenderTarget(targetSize, MASK_FORMAT);
+	bakeCrt = true;
+
+	// Every level of the bloom chain is half the size of the one before, down to a single texel
+	SDL_Point size = targetSize;
+	for (int level = 0; level < BLOOM_LEVELS; level++)
+	{
+		size = { SDL_max(size.x / 2, 1), SDL_max(size.y / 2, 1) };
+		bloomSizes[level] = size;
+		bloomTextures[level] = CreateRenderTarget(size);
+	}
+
+	bloomBlurTexture = CreateRenderTarget(size);
+
+	if (sceneTexture == nullptr || screenTexture == nullptr || maskTexture == nullptr || bloomTextures[BLOOM_LEVELS - 1] == nullptr || bloomBlurTexture == nullptr)
+	{
+		SDL_Log("Failed to create render targets: %s", SDL_GetError());
+		ReleaseRenderTargets();
+		return false;
+	}
+
 	return true;
 }
 
+void Renderer::ReleaseRenderTargets()
+{
+	// Textures still in use by frames in flight are only released once the GPU is done with them
+	vector<SDL_GPUTexture**> textures = { &sceneTexture, &screenTexture, &maskTexture, &bloomBlurTexture };
+	for (int level = 0; level < BLOOM_LEVELS; level++)
+		textures.push_back(&bloomTextures[level]);
+
+	for (SDL_GPUTexture** texture : textures)
+	{
+		if (*texture != nullptr)
+			SDL_ReleaseGPUTexture(gpuDevice, *texture);
+
+		*texture = nullptr;
+	}
+
+	targetSize = {};
+}
+
+SDL_GPUTexture* Renderer::CreateRenderTarget(SDL_Point size, SDL_GPUTextureFormat format)
+{
+	SDL_GPUTextureCreateInfo textureCreateInfo{};
+	textureCreateInfo.type = SDL_GPU_TEXTURETYPE_2D,
+	textureCreateInfo.width = size.x;
+	textureCreateInfo.height = size.y;
+	textureCreateInfo.layer_count_or_depth = 1;
+	textureCreateInfo.num_levels = 1;
+	textureCreateInfo.sample_count = SDL_GPU_SAMPLECOUNT_1;
+	textureCreateInfo.format = format;
+	textureCreateInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+	return SDL_CreateGPUTexture(gpuDevice, &textureCreateInfo);
+}
+
+void Renderer::RenderFullscreenPass(SDL_GPUCommandBuffer* commandBuffer, SDL_GPUGraphicsPipeline* pipeline, SDL_GPUTexture* source, SDL_GPUTexture* target, const void* uniform, Uint32 uniformSize)
+{
+	// Every texel of the target is written, so there's nothing to clear or load
+	SDL_GPUColorTargetInfo targetInfo = { 0 };
+	targetInfo.texture = target;
+	targetInfo.load_op = SDL_GPU_LOADOP_DONT_CARE;
+	targetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+	SDL_PushGPUFragmentUniformData(commandBuffer, 0, uniform, uniformSize);
+
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(commandBuffer, &targetInfo, 1, nullptr);
+	SDL_BindGPUGraphicsPipeline(renderPass, pipeline);
+
+	SDL_GPUTextureSamplerBinding textureSamplerBinding{};
+	textureSamplerBinding.texture = source;
+	textureSamplerBinding.sampler = sampler;
+	SDL_BindGPUFragmentSamplers(renderPass, 0, &textureSamplerBinding, 1);
+
+	SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+	SDL_EndGPURenderPass(renderPass);
+}
+
 bool Renderer::SetupPostPipeline()
 {
 	// Setup shaders
@@ -456,7 +582,7 @@ bool Renderer::SetupPostPipeline()
 		return false;
 	}	
 
-	SDL_GPUShader* fragmentShader = LoadShader(gpuDevice, "post.frag", 1, 1, 0, 0);
+	SDL_GPUShader* fragmentShader = LoadShader(gpuDevice, "post.frag", 5, 1, 0, 0);
 	if (fragmentShader == nullptr)
 	{
 		SDL_Log("Failed to create post fragment shader.");
@@ -5,6 +5,9 @@
 #include <cstdint>
 #include <vector>
 #include "SDL3/SDL.h"
+#include "DisplaySink.h"
+#include "Framebuffer.h"
+#include "UploadRing.h"
 
 // Forward declarations
 class Window;
@@ -19,13 +22,23 @@ union SDL_Event;
 using namespace std;
 
 /**
- * @brief The Renderer does all the visual lifting, providing an interface for Emulator to talk to.
+ * @brief The Renderer does all the visual lifting, acting as the DisplaySink the Emulator presents its frames to.
  * 
- * The code works hand in hand with SDL's GPU framework, rendering the 64x32 screenBuffer vector to a series of quads,
- * which get rendered to a texture through the so called scenePipeline. This texture gets rendered as a single quad to
+ * The code works hand in hand with SDL's GPU framework, uploading nothing but the 256 bytes of the Framebuffer's packed
+ * rows, which the chip8.frag.hlsl fragment shader expands into pixels on a single fullscreen triangle. This gets
+ * rendered to a texture through the so called scenePipeline. This texture gets rendered as a single quad to
  * the screen through the postPipeline, where the post.frag.hlsl fragment shader does a bunch of post effects.
+ *
+ * Its bloom is prepared by passes of their own at a fraction of the resolution: the scene is downsampled BLOOM_LEVELS
+ * times, halving it each time, and the smallest level gets a separable Gaussian blur, first horizontally and then
+ * vertically, which post.frag.hlsl upsamples through bilinear filtering. This costs a few texture fetches per pixel,
+ * where blurring at the full resolution of the window took hundreds.
+ *
+ * Everything else of the CRT look which only depends on the window size, such as its curvature, scanlines and vignette,
+ * is baked by the crtPipeline into screenTexture and maskTexture whenever the window is resized, and the curve applied
+ * to the levels into levelsTexture once, leaving post.frag.hlsl with lookups.
  */
-class Renderer
+class Renderer : public DisplaySink
 {
 public:
 	/**
@@ -51,20 +64,10 @@ public:
 	void Render();
 
 	/**
-	 * @brief Clears the frame buffer. Intended for CHIP-8's 00E0 instruction.
+	 * @brief Takes a copy of the Emulator's Framebuffer, rendering it on the next Render().
+	 * @param framebuffer The Framebuffer to show.
 	 */
-	void Clear();
-
-	/**
-	 * @brief Modifies the frame buffer. Intended for CHIP-8's DXYN instruction. 
-	 * @param x The X coordinate at which we should be drawing.
-	 * @param y The Y coordinate at which we should be drawing.
-	 * @param n Number of rows we should be drawing (height).
-	 * @param I Start location in memory from which we should be drawing.
-	 * @param memory Reference to the Emulator's memory.
-	 * @param vars Reference to the Emulator's vars memory.
-	 */
-	void Display(uint8_t x, uint8_t y, uint8_t n, uint16_t I, vector<uint8_t>& memory, vector<uint8_t>& vars);
+	void Present(const Framebuffer& framebuffer) override;
 
 private:
 	/**
@@ -82,11 +85,69 @@ private:
 	bool SetupDevice();
 
 	/**
-	 * @brief Sets up the SDL_GPUGraphicsPipeline used for rendering the CHIP-8 pixels to quads (scene).
+	 * @brief Sets up the SDL_GPUGraphicsPipeline used for expanding the packed rows into CHIP-8's pixels (scene).
 	 * @return Returns whether pipeline was set up correctly.
 	 */
 	bool SetupScenePipeline();
 
+	/**
+	 * @brief Sets up the SDL_GPUGraphicsPipelines used for downsampling and blurring the scene into its bloom.
+	 * @return Returns whether both pipelines were set up correctly.
+	 */
+	bool SetupBloomPipelines();
+
+	/**
+	 * @brief Sets up the SDL_GPUGraphicsPipeline used for baking the CRT look into screenTexture and maskTexture.
+	 * @return Returns whether pipeline was set up correctly.
+	 */
+	bool SetupCrtPipeline();
+
+	/**
+	 * @brief Creates an SDL_GPUGraphicsPipeline drawing a single fullscreen triangle, generated by chip8.vert without any
+	 * vertex buffer.
+	 * @param fragmentShaderFilename Filename of the fragment shader.
+	 * @param samplerCount How many samplers the fragment shader utilizes.
+	 * @param uniformBufferCount How many uniforms the fragment shader utilizes.
+	 * @param storageBufferCount How many storage buffers the fragment shader utilizes.
+	 * @param targetFormats Format of every texture rendered to at once.
+	 * @return Returns the pipeline, or nullptr if it couldn't be created.
+	 */
+	SDL_GPUGraphicsPipeline* CreateFullscreenPipeline(const char* fragmentShaderFilename, Uint32 samplerCount, Uint32 uniformBufferCount, Uint32 storageBufferCount,
+		const vector<SDL_GPUTextureFormat>& targetFormats = { SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM });
+
+	/**
+	 * @brief Creates the textures sized after the window, rendered to before the post effects: sceneTexture, the bloom
+	 * chain, and the CRT lookups, which get baked on the next Render(). Releases any created before.
+	 * @param width Width of sceneTexture, in pixels.
+	 * @param height Height of sceneTexture, in pixels.
+	 * @return Returns whether all textures were created.
+	 */
+	bool CreateRenderTargets(int width, int height);
+
+	/**
+	 * @brief Releases every texture created by CreateRenderTargets().
+	 */
+	void ReleaseRenderTargets();
+
+	/**
+	 * @brief Creates a single texture which can be rendered to and sampled.
+	 * @param size Size of the texture, in pixels.
+	 * @param format Format of the texture.
+	 * @return Returns the texture, or nullptr if it couldn't be created.
+	 */
+	SDL_GPUTexture* CreateRenderTarget(SDL_Point size, SDL_GPUTextureFormat format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM);
+
+	/**
+	 * @brief Records a render pass drawing a fullscreen triangle to a texture, sampling another.
+	 * @param commandBuffer The frame's command buffer.
+	 * @param pipeline Pipeline created by CreateFullscreenPipeline(), with a single sampler and uniform.
+	 * @param source Texture the fragment shader samples.
+	 * @param target Texture rendered to, all of which is overwritten.
+	 * @param uniform Data of the fragment shader's uniform.
+	 * @param uniformSize Size of the uniform data, in bytes.
+	 */
+	void RenderFullscreenPass(SDL_GPUCommandBuffer* commandBuffer, SDL_GPUGraphicsPipeline* pipeline, SDL_GPUTexture* source, SDL_GPUTexture* target, const void* uniform, Uint32 uniformSize);
+
 	/**
 	 * @brief Sets up the SDL_GPUGraphicsPipeline used for rendering the texture quad for post effects (post).
 	 * @return Returns whether pipeline was set up correctly.
@@ -106,22 +167,39 @@ private:
 	SDL_GPUShader* LoadShader(SDL_GPUDevice* device, const char* shaderFilename, Uint32 samplerCount, Uint32 uniformBufferCount, Uint32 storageBufferCount, Uint32 storageTextureCount);
 
 	const int FRAMES_PER_SECOND = 60;					///< Target frames per second the Renderer tries to render at.
-	const int NUM_VERTICES = 64 * 32 * 6;				///< Number of vertices needed to render all quads for the framebuffer.
-														//TODO should rely on the configuration in Window
+	static const int BLOOM_LEVELS = 2;					///< Number of times the scene is halved before blurring it into its bloom.
+	static const int LEVELS_SIZE = 256;					///< Number of entries of the levels curve.
+	static constexpr float LEVELS_CURVE_STRENGTH = 1.7f;	///< Exponent of the curve applied to the levels.
+	static const SDL_GPUTextureFormat SCREEN_FORMAT = SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT;	///< Format of screenTexture, precise enough to address every texel of the scene.
+	static const SDL_GPUTextureFormat MASK_FORMAT = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;	///< Format of maskTexture, whose vignette goes beyond 1.
+	const int FRAMEBUFFER_SIZE = sizeof(uint64_t) * Framebuffer::HEIGHT;	///< Size of the packed rows uploaded every redraw, in bytes.
 
 	Window* window = nullptr;							///< Reference to earlier created window in which the Renderer resides.
 	SDL_GPUDevice* gpuDevice = nullptr;					///< The single SDL_GPUDevice used to render.
 	SDL_GPUGraphicsPipeline* scenePipeline = nullptr;	///< SDL pipeline for rendering CHIP-8's pixels.
 	SDL_GPUGraphicsPipeline* postPipeline = nullptr;	///< SDL pipeline for post effects.
-	SDL_GPUBuffer* sceneVertexBuffer = nullptr;			///< Vertex buffer for the scene.
+	SDL_GPUGraphicsPipeline* downsamplePipeline = nullptr;	///< SDL pipeline halving a texture, for bloom.
+	SDL_GPUGraphicsPipeline* blurPipeline = nullptr;	///< SDL pipeline blurring a texture along a single axis, for bloom.
+	SDL_GPUGraphicsPipeline* crtPipeline = nullptr;		///< SDL pipeline baking the CRT look into screenTexture and maskTexture.
+	SDL_GPUBuffer* framebufferBuffer = nullptr;			///< Storage buffer holding the packed rows of framebuffer for the scene.
 	SDL_GPUBuffer* postVertexBuffer = nullptr;			///< Vertex buffer for post effects.
 	SDL_GPUBuffer* postIndexBuffer = nullptr;			///< Index buffer for the post effects.
 	SDL_GPUTexture* sceneTexture = nullptr;				///< Texture to which the scene is rendered, utilized in post.
+	SDL_GPUTexture* bloomTextures[BLOOM_LEVELS] = {};	///< The scene halved once per level, the last one blurred and utilized in post.
+	SDL_GPUTexture* bloomBlurTexture = nullptr;			///< The last bloom level blurred horizontally only.
+	SDL_Point targetSize = {};							///< Size of sceneTexture, in pixels.
+	SDL_Point bloomSizes[BLOOM_LEVELS] = {};			///< Size of every level of bloomTextures, in pixels.
+	SDL_GPUTexture* screenTexture = nullptr;			///< Where every pixel of the window lands on sceneTexture, baked per resize.
+	SDL_GPUTexture* maskTexture = nullptr;				///< Scanlines, sub pixels and vignette of every pixel of the window, baked per resize.
+	SDL_GPUTexture* levelsTexture = nullptr;			///< The curve applied to the levels, indexed by value.
+	bool bakeCrt = false;								///< Whether screenTexture and maskTexture need baking on the next Render().
 	SDL_GPUSampler* sampler = nullptr;					///< Texture sampler used to sample sceneTexture.
+	SDL_GPUSampler* nearestSampler = nullptr;			///< Texture sampler used to sample the lookups baked per pixel.
+	UploadRing uploadRing;								///< Transfer buffers every frame's uploads are staged in.
 	
-	vector<vector<bool>> screenBuffer;					///< 2D vector representing CHIP-8's pixels being either on or off.
+	Framebuffer framebuffer;							///< Copy of the most recently presented Framebuffer.
 	bool initialized = false;							///< Whether the Renderer is initialized.
-	bool redraw = true;									///< Flipped to true when screenBuffer has been updated to enforce a redraw on the next Render()
+	bool redraw = true;									///< Flipped to true when framebuffer has been updated to enforce a redraw on the next Render()
 														///< Initializes as 'true' so it automatically renders a clear frame.
 	float nextRenderTime = 0.f;							///< Internal clockwork to keep track of when the next draw should be taking place.
 };
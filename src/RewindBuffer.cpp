@@ -0,0 +1,207 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "RewindBuffer.h"
+#include <cstring>
+
+namespace
+{
+	/**
+	 * @brief Reference keyframes are encoded relative to, so they're stored as runs of zeroes and raw bytes.
+	 */
+	alignas(64) const uint8_t ZERO_STATE[sizeof(MachineState)] = {};
+
+	/**
+	 * @brief Reads 8 bytes at once, regardless of alignment.
+	 * @param data Pointer to the first byte.
+	 * @return Returns the bytes as a single word.
+	 */
+	inline uint64_t LoadWord(const uint8_t* data)
+	{
+		uint64_t word;
+		memcpy(&word, data, sizeof(word));
+		return word;
+	}
+
+	/**
+	 * @brief Writes a length using 7 bits per byte, the high bit marking that more bytes follow.
+	 * @param output Where to write the length.
+	 * @param length The length to write.
+	 * @return Returns the position after the written bytes.
+	 */
+	inline uint8_t* WriteLength(uint8_t* output, size_t length)
+	{
+		while (length >= 0x80)
+		{
+			*output++ = (uint8_t)(length | 0x80);
+			length >>= 7;
+		}
+
+		*output++ = (uint8_t)length;
+		return output;
+	}
+
+	/**
+	 * @brief Reads a length written by WriteLength().
+	 * @param input Where to read the length, moved past it.
+	 * @return Returns the length.
+	 */
+	inline size_t ReadLength(const uint8_t*& input)
+	{
+		size_t length = 0;
+		for (int shift = 0; ; shift += 7)
+		{
+			const uint8_t byte = *input++;
+			length |= (size_t)(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return length;
+		}
+	}
+}
+
+RewindBuffer::RewindBuffer(size_t capacity, uint32_t maxFrames, uint32_t keyframeInterval) :
+	buffer(capacity),
+	frames(maxFrames),
+	keyframeInterval(keyframeInterval),
+	scratch(MAX_ENCODED_SIZE)
+{
+}
+
+void RewindBuffer::Record(const MachineState& state)
+{
+	bool isKeyframe = numFrames == 0 || GetFrame(numFrames - 1).keyframeDistance + 1 >= keyframeInterval;
+	const uint8_t* reference = isKeyframe ? ZERO_STATE : reinterpret_cast<const uint8_t*>(&keyframe);
+	size_t size = Encode(reinterpret_cast<const uint8_t*>(&state), reference, scratch.data());
+
+	if (size > buffer.size())
+		return;
+
+	if (numFrames == frames.size())
+		DropOldestKeyframe();
+
+	MakeRoom(size);
+
+	// Making room dropped the keyframe this frame is relative to, store it as a keyframe instead
+	if (!isKeyframe && numFrames == 0)
+	{
+		isKeyframe = true;
+		size = Encode(reinterpret_cast<const uint8_t*>(&state), ZERO_STATE, scratch.data());
+		MakeRoom(size);
+	}
+
+	Frame& frame = GetFrame(numFrames++);
+	frame.offset = (uint32_t)writeOffset;
+	frame.size = (uint32_t)size;
+	frame.keyframeDistance = isKeyframe ? 0 : GetFrame(numFrames - 2).keyframeDistance + 1;
+
+	memcpy(&buffer[writeOffset], scratch.data(), size);
+	writeOffset += size;
+
+	if (isKeyframe)
+		memcpy(&keyframe, &state, STATE_SIZE);
+}
+
+bool RewindBuffer::StepBack(MachineState& state)
+{
+	if (numFrames == 0)
+		return false;
+
+	const Frame frame = GetFrame(--numFrames);
+	const uint8_t* reference = frame.keyframeDistance == 0 ? ZERO_STATE : reinterpret_cast<const uint8_t*>(&keyframe);
+	Decode(&buffer[frame.offset], reference, reinterpret_cast<uint8_t*>(&state));
+
+	// The space of the removed frame is written to next
+	writeOffset = frame.offset;
+
+	// Stepped back past a keyframe, the frames before it are relative to the one preceding it
+	if (frame.keyframeDistance == 0 && numFrames > 0)
+	{
+		const Frame& previousKeyframe = GetFrame(numFrames - 1 - GetFrame(numFrames - 1).keyframeDistance);
+		Decode(&buffer[previousKeyframe.offset], ZERO_STATE, reinterpret_cast<uint8_t*>(&keyframe));
+	}
+
+	return true;
+}
+
+void RewindBuffer::Clear()
+{
+	writeOffset = 0;
+	firstFrame = 0;
+	numFrames = 0;
+}
+
+size_t RewindBuffer::GetUsedBytes() const
+{
+	size_t usedBytes = 0;
+	for (uint32_t i = 0; i < numFrames; i++)
+		usedBytes += frames[(firstFrame + i) % frames.size()].size;
+
+	return usedBytes;
+}
+
+size_t RewindBuffer::Encode(const uint8_t* current, const uint8_t* reference, uint8_t* output)
+{
+	uint8_t* start = output;
+	size_t i = 0;
+
+	while (i < STATE_SIZE)
+	{
+		// Unchanged bytes, skipped a word at a time as that's what most of them are
+		const size_t runStart = i;
+		while (i + sizeof(uint64_t) <= STATE_SIZE && LoadWord(current + i) == LoadWord(reference + i))
+			i += sizeof(uint64_t);
+		while (i < STATE_SIZE && current[i] == reference[i])
+			i++;
+
+		// Changed bytes, including single unchanged ones in between, as those are cheaper to store than a new run
+		const size_t literalStart = i;
+		while (i < STATE_SIZE && (current[i] != reference[i] || (i + 1 < STATE_SIZE && current[i + 1] != reference[i + 1])))
+			i++;
+
+		output = WriteLength(output, literalStart - runStart);
+		output = WriteLength(output, i - literalStart);
+		for (size_t j = literalStart; j < i; j++)
+			*output++ = current[j] ^ reference[j];
+	}
+
+	return output - start;
+}
+
+void RewindBuffer::Decode(const uint8_t* input, const uint8_t* reference, uint8_t* output)
+{
+	memcpy(output, reference, STATE_SIZE);
+
+	size_t i = 0;
+	while (i < STATE_SIZE)
+	{
+		i += ReadLength(input);
+
+		const size_t literalEnd = i + ReadLength(input);
+		for (; i < literalEnd; i++)
+			output[i] ^= *input++;
+	}
+}
+
+void RewindBuffer::DropOldestKeyframe()
+{
+	do
+	{
+		firstFrame = (firstFrame + 1) % frames.size();
+		numFrames--;
+	}
+	while (numFrames > 0 && GetFrame(0).keyframeDistance != 0);
+}
+
+void RewindBuffer::MakeRoom(size_t size)
+{
+	// Frames from writeOffset onwards are the oldest, so when wrapping around, drop those left at the end
+	if (writeOffset + size > buffer.size())
+	{
+		while (numFrames > 0 && GetFrame(0).offset >= writeOffset)
+			DropOldestKeyframe();
+
+		writeOffset = 0;
+	}
+
+	while (numFrames > 0 && GetFrame(0).offset >= writeOffset && GetFrame(0).offset < writeOffset + size)
+		DropOldestKeyframe();
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "MachineState.h"
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Fixed size history of MachineStates, recorded once per frame and stepped back through one frame at a time.
+ *
+ * Every keyframeInterval frames a keyframe is stored, all other frames are stored as the XOR of their MachineState and
+ * the preceding keyframe. Either way the stored bytes are run-length encoded as alternating runs of unchanged bytes,
+ * which are only counted, and changed ones, which are kept. As a frame rarely changes more than a few bytes of memory
+ * and display, most frames take up a few dozen bytes.
+ *
+ * Both the encoded bytes and the list of frames live in ring buffers allocated up front. When either is full, the
+ * oldest keyframe is dropped together with all frames depending on it.
+ */
+class RewindBuffer
+{
+public:
+	/**
+	 * @brief Constructor, allocating all memory the RewindBuffer will ever use.
+	 * @param capacity Number of bytes available to encoded frames.
+	 * @param maxFrames Maximum number of frames kept, regardless of their size.
+	 * @param keyframeInterval Number of frames from one keyframe to the next.
+	 */
+	RewindBuffer(size_t capacity = DEFAULT_CAPACITY, uint32_t maxFrames = DEFAULT_MAX_FRAMES, uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+	/**
+	 * @brief Records a frame, dropping the oldest ones if it doesn't fit.
+	 * @param state The MachineState at the end of the frame.
+	 */
+	void Record(const MachineState& state);
+
+	/**
+	 * @brief Removes the most recently recorded frame.
+	 * @param state Receives the MachineState of the removed frame.
+	 * @return Returns false if no frames are left.
+	 */
+	bool StepBack(MachineState& state);
+
+	/**
+	 * @brief Forgets all recorded frames.
+	 */
+	void Clear();
+
+	/**
+	 * @brief Gets the number of frames which can be stepped back through.
+	 * @return Returns the number of recorded frames.
+	 */
+	uint32_t GetNumFrames() const { return numFrames; }
+
+	/**
+	 * @brief Gets the number of bytes taken up by encoded frames.
+	 * @return Returns the number of bytes in use, at most the capacity.
+	 */
+	size_t GetUsedBytes() const;
+
+	static const size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;		///< Bytes available to encoded frames, unless specified otherwise.
+	static const uint32_t DEFAULT_MAX_FRAMES = 10 * 60 * 60;	///< Ten minutes of frames at 60 frames per second.
+	static const uint32_t DEFAULT_KEYFRAME_INTERVAL = 60;		///< One keyframe per second at 60 frames per second.
+
+private:
+	/**
+	 * @brief Where a recorded frame is stored in the buffer.
+	 */
+	struct Frame
+	{
+		uint32_t offset = 0;			///< Offset of the encoded frame in the buffer.
+		uint32_t size = 0;				///< Number of bytes of the encoded frame.
+		uint32_t keyframeDistance = 0;	///< Number of frames since the keyframe this frame is relative to, 0 for keyframes.
+	};
+
+	/**
+	 * @brief Run-length encodes the XOR of two MachineStates.
+	 * @param current The MachineState to encode.
+	 * @param reference The MachineState to encode the difference to.
+	 * @param output Receives the encoded bytes, must hold at least MAX_ENCODED_SIZE bytes.
+	 * @return Returns the number of encoded bytes.
+	 */
+	static size_t Encode(const uint8_t* current, const uint8_t* reference, uint8_t* output);
+
+	/**
+	 * @brief Decodes what Encode() produced.
+	 * @param input The encoded bytes.
+	 * @param reference The MachineState the bytes were encoded relative to.
+	 * @param output Receives the decoded MachineState.
+	 */
+	static void Decode(const uint8_t* input, const uint8_t* reference, uint8_t* output);
+
+	/**
+	 * @brief Gets a recorded frame.
+	 * @param index Index of the frame, 0 being the oldest.
+	 * @return Returns the Frame.
+	 */
+	Frame& GetFrame(uint32_t index) { return frames[(firstFrame + index) % frames.size()]; }
+
+	/**
+	 * @brief Drops the oldest keyframe, and every frame relative to it.
+	 */
+	void DropOldestKeyframe();
+
+	/**
+	 * @brief Makes room at the write position for a frame, wrapping around the end of the buffer if it doesn't fit.
+	 * @param size Number of bytes needed.
+	 */
+	void MakeRoom(size_t size);
+
+	static const size_t STATE_SIZE = sizeof(MachineState);		///< Number of bytes Encode() compares.
+	static const size_t MAX_ENCODED_SIZE = 3 * STATE_SIZE;		///< Upper bound of the number of bytes Encode() outputs.
+
+	vector<uint8_t> buffer;					///< Ring buffer holding all encoded frames.
+	size_t writeOffset = 0;					///< Offset in buffer the next frame is written to.
+	vector<Frame> frames;					///< Ring buffer of all recorded frames, oldest first.
+	uint32_t firstFrame = 0;				///< Index in frames of the oldest frame.
+	uint32_t numFrames = 0;					///< Number of recorded frames.
+	const uint32_t keyframeInterval;		///< Number of frames from one keyframe to the next.
+	MachineState keyframe;					///< The keyframe the most recent frame is relative to.
+	vector<uint8_t> scratch;				///< Frame being encoded, before it's known where it fits in buffer.
+};
@@ -0,0 +1,403 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "RomCompiler.h"
+#include "CompiledRom.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * @brief Formats a value as a hexadecimal C++ literal, eg. 0x2A0.
+ */
+static string Hex(uint32_t value, int width = 3)
+{
+	stringstream stream;
+	stream << "0x" << uppercase << hex << setw(width) << setfill('0') << value;
+	return stream.str();
+}
+
+RomCompiler::RomCompiler(const string romPath) :
+	romPath(romPath),
+	memory(MEMORY_SIZE, 0),
+	reachable(MEMORY_SIZE, false),
+	leaders(MEMORY_SIZE, false)
+{
+	// Derive an identifier from the filename
+	for (char c : filesystem::path(romPath).stem().string())
+		name += isalnum((unsigned char)c) ? c : '_';
+}
+
+bool RomCompiler::Analyze()
+{
+	// Load ROM
+	ifstream file(romPath, ios::binary);
+	if (!file)
+	{
+		cerr << "Could not open '" << romPath << "'" << endl;
+		return false;
+	}
+
+	rom.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	if (rom.empty() || rom.size() > MEMORY_SIZE - PROGRAM_START)
+	{
+		cerr << "'" << romPath << "' is not a valid ROM" << endl;
+		return false;
+	}
+
+	copy(rom.begin(), rom.end(), memory.begin() + PROGRAM_START);
+
+	// Recursive descent from the entry point, building the control-flow graph
+	vector<uint32_t> pending = { PROGRAM_START };
+	leaders[PROGRAM_START] = true;
+
+	auto follow = [&](uint32_t address, bool isLeader)
+	{
+		if (!IsInRom(address))
+			return;
+
+		if (isLeader)
+			leaders[address] = true;
+
+		if (!reachable[address])
+			pending.push_back(address);
+	};
+
+	while (!pending.empty())
+	{
+		const uint32_t address = pending.back();
+		pending.pop_back();
+
+		if (reachable[address])
+			continue;
+
+		reachable[address] = true;
+
+		const Opcode opcode = ReadOpcode(address);
+		switch (Classify(opcode))
+		{
+			case OpcodeKind::Native:
+				follow(address + 2, false);
+				break;
+
+			case OpcodeKind::Jump:
+				follow(opcode & 0xFFF, true);
+				break;
+
+			case OpcodeKind::Skip:
+				follow(address + 2, true);
+				follow(address + 4, true);
+				break;
+
+			case OpcodeKind::Call:
+				follow(opcode & 0xFFF, true);
+				follow(address + 2, true);
+				break;
+
+			case OpcodeKind::Return:
+				break;
+
+			// The interpreter continues at the next opcode, BNNN included, as this Emulator's BNNN only sets I
+			case OpcodeKind::Fallback:
+				follow(address + 2, true);
+				break;
+		}
+	}
+
+	return true;
+}
+
+bool RomCompiler::Emit(const string outputPath) const
+{
+	stringstream output;
+
+	output << "// Generated by chip8rc from '" << filesystem::path(romPath).filename().string() << "', do not edit." << endl;
+	output << endl;
+	output << "#include \"CompiledRom.h\"" << endl;
+	output << endl;
+	output << "namespace" << endl;
+	output << "{" << endl;
+
+	// Code ranges, used by the Emulator to detect self-modifying code
+	output << "\tconst uint16_t CODE_RANGES[][2] =" << endl;
+	output << "\t{" << endl;
+
+	uint32_t numCodeRanges = 0;
+	for (uint32_t address = 0; address < MEMORY_SIZE; address++)
+	{
+		if (!reachable[address] || Classify(ReadOpcode(address)) == OpcodeKind::Fallback)
+			continue;
+
+		uint32_t end = address + 2;
+		while (end < MEMORY_SIZE && reachable[end] && Classify(ReadOpcode(end)) != OpcodeKind::Fallback)
+			end += 2;
+
+		output << "\t\t{ " << Hex(address) << ", " << Hex(end) << " }," << endl;
+		numCodeRanges++;
+		address = end - 1;
+	}
+
+	if (numCodeRanges == 0)
+		output << "\t\t{ 0x000, 0x000 }," << endl;
+
+	output << "\t};" << endl;
+	output << endl;
+
+	// Translated code
+	output << "\tuint32_t Run(uint8_t* V, uint16_t& I, uint16_t& PC, uint32_t budget)" << endl;
+	output << "\t{" << endl;
+	output << "\t\tuint32_t executed = 0;" << endl;
+	output << endl;
+	output << "\t\tswitch (PC)" << endl;
+	output << "\t\t{" << endl;
+
+	for (uint32_t address = 0; address < MEMORY_SIZE; address++)
+	{
+		if (HasLabel(address))
+			output << "\t\t\tcase " << Hex(address) << ": goto L" << Hex(address, 3).substr(2) << ";" << endl;
+	}
+
+	output << "\t\t\tdefault: return 0;" << endl;
+	output << "\t\t}" << endl;
+
+	for (uint32_t leader = 0; leader < MEMORY_SIZE; leader++)
+	{
+		if (!HasLabel(leader))
+			continue;
+
+		// Gather the block's opcodes, up to and including a jump or skip, or up to the next leader
+		vector<uint32_t> addresses;
+		uint32_t address = leader;
+		do
+		{
+			const OpcodeKind kind = Classify(ReadOpcode(address));
+			if (kind == OpcodeKind::Native || kind == OpcodeKind::Jump || kind == OpcodeKind::Skip)
+				addresses.push_back(address);
+
+			if (kind != OpcodeKind::Native)
+				break;
+
+			address += 2;
+		} while (IsInRom(address) && !leaders[address]);
+
+		output << endl;
+		output << "\tL" << Hex(leader, 3).substr(2) << ":" << endl;
+		output << "\t\tif (budget - executed < " << addresses.size() << ") { PC = " << Hex(leader) << "; return executed; }" << endl;
+		output << "\t\texecuted += " << addresses.size() << ";" << endl;
+
+		for (uint32_t opcodeAddress : addresses)
+		{
+			const Opcode opcode = ReadOpcode(opcodeAddress);
+
+			switch (Classify(opcode))
+			{
+				case OpcodeKind::Jump:
+				{
+					output << "\t\t// " << Hex(opcode, 4).substr(2) << endl;
+					EmitTransfer(output, opcode & 0xFFF);
+					break;
+				}
+
+				case OpcodeKind::Skip:
+				{
+					const string VX = "V[" + Hex(((opcode >> 8) & 0xF), 1) + "]";
+					const string VY = "V[" + Hex(((opcode >> 4) & 0xF), 1) + "]";
+					const string NN = Hex(opcode & 0xFF, 2);
+					string condition;
+
+					switch (opcode >> 12)
+					{
+						case 0x3: condition = VX + " == " + NN; break;
+						case 0x4: condition = VX + " != " + NN; break;
+						case 0x5: condition = VX + " == " + VY; break;
+						case 0x9: condition = VX + " != " + VY; break;
+					}
+
+					output << "\t\t// " << Hex(opcode, 4).substr(2) << endl;
+					output << "\t\tif (" << condition << ")" << endl;
+					output << "\t\t{" << endl;
+					output << "\t";
+					EmitTransfer(output, opcodeAddress + 4);
+					output << "\t\t}" << endl;
+					EmitTransfer(output, opcodeAddress + 2);
+					break;
+				}
+
+				default:
+				{
+					EmitOpcode(output, opcode);
+					break;
+				}
+			}
+		}
+
+		// Fell through into the next leader, or into an opcode the interpreter handles
+		const uint32_t last = addresses.back();
+		const OpcodeKind lastKind = Classify(ReadOpcode(last));
+		if (lastKind == OpcodeKind::Native)
+			EmitTransfer(output, last + 2);
+	}
+
+	output << "\t}" << endl;
+	output << "}" << endl;
+	output << endl;
+
+	// Registration
+	output << "static const CompiledRom COMPILED_ROM =" << endl;
+	output << "{" << endl;
+	output << "\t\"" << name << "\"," << endl;
+	output << "\t" << Hex((uint32_t)(HashRom(rom.data(), rom.size()) >> 32), 8) << Hex((uint32_t)HashRom(rom.data(), rom.size()), 8).substr(2) << "ull," << endl;
+	output << "\t" << rom.size() << "," << endl;
+	output << "\t&Run," << endl;
+	output << "\tCODE_RANGES," << endl;
+	output << "\t" << numCodeRanges << "," << endl;
+	output << "};" << endl;
+	output << endl;
+	output << "static const bool registered = RegisterCompiledRom(&COMPILED_ROM);" << endl;
+
+	ofstream file(outputPath, ios::binary);
+	if (!file)
+	{
+		cerr << "Could not open '" << outputPath << "' for writing" << endl;
+		return false;
+	}
+
+	file << output.str();
+
+	return (bool)file;
+}
+
+RomCompiler::OpcodeKind RomCompiler::Classify(Opcode opcode)
+{
+	switch (opcode >> 12)
+	{
+		case 0x0:
+			return opcode == 0x00EE ? OpcodeKind::Return : OpcodeKind::Fallback;
+
+		case 0x1:
+			return OpcodeKind::Jump;
+
+		case 0x2:
+			return OpcodeKind::Call;
+
+		case 0x3:
+		case 0x4:
+		case 0x5:
+		case 0x9:
+			return OpcodeKind::Skip;
+
+		case 0x6:
+		case 0x7:
+		case 0xA:
+			return OpcodeKind::Native;
+
+		case 0x8:
+		{
+			switch (opcode & 0xF)
+			{
+				case 0x0: case 0x1: case 0x2: case 0x3: case 0x4: case 0x5: case 0x6: case 0x7: case 0xE:
+					return OpcodeKind::Native;
+			}
+
+			return OpcodeKind::Fallback;
+		}
+
+		case 0xF:
+			return (opcode & 0xFF) == 0x1E ? OpcodeKind::Native : OpcodeKind::Fallback;
+	}
+
+	return OpcodeKind::Fallback;
+}
+
+Opcode RomCompiler::ReadOpcode(uint16_t address) const
+{
+	return (memory[address & (MEMORY_SIZE - 1)] << 8) | memory[(address + 1) & (MEMORY_SIZE - 1)];
+}
+
+bool RomCompiler::IsInRom(uint32_t address) const
+{
+	return address >= PROGRAM_START && address + 1 < PROGRAM_START + rom.size();
+}
+
+bool RomCompiler::HasLabel(uint32_t address) const
+{
+	if (address >= MEMORY_SIZE || !leaders[address] || !reachable[address])
+		return false;
+
+	const OpcodeKind kind = Classify(ReadOpcode(address));
+	return kind == OpcodeKind::Native || kind == OpcodeKind::Jump || kind == OpcodeKind::Skip;
+}
+
+void RomCompiler::EmitTransfer(ostream& output, uint32_t address) const
+{
+	address &= 0xFFFF;
+
+	if (HasLabel(address))
+		output << "\t\tgoto L" << Hex(address, 3).substr(2) << ";" << endl;
+	else
+		output << "\t\tPC = " << Hex(address) << "; return executed;" << endl;
+}
+
+void RomCompiler::EmitOpcode(ostream& output, Opcode opcode)
+{
+	const string VX = "V[" + Hex((opcode >> 8) & 0xF, 1) + "]";
+	const string VY = "V[" + Hex((opcode >> 4) & 0xF, 1) + "]";
+	const string VF = "V[0xF]";
+	const string NN = Hex(opcode & 0xFF, 2);
+	const string NNN = Hex(opcode & 0xFFF);
+
+	output << "\t\t// " << Hex(opcode, 4).substr(2) << endl;
+
+	switch (opcode >> 12)
+	{
+		case 0x6: output << "\t\t" << VX << " = " << NN << ";" << endl; break;
+		case 0x7: output << "\t\t" << VX << " += " << NN << ";" << endl; break;
+		case 0xA: output << "\t\tI = " << NNN << ";" << endl; break;
+		case 0xF: output << "\t\tI += " << VX << ";" << endl; break;
+
+		// Statement order mirrors the interpreter, which matters when X or Y is F
+		case 0x8:
+		{
+			switch (opcode & 0xF)
+			{
+				case 0x0: output << "\t\t" << VX << " = " << VY << ";" << endl; break;
+				case 0x1: output << "\t\t" << VX << " |= " << VY << ";" << endl; break;
+				case 0x2: output << "\t\t" << VX << " &= " << VY << ";" << endl; break;
+				case 0x3: output << "\t\t" << VX << " ^= " << VY << ";" << endl; break;
+
+				case 0x4:
+					output << "\t\tif (" << VX << " + " << VY << " > 255) " << VF << " = 1;" << endl;
+					output << "\t\t" << VX << " += " << VY << ";" << endl;
+					break;
+
+				case 0x5:
+					output << "\t\t" << VF << " = " << VX << " >= " << VY << ";" << endl;
+					output << "\t\t" << VX << " = " << VX << " - " << VY << ";" << endl;
+					break;
+
+				case 0x6:
+					output << "#ifdef CHIP8_ORIGINAL" << endl;
+					output << "\t\t" << VX << " = " << VY << ";" << endl;
+					output << "#endif" << endl;
+					output << "\t\t{ const uint8_t shiftedBit = " << VX << " & 0x1; " << VX << " >>= 1; " << VF << " = shiftedBit; }" << endl;
+					break;
+
+				case 0x7:
+					output << "\t\t" << VF << " = " << VY << " >= " << VX << ";" << endl;
+					output << "\t\t" << VX << " = " << VY << " - " << VX << ";" << endl;
+					break;
+
+				case 0xE:
+					output << "#ifdef CHIP8_ORIGINAL" << endl;
+					output << "\t\t" << VX << " = " << VY << ";" << endl;
+					output << "#endif" << endl;
+					output << "\t\t{ const uint8_t shiftedBit = " << VX << " >> 7; " << VX << " <<= 1; " << VF << " = shiftedBit; }" << endl;
+					break;
+			}
+			break;
+		}
+	}
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Usings
+using Opcode = uint16_t;
+using namespace std;
+
+/**
+ * @brief Ahead-of-time recompiler, translating a CHIP-8 ROM into a C++ translation unit defining a CompiledRom.
+ *
+ * Analyze() disassembles the ROM recursively from PROGRAM_START, following fall-through, jumps, skips and calls, to
+ * build the control-flow graph of all reachable code, and to find the leaders: addresses at which execution can enter
+ * translated code. Emit() then writes one function containing a labeled block of straight-line C++ per leader, linked
+ * by gotos.
+ *
+ * Only opcodes working on registers and I, plus jumps and skips, are translated. All other opcodes, including calls,
+ * returns and the indirect BNNN, hand control back to the interpreter, which re-enters translated code at the next
+ * leader it reaches.
+ */
+class RomCompiler
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param romPath Path to the ROM to translate.
+	 */
+	RomCompiler(const string romPath);
+
+	/**
+	 * @brief Loads the ROM and builds its control-flow graph.
+	 * @return Returns false if the ROM couldn't be loaded.
+	 */
+	bool Analyze();
+
+	/**
+	 * @brief Writes the translation unit.
+	 * @param outputPath Path of the C++ file to write.
+	 * @return Returns whether the file was written successfully.
+	 */
+	bool Emit(const string outputPath) const;
+
+private:
+	/**
+	 * @brief How an opcode affects control flow, and whether it can be translated.
+	 */
+	enum class OpcodeKind
+	{
+		Native,		///< Translated, execution continues with the next opcode.
+		Jump,		///< 1NNN, translated into a goto.
+		Skip,		///< 3XNN, 4XNN, 5XY0 and 9XY0, translated into a conditional goto.
+		Call,		///< 2NNN, interpreted, but its target and return address are followed.
+		Return,		///< 00EE, interpreted, ends the path.
+		Fallback,	///< Interpreted, execution continues with the next opcode.
+	};
+
+	/**
+	 * @brief Determines the OpcodeKind of an opcode.
+	 * @param opcode The opcode to classify.
+	 * @return The opcode's OpcodeKind.
+	 */
+	static OpcodeKind Classify(Opcode opcode);
+
+	/**
+	 * @brief Reads the opcode at an address of the loaded ROM.
+	 * @param address Address of the opcode.
+	 * @return The opcode.
+	 */
+	Opcode ReadOpcode(uint16_t address) const;
+
+	/**
+	 * @brief Whether an address holds code which has been analyzed, and thus lies within the ROM.
+	 * @param address The address to check.
+	 * @return Returns whether the address is within the ROM.
+	 */
+	bool IsInRom(uint32_t address) const;
+
+	/**
+	 * @brief Whether translated code can be entered at an address, ie. whether it's a leader starting with a
+	 * translatable opcode.
+	 * @param address The address to check.
+	 * @return Returns whether there's a label for this address.
+	 */
+	bool HasLabel(uint32_t address) const;
+
+	/**
+	 * @brief Writes the C++ statements continuing execution at an address.
+	 * @param output Stream to write to.
+	 * @param address The address execution continues at.
+	 */
+	void EmitTransfer(ostream& output, uint32_t address) const;
+
+	/**
+	 * @brief Writes the C++ statements of a single translatable opcode, other than a jump or skip.
+	 * @param output Stream to write to.
+	 * @param opcode The opcode to translate.
+	 */
+	static void EmitOpcode(ostream& output, Opcode opcode);
+
+	static const uint32_t MEMORY_SIZE = 4096;		///< Size of CHIP-8's memory, matching Emulator.
+	static const uint32_t PROGRAM_START = 0x200;	///< Start point in memory where ROM data is copied to, matching Emulator.
+
+	const string romPath;							///< Path of the ROM to translate.
+	string name;									///< Identifier-safe name of the ROM, derived from romPath.
+	vector<uint8_t> rom;							///< Contents of the ROM.
+	vector<uint8_t> memory;							///< Memory as the Emulator would have it after loading the ROM.
+	vector<bool> reachable;							///< Whether an opcode starts at this address on some path.
+	vector<bool> leaders;							///< Whether translated code should be enterable at this address.
+};
@@ -0,0 +1,26 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include <iostream>
+#include <filesystem>
+#include "RomCompiler.h"
+
+int main(int argc, const char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cout << "Usage: " << std::filesystem::path(argv[0]).filename().string() << " <ROM path> <output .cpp path>" << std::endl;
+		std::cout << "Translates a CHIP-8 ROM to C++, to be linked into the emulator and run with --mode=compiled." << std::endl;
+		return -1;
+	}
+
+	RomCompiler compiler(argv[1]);
+	if (!compiler.Analyze())
+		return -1;
+
+	if (!compiler.Emit(argv[2]))
+		return -1;
+
+	std::cout << "Translated '" << argv[1] << "' to '" << argv[2] << "'" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+
+/**
+ * @brief Scripts the input of a player, moving a paddle in Pong and changing its mind every few frames.
+ * @param player Index of the player, 0 for the host and 1 for who joined.
+ * @param frame The frame to get the input of.
+ * @return Returns a bitset of keys being pressed.
+ */
+inline uint16_t GetScriptedKeys(int player, uint32_t frame)
+{
+	uint32_t hash = (frame / 8 + 1) * 0x9E3779B1u ^ (player + 1) * 0x85EBCA77u;
+	hash ^= hash >> 15;
+	hash *= 0x2C1B3C6Du;
+	hash ^= hash >> 12;
+
+	const uint16_t up = player == 0 ? 1 << 0x1 : 1 << 0xC;
+	const uint16_t down = player == 0 ? 1 << 0x4 : 1 << 0xD;
+	return (hash & 1 ? up : 0) | (hash & 2 ? down : 0);
+}
@@ -2,8 +2,10 @@
 #pragma once
 
 // Includes
+#include <atomic>
 #include "SDL3/SDL.h"
 #include "SDL3/SDL_audio.h"
+#include "AudioSink.h"
 
 // Forward declarations
 struct SDL_AudioStream;
@@ -15,7 +17,7 @@ struct SDL_AudioStream;
  * callback guarantees the smallest (1ms) beeps are audible. By implementing small attack/decays on the beep, we don't
  * get any off axis popping of the audio.
  */
-class Sound
+class Sound : public AudioSink
 {
 public:
 
@@ -34,7 +36,7 @@ public:
 	 * @brief Starts a beep for a specified duration in milliseconds.
 	 * @param ms The amount of milliseconds the beep should be playing.
 	 */
-	void StartBeep(uint16_t ms) { audioEndTime = SDL_GetTicks() + ms; }
+	void StartBeep(uint16_t ms) override { audioEndTime = SDL_GetTicks() + ms; }
 	
 	/**
 	 * @brief SDL's callback on the audio thread, doing the actual audio generation of the sine wave, gate handling and
@@ -57,6 +59,6 @@ private:
 	float samples[FREQUENCY] = {};							///< Our array of generated samples.
 	uint32_t phase = 0;										///< Point along the sine wave we are, allowing for continuous wave generation.
 	float volume = 0.f;										///< The audio gate as well as attack/decay multipliers.
-	uint64_t audioEndTime = 0;								///< Point in time at which the current play should stop.
+	std::atomic<uint64_t> audioEndTime = 0;					///< Point in time at which the current play should stop, set by the emulation thread.
 };
 
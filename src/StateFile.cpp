@@ -0,0 +1,169 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "StateFile.h"
+#include "Emulator.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const char* const StateFile::EXTENSION = ".state";
+
+StateFile::StateFile(const string romPath) :
+	path(romPath + EXTENSION),
+	romPath(romPath)
+{
+}
+
+StateFile::~StateFile()
+{
+	Close();
+}
+
+bool StateFile::Open()
+{
+	if (contents != nullptr)
+		return true;
+
+	// Identify the ROM without reading it, a changed ROM makes the state stale
+	error_code error;
+	romSize = (uint32_t)filesystem::file_size(romPath, error);
+	if (error)
+		romSize = 0;
+
+	romWriteTime = (int64_t)filesystem::last_write_time(romPath, error).time_since_epoch().count();
+	if (error)
+		romWriteTime = 0;
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		cerr << "Could not open '" << path << "'" << endl;
+		return false;
+	}
+
+	// Grows the file to the size of Contents if needed, a new file being filled with zeroes
+	file = fileHandle;
+	mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, 0, sizeof(Contents), nullptr);
+	if (mapping != nullptr)
+		contents = (Contents*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Contents));
+#else
+	file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (file < 0)
+	{
+		cerr << "Could not open '" << path << "'" << endl;
+		return false;
+	}
+
+	// Resizes the file to the size of Contents if needed, a new file being filled with zeroes
+	if (lseek(file, 0, SEEK_END) != (off_t)sizeof(Contents) && ftruncate(file, sizeof(Contents)) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* view = mmap(nullptr, sizeof(Contents), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	contents = view == MAP_FAILED ? nullptr : (Contents*)view;
+#endif
+
+	if (contents == nullptr)
+	{
+		cerr << "Could not map '" << path << "'" << endl;
+		Close();
+		return false;
+	}
+
+	const Header& header = contents->header;
+	resumable = header.magic == MAGIC &&
+		header.version == VERSION &&
+		header.stateSize == sizeof(MachineState) &&
+		header.romSize == romSize &&
+		header.romWriteTime == romWriteTime &&
+		header.checksum == Hash(contents->state);
+
+	return true;
+}
+
+void StateFile::Close()
+{
+	resumable = false;
+
+#ifdef _WIN32
+	if (contents != nullptr)
+		UnmapViewOfFile(contents);
+
+	if (mapping != nullptr)
+		CloseHandle(mapping);
+
+	if (file != nullptr)
+		CloseHandle(file);
+
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (contents != nullptr)
+		munmap(contents, sizeof(Contents));
+
+	if (file >= 0)
+		close(file);
+
+	file = -1;
+#endif
+
+	contents = nullptr;
+}
+
+void StateFile::Save(const Emulator& emulator)
+{
+	if (contents == nullptr)
+		return;
+
+	// A crash halfway leaves a checksum which doesn't match, so a partially saved state is never resumed
+	emulator.Snapshot(contents->state);
+
+	Header& header = contents->header;
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.stateSize = sizeof(MachineState);
+	header.romSize = romSize;
+	header.romWriteTime = romWriteTime;
+	header.checksum = Hash(contents->state);
+}
+
+void StateFile::Flush()
+{
+	if (contents == nullptr)
+		return;
+
+#ifdef _WIN32
+	FlushViewOfFile(contents, sizeof(Contents));
+#else
+	msync(contents, sizeof(Contents), MS_ASYNC);
+#endif
+}
+
+uint64_t StateFile::Hash(const MachineState& state)
+{
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(&state);
+	uint64_t hash = 0xCBF29CE484222325ull;
+
+	for (size_t i = 0; i < sizeof(MachineState); i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		hash ^= word;
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
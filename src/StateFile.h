@@ -0,0 +1,119 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "MachineState.h"
+
+// Forward declarations
+class Emulator;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief A MachineState persisted in a memory-mapped file next to the ROM, so a restarted process resumes where the
+ * previous one left off.
+ *
+ * Save() snapshots the Emulator straight into the mapping, which the OS writes back to disk even if the process
+ * crashes afterwards. A versioned header identifies the ROM the state belongs to by its size and modification time,
+ * and a checksum over the state rejects files which are corrupted or were only partially saved.
+ */
+class StateFile
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param romPath Path to the ROM whose state is persisted, the file being romPath with EXTENSION appended.
+	 */
+	StateFile(const string romPath);
+
+	/**
+	 * @brief Destructor, unmapping the file.
+	 */
+	~StateFile();
+
+	/**
+	 * @brief Opens or creates the file and maps it into memory, checking whether it holds a state to resume.
+	 * @return Returns false if the file couldn't be opened or mapped.
+	 */
+	bool Open();
+
+	/**
+	 * @brief Unmaps and closes the file, leaving its contents for the OS to write back.
+	 */
+	void Close();
+
+	/**
+	 * @brief Gets the state the file held when it was opened, if it's valid and belongs to the ROM as it is now.
+	 * @return Returns the mapped MachineState, or nullptr if there's nothing to resume.
+	 */
+	const MachineState* GetResumeState() const { return resumable ? &contents->state : nullptr; }
+
+	/**
+	 * @brief Gets the size of the ROM, as needed by Emulator::Resume().
+	 * @return Returns the size of the ROM in bytes.
+	 */
+	size_t GetRomSize() const { return romSize; }
+
+	/**
+	 * @brief Snapshots the Emulator into the file.
+	 * @param emulator The Emulator to save.
+	 */
+	void Save(const Emulator& emulator);
+
+	/**
+	 * @brief Asks the OS to start writing the file back to disk, without waiting for it.
+	 */
+	void Flush();
+
+	static const char* const EXTENSION;		///< Appended to the ROM's path to get the file's path.
+
+private:
+	/**
+	 * @brief Identifies the file's contents, preceding the MachineState.
+	 */
+	struct Header
+	{
+		uint32_t magic;						///< Always MAGIC.
+		uint32_t version;					///< VERSION the file was written with.
+		uint32_t stateSize;					///< sizeof(MachineState) the file was written with.
+		uint32_t romSize;					///< Size of the ROM in bytes.
+		int64_t romWriteTime;				///< Modification time of the ROM, in ticks of the filesystem clock.
+		uint64_t checksum;					///< Hash() of the MachineState.
+	};
+
+	/**
+	 * @brief Layout of the entire file.
+	 */
+	struct Contents
+	{
+		Header header;						///< Identifies the state.
+		MachineState state;					///< The persisted state, aligned like any other MachineState.
+	};
+
+	/**
+	 * @brief Hashes a MachineState (64 bit FNV-1a, a word at a time), to detect corrupt and partially saved files.
+	 * @param state The MachineState to hash.
+	 * @return Returns the hash.
+	 */
+	static uint64_t Hash(const MachineState& state);
+
+	static const uint32_t MAGIC = 0x53385043;			///< "CP8S" in little endian.
+	static const uint32_t VERSION = 2;					///< Increment whenever the layout of Contents or MachineState changes.
+
+	const string path;						///< Path of the file.
+	const string romPath;					///< Path of the ROM whose state is persisted.
+	uint32_t romSize = 0;					///< Size of the ROM in bytes.
+	int64_t romWriteTime = 0;				///< Modification time of the ROM, in ticks of the filesystem clock.
+	Contents* contents = nullptr;			///< The mapped file, or nullptr when not opened.
+	bool resumable = false;					///< Whether the file held a valid state for the ROM when it was opened.
+#ifdef _WIN32
+	void* file = nullptr;					///< Handle of the opened file.
+	void* mapping = nullptr;				///< Handle of the file mapping.
+#else
+	int file = -1;							///< Descriptor of the opened file.
+#endif
+};
@@ -0,0 +1,11 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "SteadyClock.h"
+#include <chrono>
+
+using namespace std;
+
+uint64_t SteadyClock::GetTicksNS()
+{
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
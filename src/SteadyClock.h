@@ -0,0 +1,18 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include "Clock.h"
+
+/**
+ * @brief Clock based on std::chrono::steady_clock, available on every host.
+ */
+class SteadyClock : public Clock
+{
+public:
+	/**
+	 * @brief Gets the time elapsed since an unspecified point in the past.
+	 * @return Returns the current time in nanoseconds.
+	 */
+	uint64_t GetTicksNS() override;
+};
@@ -0,0 +1,285 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "StreamSocket.h"
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+	using NativeSocket = SOCKET;
+#else
+	using NativeSocket = int;
+#endif
+
+	/**
+	 * @brief Closes an OS socket handle.
+	 * @param handle The handle to close.
+	 */
+	inline void CloseSocket(intptr_t handle)
+	{
+#ifdef _WIN32
+		closesocket((NativeSocket)handle);
+#else
+		close((NativeSocket)handle);
+#endif
+	}
+
+	/**
+	 * @brief Whether the most recent socket operation failed only because it would have had to wait.
+	 * @return Returns true if the operation should be retried later.
+	 */
+	inline bool WouldBlock()
+	{
+#ifdef _WIN32
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+	}
+}
+
+StreamSocket::~StreamSocket()
+{
+	Close();
+}
+
+StreamSocket::StreamSocket(StreamSocket&& other) noexcept :
+	handle(other.handle),
+	unixPath(move(other.unixPath))
+{
+	other.handle = INVALID_HANDLE;
+	other.unixPath.clear();
+}
+
+StreamSocket& StreamSocket::operator=(StreamSocket&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		handle = other.handle;
+		unixPath = move(other.unixPath);
+		other.handle = INVALID_HANDLE;
+		other.unixPath.clear();
+	}
+
+	return *this;
+}
+
+bool StreamSocket::Listen(const string address)
+{
+	sockaddr_storage storage = {};
+	int length = 0;
+	if (!Create(address, true, &storage, length))
+		return false;
+
+	// A stale socket file of a previous run would fail binding
+	if (storage.ss_family == AF_UNIX)
+	{
+		error_code error;
+		filesystem::remove(address.substr(5), error);
+	}
+	else
+	{
+		int reuse = 1;
+		setsockopt((NativeSocket)handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+	}
+
+	if (::bind((NativeSocket)handle, reinterpret_cast<const sockaddr*>(&storage), length) != 0 || listen((NativeSocket)handle, SOMAXCONN) != 0)
+	{
+		cerr << "Could not listen on '" << address << "'" << endl;
+		Close();
+		return false;
+	}
+
+	if (storage.ss_family == AF_UNIX)
+		unixPath = address.substr(5);
+
+	SetNonBlocking();
+	return true;
+}
+
+bool StreamSocket::Connect(const string address)
+{
+	sockaddr_storage storage = {};
+	int length = 0;
+	if (!Create(address, false, &storage, length))
+		return false;
+
+	if (connect((NativeSocket)handle, reinterpret_cast<const sockaddr*>(&storage), length) != 0)
+	{
+		cerr << "Could not connect to '" << address << "'" << endl;
+		Close();
+		return false;
+	}
+
+	SetNonBlocking();
+	return true;
+}
+
+bool StreamSocket::Accept(StreamSocket& client)
+{
+	const intptr_t clientHandle = (intptr_t)accept((NativeSocket)handle, nullptr, nullptr);
+	if (clientHandle == INVALID_HANDLE)
+		return false;
+
+	client.Close();
+	client.handle = clientHandle;
+	client.SetNonBlocking();
+
+	// Frames are small and should go out right away, rather than waiting to be merged with the next
+	int noDelay = 1;
+	setsockopt((NativeSocket)clientHandle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+	return true;
+}
+
+void StreamSocket::Close()
+{
+	if (handle != INVALID_HANDLE)
+		CloseSocket(handle);
+
+	handle = INVALID_HANDLE;
+
+	if (!unixPath.empty())
+	{
+		error_code error;
+		filesystem::remove(unixPath, error);
+		unixPath.clear();
+	}
+}
+
+uint16_t StreamSocket::GetPort() const
+{
+	sockaddr_storage storage = {};
+	socklen_t length = sizeof(storage);
+	if (getsockname((NativeSocket)handle, reinterpret_cast<sockaddr*>(&storage), &length) != 0 || storage.ss_family != AF_INET)
+		return 0;
+
+	return ntohs(reinterpret_cast<const sockaddr_in*>(&storage)->sin_port);
+}
+
+int StreamSocket::Send(const uint8_t* data, size_t size)
+{
+#ifdef MSG_NOSIGNAL
+	const int flags = MSG_NOSIGNAL;
+#else
+	const int flags = 0;
+#endif
+
+	const int sent = (int)send((NativeSocket)handle, reinterpret_cast<const char*>(data), (int)size, flags);
+	if (sent < 0)
+		return WouldBlock() ? 0 : -1;
+
+	return sent;
+}
+
+int StreamSocket::Receive(uint8_t* data, size_t maxSize)
+{
+	const int received = (int)recv((NativeSocket)handle, reinterpret_cast<char*>(data), (int)maxSize, 0);
+	if (received < 0)
+		return WouldBlock() ? 0 : -1;
+
+	// Orderly shutdown by the peer
+	if (received == 0)
+		return -1;
+
+	return received;
+}
+
+bool StreamSocket::Create(const string address, bool listening, void* storage, int& length)
+{
+	Close();
+
+#ifdef _WIN32
+	static const bool startedUp = []()
+	{
+		WSADATA data;
+		return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}();
+
+	if (!startedUp)
+		return false;
+#endif
+
+	if (address.rfind("unix:", 0) == 0)
+	{
+		sockaddr_un& unixAddress = *reinterpret_cast<sockaddr_un*>(storage);
+		const string path = address.substr(5);
+		if (path.empty() || path.size() >= sizeof(unixAddress.sun_path))
+		{
+			cerr << "Invalid socket path '" << path << "'" << endl;
+			return false;
+		}
+
+		unixAddress.sun_family = AF_UNIX;
+		memcpy(unixAddress.sun_path, path.c_str(), path.size() + 1);
+		length = (int)sizeof(sockaddr_un);
+	}
+	else
+	{
+		// The host may be left out when listening, to listen on all interfaces
+		const size_t colon = address.rfind(':');
+		const string host = colon == string::npos ? "" : address.substr(0, colon);
+		const string port = colon == string::npos ? address : address.substr(colon + 1);
+		if (port.empty() || (host.empty() && !listening))
+		{
+			cerr << "Invalid address '" << address << "'" << endl;
+			return false;
+		}
+
+		addrinfo hints = {};
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags = listening ? AI_PASSIVE : 0;
+
+		addrinfo* result = nullptr;
+		if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0 || result == nullptr)
+		{
+			cerr << "Could not resolve '" << address << "'" << endl;
+			return false;
+		}
+
+		memcpy(storage, result->ai_addr, result->ai_addrlen);
+		length = (int)result->ai_addrlen;
+		freeaddrinfo(result);
+	}
+
+	handle = (intptr_t)socket(reinterpret_cast<const sockaddr*>(storage)->sa_family, SOCK_STREAM, 0);
+	if (handle == INVALID_HANDLE)
+	{
+		cerr << "Could not create socket" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+void StreamSocket::SetNonBlocking()
+{
+#ifdef _WIN32
+	u_long nonBlocking = 1;
+	ioctlsocket((NativeSocket)handle, FIONBIO, &nonBlocking);
+#else
+	fcntl((NativeSocket)handle, F_SETFL, fcntl((NativeSocket)handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Usings
+using namespace std;
+
+/**
+ * @brief A non-blocking stream socket, either TCP or a Unix domain socket, listening for or connected to a peer.
+ *
+ * Addresses are either "unix:<path>" for a Unix domain socket, or "<host>:<port>" for TCP, the host being optional
+ * when listening on all interfaces.
+ */
+class StreamSocket
+{
+public:
+	/**
+	 * @brief Constructor, without opening a socket.
+	 */
+	StreamSocket() = default;
+
+	/**
+	 * @brief Destructor, closing the socket.
+	 */
+	~StreamSocket();
+
+	/**
+	 * @brief Move constructor, taking over the socket.
+	 * @param other The StreamSocket to take the socket from, which is left closed.
+	 */
+	StreamSocket(StreamSocket&& other) noexcept;
+
+	/**
+	 * @brief Move assignment, closing our socket and taking over the other's.
+	 * @param other The StreamSocket to take the socket from, which is left closed.
+	 * @return Returns this StreamSocket.
+	 */
+	StreamSocket& operator=(StreamSocket&& other) noexcept;
+
+	StreamSocket(const StreamSocket&) = delete;
+	StreamSocket& operator=(const StreamSocket&) = delete;
+
+	/**
+	 * @brief Opens a socket listening for connections.
+	 * @param address Address to listen on, port 0 letting the OS pick one.
+	 * @return Returns false if the socket couldn't be opened or bound.
+	 */
+	bool Listen(const string address);
+
+	/**
+	 * @brief Opens a socket connected to a listening one, waiting until connected.
+	 * @param address Address to connect to.
+	 * @return Returns false if the connection couldn't be made.
+	 */
+	bool Connect(const string address);
+
+	/**
+	 * @brief Accepts a pending connection on a listening socket.
+	 * @param client The StreamSocket to hand the connection to.
+	 * @return Returns false if no connection was pending.
+	 */
+	bool Accept(StreamSocket& client);
+
+	/**
+	 * @brief Closes the socket, removing the file of a listening Unix domain socket.
+	 */
+	void Close();
+
+	/**
+	 * @brief Whether the socket is open.
+	 * @return Returns true if the socket is listening or connected.
+	 */
+	bool IsOpen() const { return handle != INVALID_HANDLE; }
+
+	/**
+	 * @brief Gets the OS handle of the socket, to wait for it on.
+	 * @return Returns the file descriptor, or the SOCKET on Windows.
+	 */
+	intptr_t GetHandle() const { return handle; }
+
+	/**
+	 * @brief Gets the TCP port the socket is bound to.
+	 * @return Returns the port, or 0 for Unix domain sockets.
+	 */
+	uint16_t GetPort() const;
+
+	/**
+	 * @brief Sends as many bytes as fit in the socket's buffer, without waiting.
+	 * @param data The bytes to send.
+	 * @param size Number of bytes to send.
+	 * @return Returns the number of bytes sent, 0 if the buffer is full, or -1 if the connection was lost.
+	 */
+	int Send(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Receives whatever bytes arrived, without waiting.
+	 * @param data Where to store the received bytes.
+	 * @param maxSize Size of data.
+	 * @return Returns the number of bytes received, 0 if none arrived, or -1 if the connection was closed or lost.
+	 */
+	int Receive(uint8_t* data, size_t maxSize);
+
+	static const intptr_t INVALID_HANDLE = -1;		///< Handle of a socket which isn't open.
+
+private:
+	/**
+	 * @brief Creates a socket for an address and fills in the address to bind or connect to.
+	 * @param address The address, as passed to Listen() or Connect().
+	 * @param listening Whether to listen on the address, allowing the host to be left out.
+	 * @param storage Where to write the socket address, at least as large as a sockaddr_storage.
+	 * @param length Where to write the size of the socket address.
+	 * @return Returns false if the address couldn't be parsed or resolved, or the socket couldn't be created.
+	 */
+	bool Create(const string address, bool listening, void* storage, int& length);
+
+	/**
+	 * @brief Makes the socket not wait on any operation.
+	 */
+	void SetNonBlocking();
+
+	intptr_t handle = INVALID_HANDLE;	///< The file descriptor, or the SOCKET on Windows.
+	string unixPath;					///< Path of the Unix domain socket file to remove when closing, if listening on one.
+};
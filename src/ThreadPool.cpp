@@ -0,0 +1,174 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "ThreadPool.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ThreadPool::ThreadPool(uint32_t numThreads, bool pinToCores)
+{
+	if (numThreads == 0)
+		numThreads = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+
+	// Created before any thread starts, as thieves look at every worker
+	for (uint32_t i = 0; i < numThreads; i++)
+		workers.push_back(make_unique<Worker>());
+
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		workers[i]->handle = thread([this, i, pinToCores]()
+		{
+			if (pinToCores)
+				PinToCore(i);
+
+			WorkerLoop(i);
+		});
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+
+	wake.notify_all();
+
+	for (unique_ptr<Worker>& worker : workers)
+		worker->handle.join();
+}
+
+void ThreadPool::Run(size_t numTasks, const function<void(size_t task, uint32_t worker)>& task)
+{
+	if (numTasks == 0)
+		return;
+
+	// Every worker is waiting for the next batch, so their ranges can be handed out without anyone stealing yet
+	const size_t numWorkers = workers.size();
+	for (size_t i = 0; i < numWorkers; i++)
+	{
+		lock_guard<mutex> guard(workers[i]->lock);
+		workers[i]->begin = numTasks * i / numWorkers;
+		workers[i]->end = numTasks * (i + 1) / numWorkers;
+	}
+
+	unique_lock<mutex> guard(lock);
+	this->task = &task;
+	numBusy = (uint32_t)numWorkers;
+	batch++;
+	wake.notify_all();
+
+	done.wait(guard, [this]() { return numBusy == 0; });
+	this->task = nullptr;
+}
+
+uint64_t ThreadPool::GetNumSteals() const
+{
+	uint64_t numSteals = 0;
+	for (const unique_ptr<Worker>& worker : workers)
+		numSteals += worker->numSteals;
+
+	return numSteals;
+}
+
+void ThreadPool::WorkerLoop(uint32_t index)
+{
+	uint64_t lastBatch = 0;
+	while (true)
+	{
+		const function<void(size_t, uint32_t)>* batchTask;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [this, lastBatch]() { return stopping || batch != lastBatch; });
+			if (stopping)
+				return;
+
+			lastBatch = batch;
+			batchTask = task;
+		}
+
+		// Tasks only move between ranges while their thief is busy, so once every range is empty the batch is done
+		size_t next;
+		while (Take(index, next) || Steal(index, next))
+			(*batchTask)(next, index);
+
+		lock_guard<mutex> guard(lock);
+		if (--numBusy == 0)
+			done.notify_one();
+	}
+}
+
+bool ThreadPool::Take(uint32_t index, size_t& task)
+{
+	Worker& worker = *workers[index];
+	lock_guard<mutex> guard(worker.lock);
+	if (worker.begin == worker.end)
+		return false;
+
+	task = worker.begin++;
+	return true;
+}
+
+bool ThreadPool::Steal(uint32_t index, size_t& task)
+{
+	const uint32_t numWorkers = (uint32_t)workers.size();
+	for (uint32_t i = 1; i < numWorkers; i++)
+	{
+		Worker& victim = *workers[(index + i) % numWorkers];
+		size_t begin;
+		size_t end;
+		{
+			lock_guard<mutex> guard(victim.lock);
+			if (victim.begin == victim.end)
+				continue;
+
+			// The back half, the victim carrying on with the tasks right in front of it
+			end = victim.end;
+			begin = end - (end - victim.begin + 1) / 2;
+			victim.end = begin;
+		}
+
+		// Only one lock is held at a time, so workers stealing from each other can't deadlock
+		Worker& worker = *workers[index];
+		lock_guard<mutex> guard(worker.lock);
+		task = begin;
+		worker.begin = begin + 1;
+		worker.end = end;
+		worker.numSteals++;
+		return true;
+	}
+
+	return false;
+}
+
+void ThreadPool::PinToCore(uint32_t core)
+{
+#ifdef _WIN32
+	// Windows numbers cores per processor group, of at most 64 each
+	core %= GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+	WORD group = 0;
+	while (core >= GetActiveProcessorCount(group))
+		core -= GetActiveProcessorCount(group++);
+
+	GROUP_AFFINITY affinity = {};
+	affinity.Group = group;
+	affinity.Mask = (KAFFINITY)1 << core;
+	SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr);
+#elif defined(__linux__)
+	const uint32_t numCores = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+	cpu_set_t cores;
+	CPU_ZERO(&cores);
+	CPU_SET(core % numCores, &cores);
+	pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores);
+#else
+	// Other platforms only take hints, if anything, which the scheduler does fine without
+	(void)core;
+#endif
+}
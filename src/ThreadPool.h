@@ -0,0 +1,112 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Runs batches of independent tasks on a fixed set of worker threads, one per core by default.
+ *
+ * Every batch is split evenly over the workers up front, each taking tasks from the front of its own range. Workers
+ * running out steal the back half of another worker's range, so batches whose tasks take very different amounts of
+ * time (such as ROMs idling versus drawing every frame) still keep every core busy until the end. Tasks are only
+ * told their index and the worker running them, which they can use to pick per-worker scratch space, so nothing is
+ * shared between tasks unless the caller shares it.
+ */
+class ThreadPool
+{
+public:
+	/**
+	 * @brief Constructor, starting the worker threads.
+	 * @param numThreads Number of worker threads, 0 for one per hardware thread.
+	 * @param pinToCores Whether to pin every worker to its own core, keeping its caches warm.
+	 */
+	ThreadPool(uint32_t numThreads = 0, bool pinToCores = true);
+
+	/**
+	 * @brief Destructor, stopping the worker threads.
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Runs a batch of tasks, returning once all of them finished.
+	 * @param numTasks Number of tasks in the batch.
+	 * @param task Called once for every index in [0..numTasks), with the index of the worker running it.
+	 */
+	void Run(size_t numTasks, const function<void(size_t task, uint32_t worker)>& task);
+
+	/**
+	 * @brief Gets the number of worker threads.
+	 * @return Returns the number of workers.
+	 */
+	uint32_t GetNumThreads() const { return (uint32_t)workers.size(); }
+
+	/**
+	 * @brief Gets the number of times a worker ran out of tasks and stole from another, over all batches.
+	 * @return Returns the number of steals.
+	 */
+	uint64_t GetNumSteals() const;
+
+private:
+	/**
+	 * @brief A worker thread and the range of tasks it has yet to run, kept on its own cache line.
+	 */
+	struct alignas(64) Worker
+	{
+		mutex lock;							///< Guards begin and end, which thieves modify too.
+		size_t begin = 0;					///< First task not taken yet.
+		size_t end = 0;						///< One past the last task not taken yet.
+		uint64_t numSteals = 0;				///< Number of times this worker stole from another.
+		thread handle;						///< The worker's thread.
+	};
+
+	/**
+	 * @brief Loop of a worker thread, running every batch until the ThreadPool is destroyed.
+	 * @param index Index of the worker.
+	 */
+	void WorkerLoop(uint32_t index);
+
+	/**
+	 * @brief Takes the next task from a worker's own range.
+	 * @param index Index of the worker.
+	 * @param task Set to the task taken.
+	 * @return Returns false if its range is empty.
+	 */
+	bool Take(uint32_t index, size_t& task);
+
+	/**
+	 * @brief Steals the back half of another worker's range, starting with the worker after this one.
+	 * @param index Index of the worker stealing.
+	 * @param task Set to the first stolen task, the others becoming the worker's own range.
+	 * @return Returns false if all other ranges are empty.
+	 */
+	bool Steal(uint32_t index, size_t& task);
+
+	/**
+	 * @brief Pins the calling thread to a single core.
+	 * @param core Index of the core, wrapping around the number of hardware threads.
+	 */
+	static void PinToCore(uint32_t core);
+
+	vector<unique_ptr<Worker>> workers;		///< The worker threads.
+	mutex lock;								///< Guards the fields below.
+	condition_variable wake;				///< Signalled when a batch starts or the ThreadPool is destroyed.
+	condition_variable done;				///< Signalled when the last worker ran out of tasks.
+	const function<void(size_t, uint32_t)>* task = nullptr;	///< The current batch's task.
+	uint64_t batch = 0;						///< Number of batches started, telling workers a new one started.
+	uint32_t numBusy = 0;					///< Number of workers still running the current batch.
+	bool stopping = false;					///< Whether the workers should exit.
+};
@@ -0,0 +1,20 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "TripleBuffer.h"
+
+void TripleBuffer::Present(const Framebuffer& framebuffer)
+{
+	buffers[back] = framebuffer;
+
+	// Releases the copy above to whoever acquires it, and takes over whichever buffer was in the middle
+	back = middle.exchange(back | FRESH, memory_order_acq_rel) & INDEX_MASK;
+}
+
+const Framebuffer* TripleBuffer::Acquire()
+{
+	if ((middle.load(memory_order_relaxed) & FRESH) == 0)
+		return nullptr;
+
+	front = middle.exchange(front, memory_order_acq_rel) & INDEX_MASK;
+	return &buffers[front];
+}
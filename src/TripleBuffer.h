@@ -0,0 +1,47 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <atomic>
+#include <cstdint>
+#include "DisplaySink.h"
+#include "Framebuffer.h"
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Hands the most recent Framebuffer from the emulation thread to the render thread, without either ever waiting.
+ *
+ * Three Framebuffers rotate between the two threads: the emulation thread presents into the back one, the render thread
+ * reads the front one, and the middle one holds the most recently completed frame. Presenting swaps the back and middle
+ * ones, acquiring swaps the front and middle ones, each a single atomic exchange. Frames presented faster than they're
+ * rendered are simply replaced, so a stalled swapchain never holds up emulation, and emulation stalling only means
+ * the same frame is rendered again.
+ */
+class TripleBuffer : public DisplaySink
+{
+public:
+	/**
+	 * @brief Copies a Framebuffer into the back buffer and makes it the most recent frame. Only to be called by the
+	 * thread producing frames.
+	 * @param framebuffer The Framebuffer to hand over.
+	 */
+	void Present(const Framebuffer& framebuffer) override;
+
+	/**
+	 * @brief Takes the most recent frame, if one was presented since the previous call. Only to be called by the thread
+	 * consuming frames.
+	 * @return Returns the frame, which stays valid until the next call, or nullptr if no frame was presented since.
+	 */
+	const Framebuffer* Acquire();
+
+private:
+	static const uint8_t INDEX_MASK = 0x3;			///< Bits of middle holding the index of the buffer.
+	static const uint8_t FRESH = 0x4;				///< Bit of middle set when it holds a frame not acquired yet.
+
+	alignas(64) Framebuffer buffers[3];				///< The three buffers, rotating roles.
+	alignas(64) atomic<uint8_t> middle = 1;			///< Index of the middle buffer, plus FRESH.
+	alignas(64) uint8_t back = 2;					///< Index of the back buffer, owned by the producing thread.
+	alignas(64) uint8_t front = 0;					///< Index of the front buffer, owned by the consuming thread.
+};
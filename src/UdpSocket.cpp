@@ -0,0 +1,166 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "UdpSocket.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mstcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+UdpSocket::~UdpSocket()
+{
+	Close();
+}
+
+bool UdpSocket::Open(uint16_t port)
+{
+	Close();
+
+#ifdef _WIN32
+	WSADATA data;
+	if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+	{
+		cerr << "Could not initialize sockets" << endl;
+		return false;
+	}
+
+	SOCKET socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (socketHandle == INVALID_SOCKET)
+	{
+		WSACleanup();
+		cerr << "Could not create socket" << endl;
+		return false;
+	}
+
+	handle = (uintptr_t)socketHandle;
+
+	u_long nonBlocking = 1;
+	ioctlsocket(socketHandle, FIONBIO, &nonBlocking);
+
+	// Don't let an unreachable peer fail every following receive, it may just not have started yet
+	BOOL reportReset = FALSE;
+	DWORD bytesReturned = 0;
+	WSAIoctl(socketHandle, SIO_UDP_CONNRESET, &reportReset, sizeof(reportReset), nullptr, 0, &bytesReturned, nullptr, nullptr);
+#else
+	handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle < 0)
+	{
+		cerr << "Could not create socket" << endl;
+		return false;
+	}
+
+	fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+
+	if (::bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		cerr << "Could not bind to port " << port << endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void UdpSocket::Close()
+{
+#ifdef _WIN32
+	if (handle != ~(uintptr_t)0)
+	{
+		closesocket((SOCKET)handle);
+		WSACleanup();
+	}
+
+	handle = ~(uintptr_t)0;
+#else
+	if (handle >= 0)
+		close(handle);
+
+	handle = -1;
+#endif
+
+	peerAddress = 0;
+	peerPort = 0;
+}
+
+bool UdpSocket::SetPeer(const string host, uint16_t port)
+{
+	addrinfo hints = {};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	addrinfo* result = nullptr;
+	if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || result == nullptr)
+	{
+		cerr << "Could not resolve '" << host << "'" << endl;
+		return false;
+	}
+
+	peerAddress = reinterpret_cast<const sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+	peerPort = htons(port);
+	freeaddrinfo(result);
+
+	return true;
+}
+
+uint16_t UdpSocket::GetPort() const
+{
+	sockaddr_in address = {};
+	socklen_t length = sizeof(address);
+	if (getsockname(handle, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+		return 0;
+
+	return ntohs(address.sin_port);
+}
+
+bool UdpSocket::Send(const uint8_t* data, size_t size)
+{
+	if (!HasPeer())
+		return false;
+
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = peerAddress;
+	address.sin_port = peerPort;
+
+	return sendto(handle, reinterpret_cast<const char*>(data), (int)size, 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == (int)size;
+}
+
+size_t UdpSocket::Receive(uint8_t* data, size_t maxSize)
+{
+	while (true)
+	{
+		sockaddr_in address = {};
+		socklen_t length = sizeof(address);
+		const int size = (int)recvfrom(handle, reinterpret_cast<char*>(data), (int)maxSize, 0, reinterpret_cast<sockaddr*>(&address), &length);
+		if (size <= 0)
+			return 0;
+
+		// The first one to reach us becomes the peer
+		if (!HasPeer())
+		{
+			peerAddress = address.sin_addr.s_addr;
+			peerPort = address.sin_port;
+		}
+
+		if (address.sin_addr.s_addr == peerAddress && address.sin_port == peerPort)
+			return (size_t)size;
+	}
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Usings
+using namespace std;
+
+/**
+ * @brief A non-blocking IPv4 UDP socket exchanging datagrams with a single peer.
+ *
+ * The peer is either set up front, or adopted from the first datagram received, which is how a host learns who joined.
+ * From then on, datagrams from anyone else are ignored.
+ */
+class UdpSocket
+{
+public:
+	/**
+	 * @brief Destructor, closing the socket.
+	 */
+	~UdpSocket();
+
+	/**
+	 * @brief Opens the socket, bound to a port on all interfaces.
+	 * @param port Port to bind to, or 0 to let the OS pick one.
+	 * @return Returns false if the socket couldn't be opened or bound.
+	 */
+	bool Open(uint16_t port);
+
+	/**
+	 * @brief Closes the socket, forgetting the peer.
+	 */
+	void Close();
+
+	/**
+	 * @brief Sets the peer datagrams are sent to and received from.
+	 * @param host Name or address of the peer.
+	 * @param port Port the peer is bound to.
+	 * @return Returns false if the host couldn't be resolved.
+	 */
+	bool SetPeer(const string host, uint16_t port);
+
+	/**
+	 * @brief Whether a peer was set, or adopted from a received datagram.
+	 * @return Returns true if datagrams can be sent.
+	 */
+	bool HasPeer() const { return peerPort != 0; }
+
+	/**
+	 * @brief Gets the port the socket is bound to.
+	 * @return Returns the port, or 0 if the socket isn't open.
+	 */
+	uint16_t GetPort() const;
+
+	/**
+	 * @brief Sends a datagram to the peer, without waiting.
+	 * @param data The bytes to send.
+	 * @param size Number of bytes to send.
+	 * @return Returns false if there's no peer or the datagram couldn't be sent.
+	 */
+	bool Send(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Receives a datagram from the peer, without waiting.
+	 * @param data Where to store the received bytes.
+	 * @param maxSize Size of data, longer datagrams being truncated.
+	 * @return Returns the number of bytes received, 0 if no datagram was pending.
+	 */
+	size_t Receive(uint8_t* data, size_t maxSize);
+
+private:
+	uint32_t peerAddress = 0;				///< IPv4 address of the peer, in network byte order.
+	uint16_t peerPort = 0;					///< Port of the peer in network byte order, 0 when there's no peer.
+#ifdef _WIN32
+	uintptr_t handle = ~(uintptr_t)0;		///< The socket, INVALID_SOCKET when not open.
+#else
+	int handle = -1;						///< Descriptor of the socket, -1 when not open.
+#endif
+};
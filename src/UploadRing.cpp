@@ -0,0 +1,105 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "UploadRing.h"
+#include "SDL3/SDL_gpu.h"
+
+bool UploadRing::Init(SDL_GPUDevice* device, Uint32 slotSize, Uint32 numSlots)
+{
+	this->device = device;
+
+	SDL_GPUTransferBufferCreateInfo transferBufferCreateInfo{};
+	transferBufferCreateInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+	transferBufferCreateInfo.size = slotSize;
+
+	slots.resize(numSlots);
+	for (Slot& slot : slots)
+	{
+		slot.transferBuffer = SDL_CreateGPUTransferBuffer(device, &transferBufferCreateInfo);
+		if (slot.transferBuffer == nullptr)
+		{
+			SDL_Log("Failed to create transfer buffer: %s", SDL_GetError());
+			return false;
+		}
+
+		numAllocations++;
+	}
+
+	return true;
+}
+
+void UploadRing::Shutdown()
+{
+	for (Slot& slot : slots)
+	{
+		if (slot.fence != nullptr)
+		{
+			SDL_WaitForGPUFences(device, true, &slot.fence, 1);
+			SDL_ReleaseGPUFence(device, slot.fence);
+		}
+
+		if (slot.transferBuffer != nullptr)
+			SDL_ReleaseGPUTransferBuffer(device, slot.transferBuffer);
+	}
+
+	slots.clear();
+}
+
+void* UploadRing::Map()
+{
+	Slot& slot = slots[current];
+
+	// Only stalls when the GPU is more frames behind than there are slots
+	if (slot.fence != nullptr)
+	{
+		if (!SDL_QueryGPUFence(device, slot.fence))
+		{
+			numStalls++;
+			SDL_WaitForGPUFences(device, true, &slot.fence, 1);
+		}
+
+		SDL_ReleaseGPUFence(device, slot.fence);
+		slot.fence = nullptr;
+	}
+
+	// Not cycling, as the fence already tells us the GPU is done with it
+	void* data = SDL_MapGPUTransferBuffer(device, slot.transferBuffer, false);
+	mapped = data != nullptr;
+	return data;
+}
+
+void UploadRing::Upload(SDL_GPUCopyPass* copyPass, Uint32 offset, const SDL_GPUBufferRegion& destination)
+{
+	if (mapped)
+	{
+		SDL_UnmapGPUTransferBuffer(device, slots[current].transferBuffer);
+		mapped = false;
+	}
+
+	SDL_GPUTransferBufferLocation source{};
+	source.transfer_buffer = slots[current].transferBuffer;
+	source.offset = offset;
+
+	SDL_UploadToGPUBuffer(copyPass, &source, &destination, false);
+}
+
+bool UploadRing::Submit(SDL_GPUCommandBuffer* commandBuffer)
+{
+	if (mapped)
+	{
+		SDL_UnmapGPUTransferBuffer(device, slots[current].transferBuffer);
+		mapped = false;
+	}
+
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (fence == nullptr)
+	{
+		SDL_Log("Failed to submit command buffer: %s", SDL_GetError());
+		return false;
+	}
+
+	slots[current].fence = fence;
+	current = (current + 1) % slots.size();
+	numFrames++;
+
+	return true;
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <vector>
+#include "SDL3/SDL.h"
+
+// Forward declarations
+struct SDL_GPUDevice;
+struct SDL_GPUTransferBuffer;
+struct SDL_GPUCommandBuffer;
+struct SDL_GPUCopyPass;
+struct SDL_GPUFence;
+struct SDL_GPUBufferRegion;
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Transfer buffers uploads to the GPU are staged in, created once and reused frame after frame.
+ *
+ * Every frame takes the next slot of the ring, writes its uploads into it, and records them into the frame's own
+ * command buffer ahead of any render pass. Submit() then hands in the command buffer along with a fence, which the slot
+ * waits on the next time around, so the CPU never writes into a transfer buffer the GPU may still be reading from. With
+ * as many slots as frames in flight that wait should be over before it starts; when it isn't, it's counted as a stall.
+ */
+class UploadRing
+{
+public:
+	/**
+	 * @brief Creates every transfer buffer of the ring.
+	 * @param device SDL_GPUDevice uploading from the ring.
+	 * @param slotSize Size of every slot in bytes, the most a single frame uploads.
+	 * @param numSlots Number of slots, typically the number of frames in flight.
+	 * @return Returns whether all transfer buffers were created.
+	 */
+	bool Init(SDL_GPUDevice* device, Uint32 slotSize, Uint32 numSlots = FRAMES_IN_FLIGHT);
+
+	/**
+	 * @brief Waits for the GPU to finish with every slot, then releases them.
+	 */
+	void Shutdown();
+
+	/**
+	 * @brief Maps the current slot, first waiting for the GPU to finish reading it if it's still in flight.
+	 * @return Returns slotSize bytes to write the frame's uploads into, or nullptr if mapping failed.
+	 */
+	void* Map();
+
+	/**
+	 * @brief Unmaps the current slot, then records uploading part of it to a buffer.
+	 * @param copyPass Copy pass of the frame's command buffer, begun before any render pass.
+	 * @param offset Offset of the data within the slot, in bytes.
+	 * @param destination Buffer region to upload to.
+	 */
+	void Upload(SDL_GPUCopyPass* copyPass, Uint32 offset, const SDL_GPUBufferRegion& destination);
+
+	/**
+	 * @brief Submits the frame's command buffer, keeping a fence so the current slot isn't written to again before the
+	 * GPU is done with it, and moves on to the next slot.
+	 * @param commandBuffer The command buffer the uploads were recorded into.
+	 * @return Returns whether submitting succeeded.
+	 */
+	bool Submit(SDL_GPUCommandBuffer* commandBuffer);
+
+	/**
+	 * @brief Gets the number of transfer buffers created, which stays at the number of slots after Init().
+	 * @return Returns the number of allocations.
+	 */
+	uint64_t GetNumAllocations() const { return numAllocations; }
+
+	/**
+	 * @brief Gets the number of times Map() had to wait for the GPU, meaning more frames were in flight than slots.
+	 * @return Returns the number of stalls.
+	 */
+	uint64_t GetNumStalls() const { return numStalls; }
+
+	/**
+	 * @brief Gets the number of frames uploaded through the ring.
+	 * @return Returns the number of frames.
+	 */
+	uint64_t GetNumFrames() const { return numFrames; }
+
+	static const Uint32 FRAMES_IN_FLIGHT = 3;			///< Default number of slots, matching the frames SDL allows in flight.
+
+private:
+	/**
+	 * @brief A single transfer buffer of the ring.
+	 */
+	struct Slot
+	{
+		SDL_GPUTransferBuffer* transferBuffer = nullptr;	///< Staging memory of this slot.
+		SDL_GPUFence* fence = nullptr;						///< Signaled once the GPU is done with this slot, nullptr if it isn't in flight.
+	};
+
+	SDL_GPUDevice* device = nullptr;					///< SDL_GPUDevice uploading from the ring.
+	vector<Slot> slots;									///< Every slot of the ring.
+	Uint32 current = 0;									///< Index of the slot the current frame writes into.
+	bool mapped = false;								///< Whether the current slot is mapped.
+	uint64_t numAllocations = 0;						///< Number of transfer buffers created.
+	uint64_t numStalls = 0;								///< Number of times Map() waited for the GPU.
+	uint64_t numFrames = 0;								///< Number of frames uploaded.
+};
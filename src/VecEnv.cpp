@@ -0,0 +1,134 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "VecEnv.h"
+#include <cstring>
+
+VecEnv::VecEnv(const string& romPath, uint32_t numEnvs, uint32_t numThreads) :
+	romPath(romPath),
+	numEnvs(numEnvs),
+	threadPool(numThreads),
+	episodes(numEnvs, 0),
+	episodeFrames(numEnvs, 0),
+	ownObservations((size_t)numEnvs * Framebuffer::HEIGHT, 0),
+	rewards(numEnvs, 0.0f),
+	dones(numEnvs, 0)
+{
+	observations = ownObservations.data();
+}
+
+bool VecEnv::Init(ExecutionMode executionMode, uint32_t instructionsPerSecond)
+{
+	// No display, audio, input or clock, every environment is driven through RunCycles()
+	for (uint32_t env = 0; env < numEnvs; env++)
+	{
+		emulators.push_back(make_unique<Emulator>(romPath, nullptr, nullptr, nullptr, nullptr));
+		Emulator& emulator = *emulators.back();
+		emulator.SetVerbose(env == 0);
+		if (!emulator.Init() || !emulator.SetExecutionMode(executionMode))
+			return false;
+
+		emulator.SetInstructionsPerSecond(instructionsPerSecond);
+	}
+
+	if (numEnvs > 0)
+	{
+		bootState = emulators[0]->GetState();
+		clockFrequency = emulators[0]->GetClockFrequency();
+	}
+
+	Reset();
+	return true;
+}
+
+void VecEnv::Reset(const uint8_t* mask)
+{
+	ForEachEnv([this, mask](uint32_t env)
+	{
+		if (mask != nullptr && mask[env] == 0)
+			return;
+
+		// Only memory the previous episode wrote to is compared again, so this is little more than a memcpy
+		Emulator& emulator = *emulators[env];
+		emulator.Restore(bootState);
+		emulator.SetSeed(seed + env + (uint32_t)(episodes[env] * numEnvs));
+
+		episodes[env]++;
+		episodeFrames[env] = 0;
+		rewards[env] = 0.0f;
+		dones[env] = 0;
+		Observe(env);
+	});
+}
+
+void VecEnv::Step(const uint16_t* actions, uint32_t frameskip)
+{
+	for (uint32_t env = 0; env < numEnvs; env++)
+		numFrames += dones[env] == 0 ? frameskip : 0;
+
+	ForEachEnv([this, actions, frameskip](uint32_t env)
+	{
+		StepEnv(env, actions[env], frameskip);
+	});
+}
+
+void VecEnv::SetObservationBuffer(uint64_t* buffer)
+{
+	observations = buffer != nullptr ? buffer : ownObservations.data();
+
+	for (uint32_t env = 0; env < numEnvs && env < emulators.size(); env++)
+		Observe(env);
+}
+
+void VecEnv::StepEnv(uint32_t env, uint16_t keys, uint32_t frameskip)
+{
+	rewards[env] = 0.0f;
+
+	// Environments which ended their episode wait for a Reset(), keeping their last observation
+	if (dones[env] != 0)
+		return;
+
+	Emulator& emulator = *emulators[env];
+	emulator.SetKeys(keys);
+
+	for (uint32_t i = 0; i < frameskip; i++)
+	{
+		// Frames alternate between rounding the opcodes per frame down and up, so the clock frequency is reached exactly
+		const uint64_t frame = episodeFrames[env]++;
+		const uint64_t numCycles = (frame + 1) * clockFrequency / FRAME_FREQUENCY - frame * clockFrequency / FRAME_FREQUENCY;
+		emulator.RunCycles((uint32_t)numCycles);
+
+		const MachineState& state = emulator.GetState();
+		if (rewardHook)
+			rewards[env] += rewardHook(env, state);
+
+		if ((doneHook && doneHook(env, state)) || (maxEpisodeFrames > 0 && episodeFrames[env] >= maxEpisodeFrames))
+		{
+			dones[env] = 1;
+			break;
+		}
+	}
+
+	Observe(env);
+}
+
+void VecEnv::Observe(uint32_t env)
+{
+	const Framebuffer& framebuffer = emulators[env]->GetFramebuffer();
+	uint64_t* observation = &observations[(size_t)env * Framebuffer::HEIGHT];
+	for (int y = 0; y < Framebuffer::HEIGHT; y++)
+		observation[y] = framebuffer.GetRow(y);
+}
+
+void VecEnv::ForEachEnv(const function<void(uint32_t env)>& function)
+{
+	// Chunks of consecutive environments, so neighbouring rewards and observations are written by the same worker
+	const size_t numTasks = (numEnvs + ENVS_PER_TASK - 1) / ENVS_PER_TASK;
+	threadPool.Run(numTasks, [this, &function](size_t task, uint32_t worker)
+	{
+		(void)worker;
+		const uint32_t begin = (uint32_t)task * ENVS_PER_TASK;
+		const uint32_t end = begin + ENVS_PER_TASK < numEnvs ? begin + ENVS_PER_TASK : numEnvs;
+		for (uint32_t env = begin; env < end; env++)
+			function(env);
+	});
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "Emulator.h"
+#include "Framebuffer.h"
+#include "MachineState.h"
+#include "ThreadPool.h"
+
+// Usings
+using namespace std;
+
+/**
+ * @brief Reads a reward from an environment's MachineState, such as the change of a score kept in memory.
+ * @param env Index of the environment, for hooks keeping state of their own per environment.
+ * @param state The environment's MachineState after a frame.
+ * @return Returns the reward for that frame.
+ */
+using RewardHook = function<float(uint32_t env, const MachineState& state)>;
+
+/**
+ * @brief Reads from an environment's MachineState whether its episode ended, such as when no lives are left.
+ * @param env Index of the environment.
+ * @param state The environment's MachineState after a frame.
+ * @return Returns true if the episode ended.
+ */
+using DoneHook = function<bool(uint32_t env, const MachineState& state)>;
+
+/**
+ * @brief A batch of environments running the same ROM, for reinforcement learning.
+ *
+ * Every environment is a headless Emulator, without display, audio, input or clock, so nothing but memory is involved.
+ * Actions are the keys held by each environment during a Step(), which emulates a number of frames on every environment
+ * in parallel on a ThreadPool, each worker stepping a contiguous chunk of environments.
+ *
+ * Observations are written to a single buffer of packed bitplanes, Framebuffer::HEIGHT rows of 64 bits per environment,
+ * the leftmost pixel being the most significant bit, which stays at the same address for the lifetime of the VecEnv.
+ * A training loop can wrap it as a tensor once and read it after every Step() without copying, or have the VecEnv write
+ * straight into memory of its own, such as pinned memory for uploads to a GPU.
+ *
+ * Rewards and the end of episodes are up to the ROM, so they're read by hooks looking at the MachineState of an
+ * environment after every frame. Hooks are called from the worker threads, but never for the same environment at once.
+ */
+class VecEnv
+{
+public:
+	/**
+	 * @brief Constructor
+	 * @param romPath Path to the ROM every environment runs.
+	 * @param numEnvs Number of environments.
+	 * @param numThreads Number of worker threads stepping the environments, 0 for one per hardware thread.
+	 */
+	VecEnv(const string& romPath, uint32_t numEnvs, uint32_t numThreads = 0);
+
+	/**
+	 * @brief Loads the ROM into every environment, then resets all of them.
+	 * @param executionMode How the environments execute opcodes.
+	 * @param instructionsPerSecond Rate of the emulated clock, which determines the number of opcodes per frame.
+	 * @return Returns false if the ROM couldn't be loaded, or the ExecutionMode isn't supported.
+	 */
+	bool Init(ExecutionMode executionMode = ExecutionMode::CachedInterpreter, uint32_t instructionsPerSecond = Emulator::OPCODES_FREQUENCY);
+
+	/**
+	 * @brief Starts a new episode on environments, restoring the MachineState right after loading the ROM with a seed of
+	 * its own, and writing their first observation.
+	 * @param mask One byte per environment, nonzero for the environments to reset, or nullptr to reset all of them. The
+	 * dones returned by GetDones() can be passed as is.
+	 */
+	void Reset(const uint8_t* mask = nullptr);
+
+	/**
+	 * @brief Emulates frames on every environment, holding the keys of its action.
+	 * @param actions One bitset of keys per environment, ranging from [0xF..0x0].
+	 * @param frameskip Number of frames to emulate, rewards being summed over them.
+	 */
+	void Step(const uint16_t* actions, uint32_t frameskip = 1);
+
+	/**
+	 * @brief Sets the hook rewards are read by after every frame, 0 being rewarded if there's none.
+	 * @param hook The RewardHook, or nullptr.
+	 */
+	void SetRewardHook(RewardHook hook) { rewardHook = move(hook); }
+
+	/**
+	 * @brief Sets the hook telling whether an episode ended after every frame, episodes only ending after
+	 * SetMaxEpisodeFrames() frames if there's none.
+	 * @param hook The DoneHook, or nullptr.
+	 */
+	void SetDoneHook(DoneHook hook) { doneHook = move(hook); }
+
+	/**
+	 * @brief Sets the number of frames after which episodes end regardless of the DoneHook.
+	 * @param maxEpisodeFrames Number of frames, 0 for episodes to only end by the DoneHook.
+	 */
+	void SetMaxEpisodeFrames(uint32_t maxEpisodeFrames) { this->maxEpisodeFrames = maxEpisodeFrames; }
+
+	/**
+	 * @brief Sets the seed of the first episode of the first environment, all other episodes counting up from it.
+	 * @param seed The seed, taking effect on the next Reset().
+	 */
+	void SetSeed(uint32_t seed) { this->seed = seed; }
+
+	/**
+	 * @brief Writes observations into a buffer of the caller from now on, instead of the VecEnv's own.
+	 * @param buffer OBSERVATION_SIZE bytes per environment, or nullptr to go back to the VecEnv's own buffer.
+	 */
+	void SetObservationBuffer(uint64_t* buffer);
+
+	/**
+	 * @brief Gets the observation of every environment, as of the latest Reset() or Step().
+	 * @return Returns Framebuffer::HEIGHT packed rows per environment.
+	 */
+	const uint64_t* GetObservations() const { return observations; }
+
+	/**
+	 * @brief Gets the reward of every environment, summed over the frames of the latest Step().
+	 * @return Returns one reward per environment.
+	 */
+	const float* GetRewards() const { return rewards.data(); }
+
+	/**
+	 * @brief Gets which environments ended their episode, which stays set until they're Reset().
+	 * @return Returns one byte per environment, 1 if its episode ended.
+	 */
+	const uint8_t* GetDones() const { return dones.data(); }
+
+	/**
+	 * @brief Gets the MachineState of an environment, such as to read more from its memory than the observation.
+	 * @param env Index of the environment.
+	 * @return Returns the environment's MachineState.
+	 */
+	const MachineState& GetState(uint32_t env) const { return emulators[env]->GetState(); }
+
+	/**
+	 * @brief Gets the number of environments.
+	 * @return Returns the number of environments.
+	 */
+	uint32_t GetNumEnvs() const { return numEnvs; }
+
+	/**
+	 * @brief Gets the number of frames emulated over all environments since Init().
+	 * @return Returns the number of frames.
+	 */
+	uint64_t GetNumFrames() const { return numFrames; }
+
+	static const uint32_t OBSERVATION_SIZE = Framebuffer::HEIGHT * sizeof(uint64_t);	///< Size of the observation of a single environment in bytes.
+
+private:
+	/**
+	 * @brief Emulates frames on a single environment.
+	 * @param env Index of the environment.
+	 * @param keys The keys held.
+	 * @param frameskip Number of frames to emulate.
+	 */
+	void StepEnv(uint32_t env, uint16_t keys, uint32_t frameskip);
+
+	/**
+	 * @brief Copies an environment's Framebuffer into its observation.
+	 * @param env Index of the environment.
+	 */
+	void Observe(uint32_t env);
+
+	/**
+	 * @brief Runs a function on every environment, on the ThreadPool.
+	 * @param function Called once per environment, with its index.
+	 */
+	void ForEachEnv(const function<void(uint32_t env)>& function);
+
+	static const uint32_t FRAME_FREQUENCY = 60;			///< Frames emulated per second of emulated time.
+	static const uint32_t ENVS_PER_TASK = 16;			///< Environments stepped by a single task, amortizing taking tasks.
+
+	const string romPath;								///< Path to the ROM every environment runs.
+	uint32_t numEnvs = 0;								///< Number of environments.
+	uint32_t clockFrequency = 0;						///< Rate of the emulated clock, in opcodes per second.
+	uint32_t maxEpisodeFrames = 0;						///< Frames after which episodes end, 0 for no limit.
+	uint32_t seed = 1;									///< Seed of the first episode of the first environment.
+	uint64_t numFrames = 0;								///< Number of frames emulated over all environments.
+	ThreadPool threadPool;								///< Workers stepping the environments.
+	MachineState bootState;								///< MachineState right after loading the ROM, which every episode starts from.
+	RewardHook rewardHook;								///< Reads rewards after every frame, if set.
+	DoneHook doneHook;									///< Reads whether episodes ended after every frame, if set.
+
+	vector<unique_ptr<Emulator>> emulators;				///< Emulator of every environment.
+	vector<uint64_t> episodes;							///< Number of episodes every environment started, its seed counting up with it.
+	vector<uint64_t> episodeFrames;						///< Number of frames emulated in every environment's current episode.
+	vector<uint64_t> ownObservations;					///< The VecEnv's own observation buffer.
+	uint64_t* observations = nullptr;					///< Where observations are written to, ownObservations or the caller's.
+	vector<float> rewards;								///< Reward of every environment in the latest Step().
+	vector<uint8_t> dones;								///< Whether every environment's episode ended.
+};
@@ -0,0 +1,51 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+
+#include "VecEnvBenchmark.h"
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include "Emulator.h"
+#include "Framebuffer.h"
+#include "SteadyClock.h"
+#include "VecEnv.h"
+
+int RunVecEnvBenchmark(const std::string& romPath, ExecutionMode executionMode, uint32_t instructionsPerSecond, uint32_t numSteps, uint32_t numEnvs, uint32_t frameskip, uint32_t numThreads)
+{
+	VecEnv vecEnv(romPath, numEnvs, numThreads);
+	vecEnv.SetMaxEpisodeFrames(std::max<uint32_t>(numSteps / 2 * frameskip, 1));
+	if (!vecEnv.Init(executionMode, instructionsPerSecond))
+		return -1;
+
+	std::vector<uint16_t> actions(numEnvs, 0);
+	uint32_t random = 1;
+
+	SteadyClock clock;
+	const uint64_t startTime = clock.GetTicksNS();
+	for (uint32_t step = 0; step < numSteps; step++)
+	{
+		// A single key or none, as policies over CHIP-8's keypad typically pick
+		for (uint32_t env = 0; env < numEnvs; env++)
+		{
+			random ^= random << 13;
+			random ^= random >> 17;
+			random ^= random << 5;
+			actions[env] = random % 17 < 16 ? (uint16_t)(1 << (random % 17)) : 0;
+		}
+
+		vecEnv.Step(actions.data(), frameskip);
+		vecEnv.Reset(vecEnv.GetDones());
+	}
+
+	const uint64_t duration = clock.GetTicksNS() - startTime;
+
+	// Hashed so runs with different numbers of threads can be compared
+	uint64_t hash = 14695981039346656037ull;
+	const uint64_t* observations = vecEnv.GetObservations();
+	for (size_t i = 0; i < (size_t)numEnvs * Framebuffer::HEIGHT; i++)
+		hash = (hash ^ observations[i]) * 1099511628211ull;
+
+	std::cout << "Stepped " << numEnvs << " environments " << numSteps << " times, " << frameskip << " frames per step" << std::endl;
+	std::cout << vecEnv.GetNumFrames() << " frames in " << duration / 1e6 << " ms, " << vecEnv.GetNumFrames() * 1e9 / std::max<uint64_t>(duration, 1) << " frames per second" << std::endl;
+	std::cout << "Observation hash: " << std::hex << hash << std::dec << std::endl;
+	return 0;
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2025, Moonpirates. All rights reserved.
+#pragma once
+
+// Includes
+#include <cstdint>
+#include <string>
+
+// Forward declarations
+enum class ExecutionMode;
+
+/**
+ * @brief Steps a VecEnv with random actions, as a training loop would, and reports the frames emulated per second.
+ * Episodes end after half the steps, so resetting the environments is measured too.
+ * @param romPath Path to the ROM every environment runs.
+ * @param executionMode How the environments execute opcodes.
+ * @param instructionsPerSecond Rate of the emulated clock, which determines the number of opcodes per frame.
+ * @param numSteps Number of steps to take.
+ * @param numEnvs Number of environments.
+ * @param frameskip Number of frames emulated per step.
+ * @param numThreads Number of worker threads, 0 for one per hardware thread.
+ * @return Returns 0 if the environments could be initialized.
+ */
+int RunVecEnvBenchmark(const std::string& romPath, ExecutionMode executionMode, uint32_t instructionsPerSecond, uint32_t numSteps, uint32_t numEnvs, uint32_t frameskip, uint32_t numThreads);
@@ -0,0 +1,687 @@
+// Generated by chip8rc from 'breakout.rom', do not edit.
+
+#include "CompiledRom.h"
+
+namespace
+{
+	const uint16_t CODE_RANGES[][2] =
+	{
+		{ 0x200, 0x20A },
+		{ 0x20C, 0x21E },
+		{ 0x220, 0x228 },
+		{ 0x22A, 0x22E },
+		{ 0x230, 0x232 },
+		{ 0x236, 0x23A },
+		{ 0x23C, 0x244 },
+		{ 0x246, 0x248 },
+		{ 0x24A, 0x24C },
+		{ 0x24E, 0x252 },
+		{ 0x254, 0x25A },
+		{ 0x25C, 0x25E },
+		{ 0x260, 0x27C },
+		{ 0x27E, 0x290 },
+		{ 0x292, 0x29A },
+		{ 0x29C, 0x2CC },
+		{ 0x2CE, 0x2D8 },
+		{ 0x2DA, 0x2F0 },
+		{ 0x2F2, 0x2F8 },
+		{ 0x2FE, 0x302 },
+		{ 0x304, 0x306 },
+		{ 0x30A, 0x30C },
+	};
+
+	uint32_t Run(uint8_t* V, uint16_t& I, uint16_t& PC, uint32_t budget)
+	{
+		uint32_t executed = 0;
+
+		switch (PC)
+		{
+			case 0x200: goto L200;
+			case 0x206: goto L206;
+			case 0x208: goto L208;
+			case 0x20C: goto L20C;
+			case 0x210: goto L210;
+			case 0x212: goto L212;
+			case 0x216: goto L216;
+			case 0x218: goto L218;
+			case 0x222: goto L222;
+			case 0x22A: goto L22A;
+			case 0x230: goto L230;
+			case 0x236: goto L236;
+			case 0x238: goto L238;
+			case 0x23C: goto L23C;
+			case 0x246: goto L246;
+			case 0x24A: goto L24A;
+			case 0x24E: goto L24E;
+			case 0x254: goto L254;
+			case 0x25C: goto L25C;
+			case 0x260: goto L260;
+			case 0x26E: goto L26E;
+			case 0x270: goto L270;
+			case 0x272: goto L272;
+			case 0x274: goto L274;
+			case 0x276: goto L276;
+			case 0x278: goto L278;
+			case 0x27A: goto L27A;
+			case 0x27E: goto L27E;
+			case 0x280: goto L280;
+			case 0x282: goto L282;
+			case 0x284: goto L284;
+			case 0x286: goto L286;
+			case 0x28C: goto L28C;
+			case 0x28E: goto L28E;
+			case 0x292: goto L292;
+			case 0x29C: goto L29C;
+			case 0x2A2: goto L2A2;
+			case 0x2A6: goto L2A6;
+			case 0x2A8: goto L2A8;
+			case 0x2AA: goto L2AA;
+			case 0x2AC: goto L2AC;
+			case 0x2B4: goto L2B4;
+			case 0x2B6: goto L2B6;
+			case 0x2BC: goto L2BC;
+			case 0x2BE: goto L2BE;
+			case 0x2C2: goto L2C2;
+			case 0x2C4: goto L2C4;
+			case 0x2C8: goto L2C8;
+			case 0x2CA: goto L2CA;
+			case 0x2CE: goto L2CE;
+			case 0x2DA: goto L2DA;
+			case 0x2DC: goto L2DC;
+			case 0x2DE: goto L2DE;
+			case 0x2E0: goto L2E0;
+			case 0x2E4: goto L2E4;
+			case 0x2E6: goto L2E6;
+			case 0x2E8: goto L2E8;
+			case 0x2EC: goto L2EC;
+			case 0x2EE: goto L2EE;
+			case 0x2F2: goto L2F2;
+			case 0x2F6: goto L2F6;
+			case 0x2FE: goto L2FE;
+			case 0x304: goto L304;
+			default: return 0;
+		}
+
+	L200:
+		if (budget - executed < 3) { PC = 0x200; return executed; }
+		executed += 3;
+		// 6E05
+		V[0xE] = 0x05;
+		// 6500
+		V[0x5] = 0x00;
+		// 6B06
+		V[0xB] = 0x06;
+		goto L206;
+
+	L206:
+		if (budget - executed < 1) { PC = 0x206; return executed; }
+		executed += 1;
+		// 6A00
+		V[0xA] = 0x00;
+		goto L208;
+
+	L208:
+		if (budget - executed < 1) { PC = 0x208; return executed; }
+		executed += 1;
+		// A30C
+		I = 0x30C;
+		PC = 0x20A; return executed;
+
+	L20C:
+		if (budget - executed < 2) { PC = 0x20C; return executed; }
+		executed += 2;
+		// 7A04
+		V[0xA] += 0x04;
+		// 3A40
+		if (V[0xA] == 0x40)
+		{
+			goto L212;
+		}
+		goto L210;
+
+	L210:
+		if (budget - executed < 1) { PC = 0x210; return executed; }
+		executed += 1;
+		// 1208
+		goto L208;
+
+	L212:
+		if (budget - executed < 2) { PC = 0x212; return executed; }
+		executed += 2;
+		// 7B02
+		V[0xB] += 0x02;
+		// 3B12
+		if (V[0xB] == 0x12)
+		{
+			goto L218;
+		}
+		goto L216;
+
+	L216:
+		if (budget - executed < 1) { PC = 0x216; return executed; }
+		executed += 1;
+		// 1206
+		goto L206;
+
+	L218:
+		if (budget - executed < 3) { PC = 0x218; return executed; }
+		executed += 3;
+		// 6C20
+		V[0xC] = 0x20;
+		// 6D1F
+		V[0xD] = 0x1F;
+		// A310
+		I = 0x310;
+		PC = 0x21E; return executed;
+
+	L222:
+		if (budget - executed < 3) { PC = 0x222; return executed; }
+		executed += 3;
+		// 6000
+		V[0x0] = 0x00;
+		// 6100
+		V[0x1] = 0x00;
+		// A312
+		I = 0x312;
+		PC = 0x228; return executed;
+
+	L22A:
+		if (budget - executed < 2) { PC = 0x22A; return executed; }
+		executed += 2;
+		// 7008
+		V[0x0] += 0x08;
+		// A30E
+		I = 0x30E;
+		PC = 0x22E; return executed;
+
+	L230:
+		if (budget - executed < 1) { PC = 0x230; return executed; }
+		executed += 1;
+		// 6040
+		V[0x0] = 0x40;
+		PC = 0x232; return executed;
+
+	L236:
+		if (budget - executed < 1) { PC = 0x236; return executed; }
+		executed += 1;
+		// 3000
+		if (V[0x0] == 0x00)
+		{
+			PC = 0x23A; return executed;
+		}
+		goto L238;
+
+	L238:
+		if (budget - executed < 1) { PC = 0x238; return executed; }
+		executed += 1;
+		// 1234
+		PC = 0x234; return executed;
+
+	L23C:
+		if (budget - executed < 4) { PC = 0x23C; return executed; }
+		executed += 4;
+		// 671E
+		V[0x7] = 0x1E;
+		// 6801
+		V[0x8] = 0x01;
+		// 69FF
+		V[0x9] = 0xFF;
+		// A30E
+		I = 0x30E;
+		PC = 0x244; return executed;
+
+	L246:
+		if (budget - executed < 1) { PC = 0x246; return executed; }
+		executed += 1;
+		// A310
+		I = 0x310;
+		PC = 0x248; return executed;
+
+	L24A:
+		if (budget - executed < 1) { PC = 0x24A; return executed; }
+		executed += 1;
+		// 6004
+		V[0x0] = 0x04;
+		PC = 0x24C; return executed;
+
+	L24E:
+		if (budget - executed < 2) { PC = 0x24E; return executed; }
+		executed += 2;
+		// 7CFE
+		V[0xC] += 0xFE;
+		// 6006
+		V[0x0] = 0x06;
+		PC = 0x252; return executed;
+
+	L254:
+		if (budget - executed < 3) { PC = 0x254; return executed; }
+		executed += 3;
+		// 7C02
+		V[0xC] += 0x02;
+		// 603F
+		V[0x0] = 0x3F;
+		// 8C02
+		V[0xC] &= V[0x0];
+		PC = 0x25A; return executed;
+
+	L25C:
+		if (budget - executed < 1) { PC = 0x25C; return executed; }
+		executed += 1;
+		// A30E
+		I = 0x30E;
+		PC = 0x25E; return executed;
+
+	L260:
+		if (budget - executed < 7) { PC = 0x260; return executed; }
+		executed += 7;
+		// 8684
+		if (V[0x6] + V[0x8] > 255) V[0xF] = 1;
+		V[0x6] += V[0x8];
+		// 8794
+		if (V[0x7] + V[0x9] > 255) V[0xF] = 1;
+		V[0x7] += V[0x9];
+		// 603F
+		V[0x0] = 0x3F;
+		// 8602
+		V[0x6] &= V[0x0];
+		// 611F
+		V[0x1] = 0x1F;
+		// 8712
+		V[0x7] &= V[0x1];
+		// 471F
+		if (V[0x7] != 0x1F)
+		{
+			goto L270;
+		}
+		goto L26E;
+
+	L26E:
+		if (budget - executed < 1) { PC = 0x26E; return executed; }
+		executed += 1;
+		// 12AC
+		goto L2AC;
+
+	L270:
+		if (budget - executed < 1) { PC = 0x270; return executed; }
+		executed += 1;
+		// 4600
+		if (V[0x6] != 0x00)
+		{
+			goto L274;
+		}
+		goto L272;
+
+	L272:
+		if (budget - executed < 1) { PC = 0x272; return executed; }
+		executed += 1;
+		// 6801
+		V[0x8] = 0x01;
+		goto L274;
+
+	L274:
+		if (budget - executed < 1) { PC = 0x274; return executed; }
+		executed += 1;
+		// 463F
+		if (V[0x6] != 0x3F)
+		{
+			goto L278;
+		}
+		goto L276;
+
+	L276:
+		if (budget - executed < 1) { PC = 0x276; return executed; }
+		executed += 1;
+		// 68FF
+		V[0x8] = 0xFF;
+		goto L278;
+
+	L278:
+		if (budget - executed < 1) { PC = 0x278; return executed; }
+		executed += 1;
+		// 4700
+		if (V[0x7] != 0x00)
+		{
+			PC = 0x27C; return executed;
+		}
+		goto L27A;
+
+	L27A:
+		if (budget - executed < 1) { PC = 0x27A; return executed; }
+		executed += 1;
+		// 6901
+		V[0x9] = 0x01;
+		PC = 0x27C; return executed;
+
+	L27E:
+		if (budget - executed < 1) { PC = 0x27E; return executed; }
+		executed += 1;
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			goto L282;
+		}
+		goto L280;
+
+	L280:
+		if (budget - executed < 1) { PC = 0x280; return executed; }
+		executed += 1;
+		// 12AA
+		goto L2AA;
+
+	L282:
+		if (budget - executed < 1) { PC = 0x282; return executed; }
+		executed += 1;
+		// 471F
+		if (V[0x7] != 0x1F)
+		{
+			goto L286;
+		}
+		goto L284;
+
+	L284:
+		if (budget - executed < 1) { PC = 0x284; return executed; }
+		executed += 1;
+		// 12AA
+		goto L2AA;
+
+	L286:
+		if (budget - executed < 3) { PC = 0x286; return executed; }
+		executed += 3;
+		// 6005
+		V[0x0] = 0x05;
+		// 8075
+		V[0xF] = V[0x0] >= V[0x7];
+		V[0x0] = V[0x0] - V[0x7];
+		// 3F00
+		if (V[0xF] == 0x00)
+		{
+			goto L28E;
+		}
+		goto L28C;
+
+	L28C:
+		if (budget - executed < 1) { PC = 0x28C; return executed; }
+		executed += 1;
+		// 12AA
+		goto L2AA;
+
+	L28E:
+		if (budget - executed < 1) { PC = 0x28E; return executed; }
+		executed += 1;
+		// 6001
+		V[0x0] = 0x01;
+		PC = 0x290; return executed;
+
+	L292:
+		if (budget - executed < 4) { PC = 0x292; return executed; }
+		executed += 4;
+		// 8060
+		V[0x0] = V[0x6];
+		// 61FC
+		V[0x1] = 0xFC;
+		// 8012
+		V[0x0] &= V[0x1];
+		// A30C
+		I = 0x30C;
+		PC = 0x29A; return executed;
+
+	L29C:
+		if (budget - executed < 2) { PC = 0x29C; return executed; }
+		executed += 2;
+		// 60FE
+		V[0x0] = 0xFE;
+		// 8903
+		V[0x9] ^= V[0x0];
+		PC = 0x2A0; return executed;
+
+	L2A2:
+		if (budget - executed < 1) { PC = 0x2A2; return executed; }
+		executed += 1;
+		// 7501
+		V[0x5] += 0x01;
+		PC = 0x2A4; return executed;
+
+	L2A6:
+		if (budget - executed < 1) { PC = 0x2A6; return executed; }
+		executed += 1;
+		// 4560
+		if (V[0x5] != 0x60)
+		{
+			goto L2AA;
+		}
+		goto L2A8;
+
+	L2A8:
+		if (budget - executed < 1) { PC = 0x2A8; return executed; }
+		executed += 1;
+		// 12DE
+		goto L2DE;
+
+	L2AA:
+		if (budget - executed < 1) { PC = 0x2AA; return executed; }
+		executed += 1;
+		// 1246
+		goto L246;
+
+	L2AC:
+		if (budget - executed < 4) { PC = 0x2AC; return executed; }
+		executed += 4;
+		// 69FF
+		V[0x9] = 0xFF;
+		// 8060
+		V[0x0] = V[0x6];
+		// 80C5
+		V[0xF] = V[0x0] >= V[0xC];
+		V[0x0] = V[0x0] - V[0xC];
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			goto L2B6;
+		}
+		goto L2B4;
+
+	L2B4:
+		if (budget - executed < 1) { PC = 0x2B4; return executed; }
+		executed += 1;
+		// 12CA
+		goto L2CA;
+
+	L2B6:
+		if (budget - executed < 3) { PC = 0x2B6; return executed; }
+		executed += 3;
+		// 6102
+		V[0x1] = 0x02;
+		// 8015
+		V[0xF] = V[0x0] >= V[0x1];
+		V[0x0] = V[0x0] - V[0x1];
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			goto L2BE;
+		}
+		goto L2BC;
+
+	L2BC:
+		if (budget - executed < 1) { PC = 0x2BC; return executed; }
+		executed += 1;
+		// 12E0
+		goto L2E0;
+
+	L2BE:
+		if (budget - executed < 2) { PC = 0x2BE; return executed; }
+		executed += 2;
+		// 8015
+		V[0xF] = V[0x0] >= V[0x1];
+		V[0x0] = V[0x0] - V[0x1];
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			goto L2C4;
+		}
+		goto L2C2;
+
+	L2C2:
+		if (budget - executed < 1) { PC = 0x2C2; return executed; }
+		executed += 1;
+		// 12EE
+		goto L2EE;
+
+	L2C4:
+		if (budget - executed < 2) { PC = 0x2C4; return executed; }
+		executed += 2;
+		// 8015
+		V[0xF] = V[0x0] >= V[0x1];
+		V[0x0] = V[0x0] - V[0x1];
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			goto L2CA;
+		}
+		goto L2C8;
+
+	L2C8:
+		if (budget - executed < 1) { PC = 0x2C8; return executed; }
+		executed += 1;
+		// 12E8
+		goto L2E8;
+
+	L2CA:
+		if (budget - executed < 1) { PC = 0x2CA; return executed; }
+		executed += 1;
+		// 6020
+		V[0x0] = 0x20;
+		PC = 0x2CC; return executed;
+
+	L2CE:
+		if (budget - executed < 5) { PC = 0x2CE; return executed; }
+		executed += 5;
+		// A30E
+		I = 0x30E;
+		// 7EFF
+		V[0xE] += 0xFF;
+		// 80E0
+		V[0x0] = V[0xE];
+		// 8004
+		if (V[0x0] + V[0x0] > 255) V[0xF] = 1;
+		V[0x0] += V[0x0];
+		// 6100
+		V[0x1] = 0x00;
+		PC = 0x2D8; return executed;
+
+	L2DA:
+		if (budget - executed < 1) { PC = 0x2DA; return executed; }
+		executed += 1;
+		// 3E00
+		if (V[0xE] == 0x00)
+		{
+			goto L2DE;
+		}
+		goto L2DC;
+
+	L2DC:
+		if (budget - executed < 1) { PC = 0x2DC; return executed; }
+		executed += 1;
+		// 1230
+		goto L230;
+
+	L2DE:
+		if (budget - executed < 1) { PC = 0x2DE; return executed; }
+		executed += 1;
+		// 12DE
+		goto L2DE;
+
+	L2E0:
+		if (budget - executed < 2) { PC = 0x2E0; return executed; }
+		executed += 2;
+		// 78FF
+		V[0x8] += 0xFF;
+		// 48FE
+		if (V[0x8] != 0xFE)
+		{
+			goto L2E6;
+		}
+		goto L2E4;
+
+	L2E4:
+		if (budget - executed < 1) { PC = 0x2E4; return executed; }
+		executed += 1;
+		// 68FF
+		V[0x8] = 0xFF;
+		goto L2E6;
+
+	L2E6:
+		if (budget - executed < 1) { PC = 0x2E6; return executed; }
+		executed += 1;
+		// 12EE
+		goto L2EE;
+
+	L2E8:
+		if (budget - executed < 2) { PC = 0x2E8; return executed; }
+		executed += 2;
+		// 7801
+		V[0x8] += 0x01;
+		// 4802
+		if (V[0x8] != 0x02)
+		{
+			goto L2EE;
+		}
+		goto L2EC;
+
+	L2EC:
+		if (budget - executed < 1) { PC = 0x2EC; return executed; }
+		executed += 1;
+		// 6801
+		V[0x8] = 0x01;
+		goto L2EE;
+
+	L2EE:
+		if (budget - executed < 1) { PC = 0x2EE; return executed; }
+		executed += 1;
+		// 6004
+		V[0x0] = 0x04;
+		PC = 0x2F0; return executed;
+
+	L2F2:
+		if (budget - executed < 2) { PC = 0x2F2; return executed; }
+		executed += 2;
+		// 69FF
+		V[0x9] = 0xFF;
+		// 1270
+		goto L270;
+
+	L2F6:
+		if (budget - executed < 1) { PC = 0x2F6; return executed; }
+		executed += 1;
+		// A314
+		I = 0x314;
+		PC = 0x2F8; return executed;
+
+	L2FE:
+		if (budget - executed < 2) { PC = 0x2FE; return executed; }
+		executed += 2;
+		// 6337
+		V[0x3] = 0x37;
+		// 6400
+		V[0x4] = 0x00;
+		PC = 0x302; return executed;
+
+	L304:
+		if (budget - executed < 1) { PC = 0x304; return executed; }
+		executed += 1;
+		// 7305
+		V[0x3] += 0x05;
+		PC = 0x306; return executed;
+	}
+}
+
+static const CompiledRom COMPILED_ROM =
+{
+	"breakout",
+	0x2671ACB470B32F3Cull,
+	280,
+	&Run,
+	CODE_RANGES,
+	22,
+};
+
+static const bool registered = RegisterCompiledRom(&COMPILED_ROM);
@@ -0,0 +1,871 @@
+// Generated by chip8rc from 'tetris.ch8', do not edit.
+
+#include "CompiledRom.h"
+
+namespace
+{
+	const uint16_t CODE_RANGES[][2] =
+	{
+		{ 0x200, 0x208 },
+		{ 0x20A, 0x210 },
+		{ 0x212, 0x214 },
+		{ 0x216, 0x21C },
+		{ 0x21E, 0x222 },
+		{ 0x224, 0x22A },
+		{ 0x22E, 0x232 },
+		{ 0x234, 0x236 },
+		{ 0x238, 0x23C },
+		{ 0x23E, 0x240 },
+		{ 0x242, 0x244 },
+		{ 0x246, 0x248 },
+		{ 0x24A, 0x24C },
+		{ 0x252, 0x256 },
+		{ 0x258, 0x272 },
+		{ 0x274, 0x27C },
+		{ 0x27E, 0x284 },
+		{ 0x286, 0x28E },
+		{ 0x290, 0x296 },
+		{ 0x298, 0x2A6 },
+		{ 0x2A8, 0x2B4 },
+		{ 0x2B6, 0x2C4 },
+		{ 0x336, 0x362 },
+		{ 0x364, 0x368 },
+		{ 0x36A, 0x374 },
+		{ 0x376, 0x386 },
+		{ 0x388, 0x38C },
+		{ 0x38E, 0x390 },
+		{ 0x392, 0x3C2 },
+		{ 0x3C4, 0x3C6 },
+		{ 0x3CC, 0x3D0 },
+		{ 0x3D2, 0x3D4 },
+		{ 0x3D8, 0x3DA },
+		{ 0x3DE, 0x3E0 },
+		{ 0x3E2, 0x3EC },
+	};
+
+	uint32_t Run(uint8_t* V, uint16_t& I, uint16_t& PC, uint32_t budget)
+	{
+		uint32_t executed = 0;
+
+		switch (PC)
+		{
+			case 0x200: goto L200;
+			case 0x206: goto L206;
+			case 0x20A: goto L20A;
+			case 0x20C: goto L20C;
+			case 0x20E: goto L20E;
+			case 0x212: goto L212;
+			case 0x216: goto L216;
+			case 0x21A: goto L21A;
+			case 0x21E: goto L21E;
+			case 0x220: goto L220;
+			case 0x224: goto L224;
+			case 0x22E: goto L22E;
+			case 0x230: goto L230;
+			case 0x234: goto L234;
+			case 0x23A: goto L23A;
+			case 0x24A: goto L24A;
+			case 0x252: goto L252;
+			case 0x254: goto L254;
+			case 0x258: goto L258;
+			case 0x25C: goto L25C;
+			case 0x264: goto L264;
+			case 0x266: goto L266;
+			case 0x268: goto L268;
+			case 0x26A: goto L26A;
+			case 0x26C: goto L26C;
+			case 0x26E: goto L26E;
+			case 0x274: goto L274;
+			case 0x278: goto L278;
+			case 0x27E: goto L27E;
+			case 0x286: goto L286;
+			case 0x28A: goto L28A;
+			case 0x290: goto L290;
+			case 0x298: goto L298;
+			case 0x29C: goto L29C;
+			case 0x2A2: goto L2A2;
+			case 0x2A8: goto L2A8;
+			case 0x2AC: goto L2AC;
+			case 0x2B6: goto L2B6;
+			case 0x336: goto L336;
+			case 0x338: goto L338;
+			case 0x33C: goto L33C;
+			case 0x340: goto L340;
+			case 0x346: goto L346;
+			case 0x348: goto L348;
+			case 0x34A: goto L34A;
+			case 0x34C: goto L34C;
+			case 0x34E: goto L34E;
+			case 0x352: goto L352;
+			case 0x356: goto L356;
+			case 0x35A: goto L35A;
+			case 0x35E: goto L35E;
+			case 0x364: goto L364;
+			case 0x366: goto L366;
+			case 0x36A: goto L36A;
+			case 0x36E: goto L36E;
+			case 0x372: goto L372;
+			case 0x376: goto L376;
+			case 0x37A: goto L37A;
+			case 0x37C: goto L37C;
+			case 0x382: goto L382;
+			case 0x388: goto L388;
+			case 0x38A: goto L38A;
+			case 0x38E: goto L38E;
+			case 0x392: goto L392;
+			case 0x394: goto L394;
+			case 0x398: goto L398;
+			case 0x39A: goto L39A;
+			case 0x39C: goto L39C;
+			case 0x39E: goto L39E;
+			case 0x3A4: goto L3A4;
+			case 0x3A8: goto L3A8;
+			case 0x3AC: goto L3AC;
+			case 0x3B0: goto L3B0;
+			case 0x3B8: goto L3B8;
+			case 0x3BA: goto L3BA;
+			case 0x3BC: goto L3BC;
+			case 0x3C0: goto L3C0;
+			case 0x3C4: goto L3C4;
+			case 0x3CC: goto L3CC;
+			case 0x3D2: goto L3D2;
+			case 0x3D8: goto L3D8;
+			case 0x3DE: goto L3DE;
+			case 0x3E2: goto L3E2;
+			case 0x3E6: goto L3E6;
+			default: return 0;
+		}
+
+	L200:
+		if (budget - executed < 1) { PC = 0x200; return executed; }
+		executed += 1;
+		// A2B4
+		I = 0x2B4;
+		PC = 0x202; return executed;
+
+	L206:
+		if (budget - executed < 1) { PC = 0x206; return executed; }
+		executed += 1;
+		// 7001
+		V[0x0] += 0x01;
+		PC = 0x208; return executed;
+
+	L20A:
+		if (budget - executed < 1) { PC = 0x20A; return executed; }
+		executed += 1;
+		// 3025
+		if (V[0x0] == 0x25)
+		{
+			goto L20E;
+		}
+		goto L20C;
+
+	L20C:
+		if (budget - executed < 1) { PC = 0x20C; return executed; }
+		executed += 1;
+		// 1206
+		goto L206;
+
+	L20E:
+		if (budget - executed < 1) { PC = 0x20E; return executed; }
+		executed += 1;
+		// 71FF
+		V[0x1] += 0xFF;
+		PC = 0x210; return executed;
+
+	L212:
+		if (budget - executed < 1) { PC = 0x212; return executed; }
+		executed += 1;
+		// 601A
+		V[0x0] = 0x1A;
+		PC = 0x214; return executed;
+
+	L216:
+		if (budget - executed < 2) { PC = 0x216; return executed; }
+		executed += 2;
+		// 6025
+		V[0x0] = 0x25;
+		// 3100
+		if (V[0x1] == 0x00)
+		{
+			PC = 0x21C; return executed;
+		}
+		goto L21A;
+
+	L21A:
+		if (budget - executed < 1) { PC = 0x21A; return executed; }
+		executed += 1;
+		// 120E
+		goto L20E;
+
+	L21E:
+		if (budget - executed < 1) { PC = 0x21E; return executed; }
+		executed += 1;
+		// 4470
+		if (V[0x4] != 0x70)
+		{
+			PC = 0x222; return executed;
+		}
+		goto L220;
+
+	L220:
+		if (budget - executed < 1) { PC = 0x220; return executed; }
+		executed += 1;
+		// 121C
+		PC = 0x21C; return executed;
+
+	L224:
+		if (budget - executed < 2) { PC = 0x224; return executed; }
+		executed += 2;
+		// 601E
+		V[0x0] = 0x1E;
+		// 6103
+		V[0x1] = 0x03;
+		PC = 0x228; return executed;
+
+	L22E:
+		if (budget - executed < 1) { PC = 0x22E; return executed; }
+		executed += 1;
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			PC = 0x232; return executed;
+		}
+		goto L230;
+
+	L230:
+		if (budget - executed < 1) { PC = 0x230; return executed; }
+		executed += 1;
+		// 123C
+		PC = 0x23C; return executed;
+
+	L234:
+		if (budget - executed < 1) { PC = 0x234; return executed; }
+		executed += 1;
+		// 71FF
+		V[0x1] += 0xFF;
+		PC = 0x236; return executed;
+
+	L23A:
+		if (budget - executed < 1) { PC = 0x23A; return executed; }
+		executed += 1;
+		// 121C
+		PC = 0x21C; return executed;
+
+	L24A:
+		if (budget - executed < 1) { PC = 0x24A; return executed; }
+		executed += 1;
+		// 1250
+		PC = 0x250; return executed;
+
+	L252:
+		if (budget - executed < 1) { PC = 0x252; return executed; }
+		executed += 1;
+		// 3600
+		if (V[0x6] == 0x00)
+		{
+			PC = 0x256; return executed;
+		}
+		goto L254;
+
+	L254:
+		if (budget - executed < 1) { PC = 0x254; return executed; }
+		executed += 1;
+		// 123C
+		PC = 0x23C; return executed;
+
+	L258:
+		if (budget - executed < 2) { PC = 0x258; return executed; }
+		executed += 2;
+		// 7101
+		V[0x1] += 0x01;
+		// 122A
+		PC = 0x22A; return executed;
+
+	L25C:
+		if (budget - executed < 4) { PC = 0x25C; return executed; }
+		executed += 4;
+		// A2C4
+		I = 0x2C4;
+		// F41E
+		I += V[0x4];
+		// 6600
+		V[0x6] = 0x00;
+		// 4301
+		if (V[0x3] != 0x01)
+		{
+			goto L266;
+		}
+		goto L264;
+
+	L264:
+		if (budget - executed < 1) { PC = 0x264; return executed; }
+		executed += 1;
+		// 6604
+		V[0x6] = 0x04;
+		goto L266;
+
+	L266:
+		if (budget - executed < 1) { PC = 0x266; return executed; }
+		executed += 1;
+		// 4302
+		if (V[0x3] != 0x02)
+		{
+			goto L26A;
+		}
+		goto L268;
+
+	L268:
+		if (budget - executed < 1) { PC = 0x268; return executed; }
+		executed += 1;
+		// 6608
+		V[0x6] = 0x08;
+		goto L26A;
+
+	L26A:
+		if (budget - executed < 1) { PC = 0x26A; return executed; }
+		executed += 1;
+		// 4303
+		if (V[0x3] != 0x03)
+		{
+			goto L26E;
+		}
+		goto L26C;
+
+	L26C:
+		if (budget - executed < 1) { PC = 0x26C; return executed; }
+		executed += 1;
+		// 660C
+		V[0x6] = 0x0C;
+		goto L26E;
+
+	L26E:
+		if (budget - executed < 1) { PC = 0x26E; return executed; }
+		executed += 1;
+		// F61E
+		I += V[0x6];
+		PC = 0x270; return executed;
+
+	L274:
+		if (budget - executed < 1) { PC = 0x274; return executed; }
+		executed += 1;
+		// 70FF
+		V[0x0] += 0xFF;
+		PC = 0x276; return executed;
+
+	L278:
+		if (budget - executed < 1) { PC = 0x278; return executed; }
+		executed += 1;
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			PC = 0x27C; return executed;
+		}
+		PC = 0x27A; return executed;
+
+	L27E:
+		if (budget - executed < 1) { PC = 0x27E; return executed; }
+		executed += 1;
+		// 7001
+		V[0x0] += 0x01;
+		PC = 0x280; return executed;
+
+	L286:
+		if (budget - executed < 1) { PC = 0x286; return executed; }
+		executed += 1;
+		// 7001
+		V[0x0] += 0x01;
+		PC = 0x288; return executed;
+
+	L28A:
+		if (budget - executed < 1) { PC = 0x28A; return executed; }
+		executed += 1;
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			PC = 0x28E; return executed;
+		}
+		PC = 0x28C; return executed;
+
+	L290:
+		if (budget - executed < 1) { PC = 0x290; return executed; }
+		executed += 1;
+		// 70FF
+		V[0x0] += 0xFF;
+		PC = 0x292; return executed;
+
+	L298:
+		if (budget - executed < 2) { PC = 0x298; return executed; }
+		executed += 2;
+		// 7301
+		V[0x3] += 0x01;
+		// 4304
+		if (V[0x3] != 0x04)
+		{
+			PC = 0x29E; return executed;
+		}
+		goto L29C;
+
+	L29C:
+		if (budget - executed < 1) { PC = 0x29C; return executed; }
+		executed += 1;
+		// 6300
+		V[0x3] = 0x00;
+		PC = 0x29E; return executed;
+
+	L2A2:
+		if (budget - executed < 1) { PC = 0x2A2; return executed; }
+		executed += 1;
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			PC = 0x2A6; return executed;
+		}
+		PC = 0x2A4; return executed;
+
+	L2A8:
+		if (budget - executed < 2) { PC = 0x2A8; return executed; }
+		executed += 2;
+		// 73FF
+		V[0x3] += 0xFF;
+		// 43FF
+		if (V[0x3] != 0xFF)
+		{
+			PC = 0x2AE; return executed;
+		}
+		goto L2AC;
+
+	L2AC:
+		if (budget - executed < 1) { PC = 0x2AC; return executed; }
+		executed += 1;
+		// 6303
+		V[0x3] = 0x03;
+		PC = 0x2AE; return executed;
+
+	L2B6:
+		if (budget - executed < 6) { PC = 0x2B6; return executed; }
+		executed += 6;
+		// 6705
+		V[0x7] = 0x05;
+		// 6806
+		V[0x8] = 0x06;
+		// 6904
+		V[0x9] = 0x04;
+		// 611F
+		V[0x1] = 0x1F;
+		// 6510
+		V[0x5] = 0x10;
+		// 6207
+		V[0x2] = 0x07;
+		PC = 0x2C2; return executed;
+
+	L336:
+		if (budget - executed < 1) { PC = 0x336; return executed; }
+		executed += 1;
+		// 6635
+		V[0x6] = 0x35;
+		goto L338;
+
+	L338:
+		if (budget - executed < 2) { PC = 0x338; return executed; }
+		executed += 2;
+		// 76FF
+		V[0x6] += 0xFF;
+		// 3600
+		if (V[0x6] == 0x00)
+		{
+			PC = 0x33E; return executed;
+		}
+		goto L33C;
+
+	L33C:
+		if (budget - executed < 1) { PC = 0x33C; return executed; }
+		executed += 1;
+		// 1338
+		goto L338;
+
+	L340:
+		if (budget - executed < 3) { PC = 0x340; return executed; }
+		executed += 3;
+		// A2B4
+		I = 0x2B4;
+		// 8C10
+		V[0xC] = V[0x1];
+		// 3C1E
+		if (V[0xC] == 0x1E)
+		{
+			goto L348;
+		}
+		goto L346;
+
+	L346:
+		if (budget - executed < 1) { PC = 0x346; return executed; }
+		executed += 1;
+		// 7C01
+		V[0xC] += 0x01;
+		goto L348;
+
+	L348:
+		if (budget - executed < 1) { PC = 0x348; return executed; }
+		executed += 1;
+		// 3C1E
+		if (V[0xC] == 0x1E)
+		{
+			goto L34C;
+		}
+		goto L34A;
+
+	L34A:
+		if (budget - executed < 1) { PC = 0x34A; return executed; }
+		executed += 1;
+		// 7C01
+		V[0xC] += 0x01;
+		goto L34C;
+
+	L34C:
+		if (budget - executed < 1) { PC = 0x34C; return executed; }
+		executed += 1;
+		// 3C1E
+		if (V[0xC] == 0x1E)
+		{
+			PC = 0x350; return executed;
+		}
+		goto L34E;
+
+	L34E:
+		if (budget - executed < 1) { PC = 0x34E; return executed; }
+		executed += 1;
+		// 7C01
+		V[0xC] += 0x01;
+		PC = 0x350; return executed;
+
+	L352:
+		if (budget - executed < 1) { PC = 0x352; return executed; }
+		executed += 1;
+		// 4B0A
+		if (V[0xB] != 0x0A)
+		{
+			goto L356;
+		}
+		PC = 0x354; return executed;
+
+	L356:
+		if (budget - executed < 1) { PC = 0x356; return executed; }
+		executed += 1;
+		// 91C0
+		if (V[0x1] != V[0xC])
+		{
+			goto L35A;
+		}
+		PC = 0x358; return executed;
+
+	L35A:
+		if (budget - executed < 2) { PC = 0x35A; return executed; }
+		executed += 2;
+		// 7101
+		V[0x1] += 0x01;
+		// 1350
+		PC = 0x350; return executed;
+
+	L35E:
+		if (budget - executed < 2) { PC = 0x35E; return executed; }
+		executed += 2;
+		// 601B
+		V[0x0] = 0x1B;
+		// 6B00
+		V[0xB] = 0x00;
+		PC = 0x362; return executed;
+
+	L364:
+		if (budget - executed < 1) { PC = 0x364; return executed; }
+		executed += 1;
+		// 3F00
+		if (V[0xF] == 0x00)
+		{
+			PC = 0x368; return executed;
+		}
+		goto L366;
+
+	L366:
+		if (budget - executed < 1) { PC = 0x366; return executed; }
+		executed += 1;
+		// 7B01
+		V[0xB] += 0x01;
+		PC = 0x368; return executed;
+
+	L36A:
+		if (budget - executed < 2) { PC = 0x36A; return executed; }
+		executed += 2;
+		// 7001
+		V[0x0] += 0x01;
+		// 3025
+		if (V[0x0] == 0x25)
+		{
+			PC = 0x370; return executed;
+		}
+		goto L36E;
+
+	L36E:
+		if (budget - executed < 1) { PC = 0x36E; return executed; }
+		executed += 1;
+		// 1362
+		PC = 0x362; return executed;
+
+	L372:
+		if (budget - executed < 1) { PC = 0x372; return executed; }
+		executed += 1;
+		// 601B
+		V[0x0] = 0x1B;
+		PC = 0x374; return executed;
+
+	L376:
+		if (budget - executed < 2) { PC = 0x376; return executed; }
+		executed += 2;
+		// 7001
+		V[0x0] += 0x01;
+		// 3025
+		if (V[0x0] == 0x25)
+		{
+			goto L37C;
+		}
+		goto L37A;
+
+	L37A:
+		if (budget - executed < 1) { PC = 0x37A; return executed; }
+		executed += 1;
+		// 1374
+		PC = 0x374; return executed;
+
+	L37C:
+		if (budget - executed < 3) { PC = 0x37C; return executed; }
+		executed += 3;
+		// 8E10
+		V[0xE] = V[0x1];
+		// 8DE0
+		V[0xD] = V[0xE];
+		// 7EFF
+		V[0xE] += 0xFF;
+		goto L382;
+
+	L382:
+		if (budget - executed < 2) { PC = 0x382; return executed; }
+		executed += 2;
+		// 601B
+		V[0x0] = 0x1B;
+		// 6B00
+		V[0xB] = 0x00;
+		PC = 0x386; return executed;
+
+	L388:
+		if (budget - executed < 1) { PC = 0x388; return executed; }
+		executed += 1;
+		// 3F00
+		if (V[0xF] == 0x00)
+		{
+			PC = 0x38C; return executed;
+		}
+		goto L38A;
+
+	L38A:
+		if (budget - executed < 1) { PC = 0x38A; return executed; }
+		executed += 1;
+		// 1390
+		PC = 0x390; return executed;
+
+	L38E:
+		if (budget - executed < 1) { PC = 0x38E; return executed; }
+		executed += 1;
+		// 1394
+		goto L394;
+
+	L392:
+		if (budget - executed < 1) { PC = 0x392; return executed; }
+		executed += 1;
+		// 7B01
+		V[0xB] += 0x01;
+		goto L394;
+
+	L394:
+		if (budget - executed < 2) { PC = 0x394; return executed; }
+		executed += 2;
+		// 7001
+		V[0x0] += 0x01;
+		// 3025
+		if (V[0x0] == 0x25)
+		{
+			goto L39A;
+		}
+		goto L398;
+
+	L398:
+		if (budget - executed < 1) { PC = 0x398; return executed; }
+		executed += 1;
+		// 1386
+		PC = 0x386; return executed;
+
+	L39A:
+		if (budget - executed < 1) { PC = 0x39A; return executed; }
+		executed += 1;
+		// 4B00
+		if (V[0xB] != 0x00)
+		{
+			goto L39E;
+		}
+		goto L39C;
+
+	L39C:
+		if (budget - executed < 1) { PC = 0x39C; return executed; }
+		executed += 1;
+		// 13A6
+		PC = 0x3A6; return executed;
+
+	L39E:
+		if (budget - executed < 3) { PC = 0x39E; return executed; }
+		executed += 3;
+		// 7DFF
+		V[0xD] += 0xFF;
+		// 7EFF
+		V[0xE] += 0xFF;
+		// 3D01
+		if (V[0xD] == 0x01)
+		{
+			PC = 0x3A6; return executed;
+		}
+		goto L3A4;
+
+	L3A4:
+		if (budget - executed < 1) { PC = 0x3A4; return executed; }
+		executed += 1;
+		// 1382
+		goto L382;
+
+	L3A8:
+		if (budget - executed < 1) { PC = 0x3A8; return executed; }
+		executed += 1;
+		// 3F01
+		if (V[0xF] == 0x01)
+		{
+			goto L3AC;
+		}
+		PC = 0x3AA; return executed;
+
+	L3AC:
+		if (budget - executed < 1) { PC = 0x3AC; return executed; }
+		executed += 1;
+		// 7A01
+		V[0xA] += 0x01;
+		PC = 0x3AE; return executed;
+
+	L3B0:
+		if (budget - executed < 4) { PC = 0x3B0; return executed; }
+		executed += 4;
+		// 80A0
+		V[0x0] = V[0xA];
+		// 6D07
+		V[0xD] = 0x07;
+		// 80D2
+		V[0x0] &= V[0xD];
+		// 4004
+		if (V[0x0] != 0x04)
+		{
+			goto L3BA;
+		}
+		goto L3B8;
+
+	L3B8:
+		if (budget - executed < 1) { PC = 0x3B8; return executed; }
+		executed += 1;
+		// 75FE
+		V[0x5] += 0xFE;
+		goto L3BA;
+
+	L3BA:
+		if (budget - executed < 1) { PC = 0x3BA; return executed; }
+		executed += 1;
+		// 4502
+		if (V[0x5] != 0x02)
+		{
+			PC = 0x3BE; return executed;
+		}
+		goto L3BC;
+
+	L3BC:
+		if (budget - executed < 1) { PC = 0x3BC; return executed; }
+		executed += 1;
+		// 6504
+		V[0x5] = 0x04;
+		PC = 0x3BE; return executed;
+
+	L3C0:
+		if (budget - executed < 1) { PC = 0x3C0; return executed; }
+		executed += 1;
+		// A700
+		I = 0x700;
+		PC = 0x3C2; return executed;
+
+	L3C4:
+		if (budget - executed < 1) { PC = 0x3C4; return executed; }
+		executed += 1;
+		// A804
+		I = 0x804;
+		PC = 0x3C6; return executed;
+
+	L3CC:
+		if (budget - executed < 2) { PC = 0x3CC; return executed; }
+		executed += 2;
+		// 6D32
+		V[0xD] = 0x32;
+		// 6E00
+		V[0xE] = 0x00;
+		PC = 0x3D0; return executed;
+
+	L3D2:
+		if (budget - executed < 1) { PC = 0x3D2; return executed; }
+		executed += 1;
+		// 7D05
+		V[0xD] += 0x05;
+		PC = 0x3D4; return executed;
+
+	L3D8:
+		if (budget - executed < 1) { PC = 0x3D8; return executed; }
+		executed += 1;
+		// 7D05
+		V[0xD] += 0x05;
+		PC = 0x3DA; return executed;
+
+	L3DE:
+		if (budget - executed < 1) { PC = 0x3DE; return executed; }
+		executed += 1;
+		// A700
+		I = 0x700;
+		PC = 0x3E0; return executed;
+
+	L3E2:
+		if (budget - executed < 1) { PC = 0x3E2; return executed; }
+		executed += 1;
+		// A2B4
+		I = 0x2B4;
+		PC = 0x3E4; return executed;
+
+	L3E6:
+		if (budget - executed < 2) { PC = 0x3E6; return executed; }
+		executed += 2;
+		// 6A00
+		V[0xA] = 0x00;
+		// 6019
+		V[0x0] = 0x19;
+		PC = 0x3EA; return executed;
+	}
+}
+
+static const CompiledRom COMPILED_ROM =
+{
+	"tetris",
+	0x04EB2109DC29B1ABull,
+	494,
+	&Run,
+	CODE_RANGES,
+	35,
+};
+
+static const bool registered = RegisterCompiledRom(&COMPILED_ROM);
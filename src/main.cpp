@@ -2,31 +2,118 @@
 
 #include <iostream>
 #include <filesystem>
+#include <string>
+#include <cstdlib>
 #include "Chip8.h"
+#include "Emulator.h"
+
+/**
+ * @brief Prints how the application should be started.
+ * @param executable Path of the executable, as found in argv[0].
+ */
+static void PrintUsage(const char* executable)
+{
+	std::cout << "Usage: " << std::filesystem::path(executable).filename().string() << " [--mode=interpreter|cached|threaded|jit|compiled] [--ips=<opcodes per second>|unlimited] [--run-ahead=<frames>] [--no-resume] [--record=<movie path>|--host=<port>|--join=<host>:<port> [--latency=<ms>] [--loss=<percent>]] [--broadcast=<address>] [--spectate=<address>|ROM path]" << std::endl;
+	std::cout << "Optionally, you can also drag the ROM file onto the window." << std::endl;
+	std::cout << "A ROM resumes from the state it was last left in, saved next to it, unless started with --no-resume." << std::endl;
+	std::cout << "With --host or --join, two players play together, both having started the same ROM." << std::endl;
+	std::cout << "With --broadcast, every frame is streamed to whoever started with --spectate, which shows them instead of emulating." << std::endl;
+	std::cout << "Addresses are either unix:<path> or <host>:<port>, the host being optional for --broadcast." << std::endl;
+}
 
 int main(int argc, const char* argv[])
 {
-	Chip8* chip8 = nullptr;
-
-	if (argc < 2)
-		//chip8 = new Chip8("ROM/IBM Logo.ch8");
-		//chip8 = new Chip8("ROM/BC_test.ch8");
-		chip8 = new Chip8("ROM/test_opcode.ch8");
-		//chip8 = new Chip8("ROM/test_opcode_with_audio.ch8");
-		//chip8 = new Chip8("ROM/breakout.rom");
-		//chip8 = new Chip8("ROM/snake.ch8");
-		//chip8 = new Chip8("ROM/keypad.ch8");
-		//chip8 = new Chip8("ROM/pong2.ch8");
-		//chip8 = new Chip8();
-	else if (argc == 2)
-		chip8 = new Chip8(argv[1]);
-	else
+	std::string romPath = "ROM/test_opcode.ch8";
+	//std::string romPath = "ROM/IBM Logo.ch8";
+	//std::string romPath = "ROM/BC_test.ch8";
+	//std::string romPath = "ROM/test_opcode_with_audio.ch8";
+	//std::string romPath = "ROM/breakout.rom";
+	//std::string romPath = "ROM/snake.ch8";
+	//std::string romPath = "ROM/keypad.ch8";
+	//std::string romPath = "ROM/pong2.ch8";
+	//std::string romPath = "";
+	ExecutionMode executionMode = ExecutionMode::CachedInterpreter;
+	uint32_t instructionsPerSecond = Emulator::OPCODES_FREQUENCY;
+	std::string moviePath;
+	uint32_t runAheadFrames = 0;
+	bool resume = true;
+	std::string netplayHost;
+	uint16_t netplayPort = 0;
+	uint32_t latencyMS = 0;
+	uint32_t lossPercent = 0;
+	std::string broadcastAddress;
+	std::string spectateAddress;
+	bool hasRomPath = false;
+
+	for (int i = 1; i < argc; i++)
 	{
-		std::cout << "Usage: " << std::filesystem::path(argv[0]).filename().string() << " [ROM path]" << std::endl;
-		std::cout << "Optionally, you can also drag the ROM file onto the window." << std::endl;
+		const std::string argument = argv[i];
+
+		if (argument == "--mode=interpreter")
+			executionMode = ExecutionMode::Interpreter;
+		else if (argument == "--mode=cached")
+			executionMode = ExecutionMode::CachedInterpreter;
+		else if (argument == "--mode=threaded")
+			executionMode = ExecutionMode::Threaded;
+		else if (argument == "--mode=jit")
+			executionMode = ExecutionMode::Jit;
+		else if (argument == "--mode=compiled")
+			executionMode = ExecutionMode::Compiled;
+		else if (argument == "--ips=unlimited")
+			instructionsPerSecond = Emulator::UNLIMITED_INSTRUCTIONS_PER_SECOND;
+		else if (argument.rfind("--ips=", 0) == 0 && std::atoi(argument.c_str() + 6) > 0)
+			instructionsPerSecond = std::atoi(argument.c_str() + 6);
+		else if (argument.rfind("--run-ahead=", 0) == 0 && std::atoi(argument.c_str() + 12) >= 0)
+			runAheadFrames = std::atoi(argument.c_str() + 12);
+		else if (argument == "--no-resume")
+			resume = false;
+		else if (argument.rfind("--record=", 0) == 0 && argument.size() > 9)
+			moviePath = argument.substr(9);
+		else if (argument.rfind("--host=", 0) == 0 && std::atoi(argument.c_str() + 7) > 0)
+			netplayPort = (uint16_t)std::atoi(argument.c_str() + 7);
+		else if (argument.rfind("--join=", 0) == 0 && argument.rfind(':') > 7 && std::atoi(argument.c_str() + argument.rfind(':') + 1) > 0)
+		{
+			netplayHost = argument.substr(7, argument.rfind(':') - 7);
+			netplayPort = (uint16_t)std::atoi(argument.c_str() + argument.rfind(':') + 1);
+		}
+		else if (argument.rfind("--latency=", 0) == 0 && std::atoi(argument.c_str() + 10) >= 0)
+			latencyMS = std::atoi(argument.c_str() + 10);
+		else if (argument.rfind("--loss=", 0) == 0 && std::atoi(argument.c_str() + 7) >= 0)
+			lossPercent = std::atoi(argument.c_str() + 7);
+		else if (argument.rfind("--broadcast=", 0) == 0 && argument.size() > 12)
+			broadcastAddress = argument.substr(12);
+		else if (argument.rfind("--spectate=", 0) == 0 && argument.size() > 11)
+			spectateAddress = argument.substr(11);
+		else if (!hasRomPath && argument.rfind("--", 0) != 0)
+		{
+			romPath = argument;
+			hasRomPath = true;
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return -1;
+		}
+	}
+
+	// A Movie only records the local keys, which don't tell how a networked game went
+	if (!moviePath.empty() && netplayPort != 0)
+	{
+		PrintUsage(argv[0]);
 		return -1;
 	}
-	
+
+	Chip8* chip8 = romPath.empty() ? new Chip8() : new Chip8(romPath);
+	chip8->SetExecutionMode(executionMode);
+	chip8->SetInstructionsPerSecond(instructionsPerSecond);
+	chip8->SetMoviePath(moviePath);
+	chip8->SetRunAheadFrames(runAheadFrames);
+	chip8->SetResume(resume);
+	chip8->SetNetplay(netplayHost, netplayPort);
+	chip8->SetSimulatedLink(latencyMS, lossPercent);
+	chip8->SetBroadcastAddress(broadcastAddress);
+	chip8->SetSpectateAddress(spectateAddress);
+
 	// Init
 	if (!chip8->Init())
 		return -1;
@@ -37,8 +124,8 @@ int main(int argc, const char* argv[])
 		// ...
 	}
 
-	// Shutdown 
+	// Shutdown
 	chip8->Shutdown();
 
 	return 0;
-}
\ No newline at end of file
+}